@@ -12,6 +12,7 @@
 #include "Exceptions.h"
 #include "DataStructures.h"
 #include "PhaseEnvelope.h"
+#include "MemoryFootprint.h"
 #include "crossplatform_shared_ptr.h"
 
 #include <numeric>
@@ -25,6 +26,8 @@ public:
     std::vector<double> tau,   ///< The reciprocal reduced temperature (\f$\tau=T_r/T\f$)
                         delta, ///< The reduced density (\f$\delta=\rho/\rho_r\f$)
                         M1;    ///< The determinant of the scaled matrix for the second criticality condition
+    /// The bytes allocated by the curves of the spinodal
+    std::size_t heap_bytes() const { return CoolProp::heap_bytes(tau) + CoolProp::heap_bytes(delta) + CoolProp::heap_bytes(M1); };
 };
 
 /// This simple class holds the values for guesses for use in some solvers
@@ -49,6 +52,105 @@ public:
     }
 };
 
+class AbstractState;
+
+/// A list of outputs that is parsed once and then evaluated for many states
+/**
+ * The outputs are given as in PropsSI, e.g. "Hmass", "d(Hmass)/d(T)|P", "d(P)/d(T)|sigma" or
+ * "d(d(P)/d(T)|Dmolar)/d(T)|Dmolar", or directly as keys.  Parsing them once into a flat table leaves only
+ * the dispatch on each output to be done by \ref evaluate.  The plan also records which intermediate values
+ * of the backend are shared by the outputs, so that the backend can calculate each of them in one pass
+ * before the outputs are evaluated.
+ */
+class OutputPlan{
+public:
+    enum OutputType {OUTPUT_TYPE_UNSET = 0, OUTPUT_TYPE_TRIVIAL, OUTPUT_TYPE_NORMAL, OUTPUT_TYPE_FIRST_DERIVATIVE, OUTPUT_TYPE_FIRST_SATURATION_DERIVATIVE, OUTPUT_TYPE_SECOND_DERIVATIVE};
+    /// The intermediate values that can be shared by several outputs, as bit flags
+    enum Intermediates {INTERMEDIATE_NONE = 0,
+                        INTERMEDIATE_ALPHAR = 1, ///< The derivatives of the residual Helmholtz energy
+                        INTERMEDIATE_ALPHA0 = 2  ///< The derivatives of the ideal-gas Helmholtz energy
+                       };
+    /// One compiled output
+    struct Output{
+        OutputType type;
+        parameters Of1, Wrt1, Constant1, Wrt2, Constant2;
+        Output() : type(OUTPUT_TYPE_UNSET), Of1(INVALID_PARAMETER), Wrt1(INVALID_PARAMETER), Constant1(INVALID_PARAMETER),
+                   Wrt2(INVALID_PARAMETER), Constant2(INVALID_PARAMETER) {};
+    };
+
+    OutputPlan() : m_intermediates(INTERMEDIATE_NONE) {};
+    /// Compile outputs given as strings; throws if one of them is not valid
+    explicit OutputPlan(const std::vector<std::string> &outputs);
+    /// Compile outputs given as keys
+    explicit OutputPlan(const std::vector<parameters> &outputs);
+
+    /// The number of outputs
+    std::size_t size() const { return m_outputs.size(); };
+    /// The i-th compiled output
+    const Output & operator[](std::size_t i) const { return m_outputs[i]; };
+    /// The intermediate values used by the outputs, as a combination of \ref Intermediates
+    int intermediates() const { return m_intermediates; };
+
+    /// Evaluate the i-th output for the current state of AS
+    double evaluate(AbstractState &AS, std::size_t i) const;
+    /// Evaluate all the outputs for the current state of AS into the size() values; throws if one of them fails
+    void evaluate(AbstractState &AS, double *values) const;
+    /// Evaluate all the outputs for the current state of AS
+    std::vector<double> evaluate(AbstractState &AS) const {
+        std::vector<double> values(m_outputs.size());
+        if (!values.empty()){ evaluate(AS, &(values[0])); }
+        return values;
+    };
+private:
+    std::vector<Output> m_outputs;
+    int m_intermediates;
+    void add(const Output &output);
+};
+
+/// The derivatives of a set of state variables with respect to the two independent variables of one state
+/**
+ * For a single-phase state the independent variables are \f$X = T\f$ and \f$Y = \rho\f$ (molar), and for a two-phase
+ * state of the Helmholtz backend they are \f$X = p\f$ and \f$Y = Q\f$.  Every first partial derivative of one of the
+ * variables with respect to another one, with a third one held constant, follows from these with
+ *
+ * \f[ \left(\frac{\partial A}{\partial B}\right)_C = \frac{A_X C_Y - A_Y C_X}{B_X C_Y - B_Y C_X} \f]
+ *
+ * so all of them can be taken from one evaluation of the state, see AbstractState::state_derivatives.  The second
+ * partial derivatives also need the second derivatives with respect to X and Y, which are only available for
+ * single-phase states.
+ */
+class StateDerivatives{
+public:
+    std::vector<parameters> keys; ///< The state variables
+    std::vector<CoolPropDbl> dX, ///< The derivatives of the variables with respect to X at constant Y
+                             dY; ///< The derivatives of the variables with respect to Y at constant X
+    std::vector<CoolPropDbl> dX2, ///< The second derivatives of the variables with respect to X; empty if they were not calculated
+                             dXdY, ///< The second derivatives of the variables with respect to X and Y; empty if they were not calculated
+                             dY2; ///< The second derivatives of the variables with respect to Y; empty if they were not calculated
+
+    /// Return the index of a state variable in keys; throws if it is not one of them
+    std::size_t index(parameters key) const;
+    /// Return the first partial derivative \f$ (\partial Of/\partial Wrt)_{Constant} \f$
+    CoolPropDbl first_partial_deriv(parameters Of, parameters Wrt, parameters Constant) const;
+    /// Return the second partial derivative \f$ (\partial/\partial Wrt2 (\partial Of1/\partial Wrt1)_{Constant1})_{Constant2} \f$
+    CoolPropDbl second_partial_deriv(parameters Of1, parameters Wrt1, parameters Constant1, parameters Wrt2, parameters Constant2) const;
+    /// Return the matrix of \f$ (\partial keys_i/\partial keys_j)_{Constant} \f$; the column of Constant itself is filled with _HUGE
+    std::vector<std::vector<double> > first_partial_deriv_matrix(parameters Constant) const;
+
+    /// The first partial derivative from the derivatives of the three variables with respect to X and Y
+    static CoolPropDbl first_partial_deriv(CoolPropDbl dOf_dX, CoolPropDbl dOf_dY, CoolPropDbl dWrt_dX, CoolPropDbl dWrt_dY, CoolPropDbl dConstant_dX, CoolPropDbl dConstant_dY){
+        return (dOf_dX*dConstant_dY-dOf_dY*dConstant_dX)/(dWrt_dX*dConstant_dY-dWrt_dY*dConstant_dX);
+    };
+    /// The second partial derivative from the first and second derivatives of the variables with respect to X and Y
+    /**
+     * Each of the arrays holds the derivatives of one variable, in the order {d/dX, d/dY, d2/dX2, d2/dXdY, d2/dY2}; only the
+     * first derivatives of Wrt2 and Constant2 are used
+     */
+    static CoolPropDbl second_partial_deriv(const CoolPropDbl Of1[5], const CoolPropDbl Wrt1[5], const CoolPropDbl Constant1[5], const CoolPropDbl Wrt2[5], const CoolPropDbl Constant2[5]);
+private:
+    void get(std::size_t i, CoolPropDbl d[5]) const;
+};
+
 //! The mother of all state classes
 /*!
 This class provides the basic properties based on interrelations of the
@@ -90,6 +192,9 @@ protected:
     /// Two important points
     SimpleState _critical, _reducing;
 
+    /// The generation of the cached values; incrementing it invalidates all the instances of CachedElement of this class
+    std::size_t _cache_generation;
+
     /// Molar mass [mol/kg]
     CachedElement _molar_mass;
 
@@ -373,6 +478,15 @@ protected:
     virtual CoolPropDbl calc_second_two_phase_deriv(parameters Of, parameters Wrt, parameters Constant, parameters Wrt2, parameters Constant2){ throw NotImplementedError("calc_second_two_phase_deriv is not implemented for this backend"); };
     virtual CoolPropDbl calc_first_two_phase_deriv_splined(parameters Of, parameters Wrt, parameters Constant, CoolPropDbl x_end){ throw NotImplementedError("calc_first_two_phase_deriv_splined is not implemented for this backend"); };
 
+    /// Calculate the derivatives of the state variables keys with respect to the independent variables of the state, see StateDerivatives
+    virtual void calc_state_derivatives(const std::vector<parameters> &keys, bool second_derivatives, StateDerivatives &derivs);
+
+    /// Calculate at once the intermediate values shared by several outputs, a combination of OutputPlan::Intermediates
+    /**
+     * This is only an optimization, so backends that do not share intermediate values need not implement it
+     */
+    virtual void calc_output_intermediates(int intermediates){};
+
     virtual CoolPropDbl calc_saturated_liquid_keyed_output(parameters key){ throw NotImplementedError("calc_saturated_liquid_keyed_output is not implemented for this backend"); };
     virtual CoolPropDbl calc_saturated_vapor_keyed_output(parameters key){ throw NotImplementedError("calc_saturated_vapor_keyed_output is not implemented for this backend"); };
     virtual void calc_ideal_curve(const std::string &type, std::vector<double> &T, std::vector<double> &p){ throw NotImplementedError("calc_ideal_curve is not implemented for this backend"); };
@@ -402,9 +516,20 @@ protected:
 
     /// Change the equation of state for a given component to a specified EOS
     virtual void calc_change_EOS(const std::size_t i, const std::string &EOS_name){ throw NotImplementedError("calc_change_EOS is not implemented for this backend"); };
+
+    /// Calculate the memory used by this state; this counts the instance of AbstractState, and the backends add the data they hold
+    virtual MemoryFootprint calc_memory_footprint(void);
+private:
+    /// The cached elements are bound to the generation counter of this instance, so states are not copied
+    AbstractState(const AbstractState &);
+    AbstractState &operator=(const AbstractState &);
+    /// The instances of CachedElement of this class; N is set to their number
+    static CachedElement AbstractState::* const *cached_elements(std::size_t &N);
+    /// Bind all the instances of CachedElement of this class to _cache_generation
+    void bind_cached_elements();
 public:
 
-    AbstractState() :_fluid_type(FLUID_TYPE_UNDEFINED), _phase(iphase_unknown){ clear(); }
+    AbstractState() :_fluid_type(FLUID_TYPE_UNDEFINED), _phase(iphase_unknown){ _cache_generation = 0; bind_cached_elements(); clear(); }
     virtual ~AbstractState(){};
 
     /// A factory function to return a pointer to a new-allocated instance of one of the backends.
@@ -537,6 +662,10 @@ public:
     /// Some or all of the guesses will be used - this is backend dependent
     virtual void update_with_guesses(CoolProp::input_pairs input_pair, double Value1, double Value2, const GuessesStructure &guesses){ throw NotImplementedError("update_with_guesses is not implemented for this backend"); };
 
+    /// Enable or disable continuation mode, in which each update starts from the solution of the previous one
+    /// This is intended for states that are updated along smooth trajectories, for instance in transient simulations
+    virtual void set_continuation_mode(bool enabled){ throw NotImplementedError("set_continuation_mode is not implemented for this backend"); };
+
     /// A function that says whether the backend instance can be instantiated in the high-level interface
     /// In general this should be true, except for some other backends (especially the tabular backends)
     /// To disable use in high-level interface, implement this function and return false
@@ -626,6 +755,9 @@ public:
     /// Calculate the criticality contour values \f$\mathcal{L}_1^*\f$ and \f$\mathcal{M}_1^*\f$
     void criticality_contour_values(double &L1star, double &M1star){ return calc_criticality_contour_values(L1star, M1star); }
 
+    /// Get the memory used by this state, in bytes, see MemoryFootprint
+    MemoryFootprint memory_footprint(void){ return calc_memory_footprint(); };
+
 	/// Return the tangent plane distance for a given trial composition w
 	/// @param T Temperature (K)
 	/// @param p Pressure (Pa)
@@ -677,6 +809,8 @@ public:
     double keyed_output(parameters key);
     /// A trivial keyed output like molar mass that does not depend on the state
     double trivial_keyed_output(parameters key);
+    /// Calculate at once the intermediate values shared by several outputs, a combination of OutputPlan::Intermediates; see OutputPlan
+    void output_intermediates(int intermediates){ calc_output_intermediates(intermediates); };
     /// Get an output from the saturated liquid state by key
     double saturated_liquid_keyed_output(parameters key){ return calc_saturated_liquid_keyed_output(key); };
     /// Get an output from the saturated vapor state by key
@@ -841,6 +975,20 @@ public:
      */
     CoolPropDbl second_partial_deriv(parameters Of1, parameters Wrt1, parameters Constant1, parameters Wrt2, parameters Constant2){return calc_second_partial_deriv(Of1,Wrt1,Constant1,Wrt2,Constant2);};
 
+    /// The derivatives of several state variables from one evaluation of the state
+    /**
+     * All the first partial derivatives of the variables with respect to each other, and optionally the second ones, follow
+     * from the returned StateDerivatives with a few operations each, rather than one evaluation of the state per derivative.
+     * In the two-phase region of the Helmholtz backend they are consistent with \ref first_two_phase_deriv.
+     * @param keys The state variables, for instance iP, iHmass, iSmass, iUmass and iDmass
+     * @param second_derivatives True to also calculate what the second partial derivatives need (single-phase states only)
+     */
+    StateDerivatives state_derivatives(const std::vector<parameters> &keys, bool second_derivatives = false){
+        StateDerivatives derivs;
+        calc_state_derivatives(keys, second_derivatives, derivs);
+        return derivs;
+    };
+
     /** \brief The first partial derivative along the saturation curve
      *
      * Implementing the algorithms and ideas of:
@@ -6,6 +6,7 @@
 #include "rapidjson_include.h"
 #include "Eigen/Core"
 #include "PolyMath.h"
+#include "MemoryFootprint.h"
 
 namespace CoolProp{
 
@@ -43,6 +44,8 @@ public:
         this->N = n.size();
         s = n;
     };
+    /// The bytes allocated by the coefficients of the correlation
+    std::size_t heap_bytes() const { return CoolProp::heap_bytes(a) + CoolProp::heap_bytes(n) + CoolProp::heap_bytes(s) + CoolProp::heap_bytes(BibTeX); };
     /// Actually evaluate the surface tension equation
     CoolPropDbl evaluate(CoolPropDbl T)
     {
@@ -132,6 +135,11 @@ public:
     
     /// Get the maximum temperature in K
     double get_Tmax(void){return Tmax;};
+    
+    /// The bytes allocated by the coefficients of this ancillary function
+    std::size_t heap_bytes() const {
+        return (num_coeffs.size() + den_coeffs.size())*sizeof(double) + CoolProp::heap_bytes(n) + CoolProp::heap_bytes(t) + CoolProp::heap_bytes(s);
+    };
 };
 
 // ****************************************************************************
@@ -238,6 +246,18 @@ public:
     
     /// Return true if the ancillary is enabled (type is not the default value of MELTING_LINE_NOT_SET)
     bool enabled(){return type != MELTING_LINE_NOT_SET;};
+    
+    /// The bytes allocated by the segments of the melting line
+    std::size_t heap_bytes() const {
+        std::size_t bytes = CoolProp::heap_bytes(BibTeX) + CoolProp::heap_bytes(simon.parts) + CoolProp::heap_bytes(polynomial_in_Tr.parts) + CoolProp::heap_bytes(polynomial_in_Theta.parts);
+        for (std::size_t i = 0; i < polynomial_in_Tr.parts.size(); ++i){
+            bytes += CoolProp::heap_bytes(polynomial_in_Tr.parts[i].a) + CoolProp::heap_bytes(polynomial_in_Tr.parts[i].t);
+        }
+        for (std::size_t i = 0; i < polynomial_in_Theta.parts.size(); ++i){
+            bytes += CoolProp::heap_bytes(polynomial_in_Theta.parts[i].a) + CoolProp::heap_bytes(polynomial_in_Theta.parts[i].t);
+        }
+        return bytes;
+    };
 };
 
 } /* namespace CoolProp */
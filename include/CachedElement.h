@@ -32,19 +32,50 @@ double CoolPropStateClassSI::d3phir_dTau3(double tau, double delta){
 class CachedElement {
 
 private:
-    bool is_cached;
+    const std::size_t *generation; ///< The generation counter of the owner of this element
+    std::size_t cached_generation; ///< The generation the value was cached in; the value is only valid while it matches the counter
     CoolPropDbl value;
+
+    /// The counter of the elements that are not bound to an owner; it never changes
+    static const std::size_t *unbound_generation(){
+        static const std::size_t generation = 0;
+        return &generation;
+    };
+    /// A generation that the counters never reach
+    static std::size_t invalid_generation(){ return static_cast<std::size_t>(-1); };
 public:
     /// Default constructor
-    CachedElement() {
+    CachedElement() : generation(unbound_generation()) {
         this->clear();
     };
+    /// Copy constructor; the copy holds the same value but is not bound to the owner of the other element
+    CachedElement(const CachedElement &other) : generation(unbound_generation()), value(other.value) {
+        cached_generation = other.is_valid() ? *generation : invalid_generation();
+    };
+    /// Copy the value and whether it is cached, but keep the binding of this element
+    CachedElement &operator=(const CachedElement &other) {
+        value = other.value;
+        cached_generation = other.is_valid() ? *generation : invalid_generation();
+        return *this;
+    };
+
+    /// Bind this element to the generation counter of its owner
+    /**
+     * The owner invalidates all the elements bound to its counter at once by incrementing the counter, rather than
+     * calling clear() on each of them.  The counter must outlive the element, so an owner that is copied binds the
+     * elements of the copy to the counter of the copy.
+     */
+    void bind(const std::size_t *generation) {
+        bool valid = is_valid();
+        this->generation = generation;
+        cached_generation = valid ? *generation : invalid_generation();
+    };
 
     /// Function to carry out the caching
     void _do_cache(double value)
     {
         this->value = value;
-        this->is_cached = true;
+        this->cached_generation = *generation;
     }
 
     /// Assignment operator - sets the value and sets the flag
@@ -52,19 +83,22 @@ public:
         _do_cache(value);
     };
 
+    /// Return true if the value is cached
+    bool is_valid() const {return cached_generation == *generation;};
+
     /// Cast to boolean, for checking if cached
-    operator bool() {return is_cached;};
+    operator bool() {return is_valid();};
 
     /// Cast to double, for returning value
     operator double() {
-        if (is_cached) {return static_cast<double>(value); }
+        if (is_valid()) {return static_cast<double>(value); }
         else {
             throw std::exception();
         }
     }
 #ifndef COOLPROPDBL_MAPS_TO_DOUBLE
     operator CoolPropDbl() {
-        if (is_cached) {return value; }
+        if (is_valid()) {return value; }
         else {
             throw std::exception();
         }
@@ -72,7 +106,7 @@ public:
 #endif
     /// Clear the flag and the value
     void clear() {
-        is_cached = false;
+        cached_generation = invalid_generation();
         this->value = _HUGE;
     };
     CoolPropDbl &pt(){
@@ -35,6 +35,7 @@
     X(DONT_CHECK_PROPERTY_LIMITS, "DONT_CHECK_PROPERTY_LIMITS", false, "If true, when possible, CoolProp will skip checking whether values are inside the property limits") \
 	X(HENRYS_LAW_TO_GENERATE_VLE_GUESSES, "HENRYS_LAW_TO_GENERATE_VLE_GUESSES", false, "If true, when doing water-based mixture dewpoint calculations, use Henry's Law to generate guesses for liquid-phase composition") \
     X(PHASE_ENVELOPE_STARTING_PRESSURE_PA, "PHASE_ENVELOPE_STARTING_PRESSURE_PA", 100.0, "Starting pressure [Pa] for phase envelope construction") \
+    X(PHASE_ENVELOPE_EXTRAPOLATION_TOLERANCE, "PHASE_ENVELOPE_EXTRAPOLATION_TOLERANCE", 1e-3, "Tolerance on the error of the extrapolated guess that controls the step size when tracing the phase envelope; if negative, the step size is based on the number of Newton-Raphson steps") \
     X(R_U_CODATA, "R_U_CODATA", 8.3144598, "The value for the ideal gas constant in J/mol/K according to CODATA 2014.  This value is used to harmonize all the ideal gas constants. This is especially important in the critical region.") \
     X(VTPR_UNIFAC_PATH, "VTPR_UNIFAC_PATH", "", "The path to the directory containing the UNIFAC JSON files.  Should be slash terminated") \
     X(SPINODAL_MINIMUM_DELTA, "SPINODAL_MINIMUM_DELTA", 0.5, "The minimal delta to be used in tracing out the spinodal; make sure that the EOS has a spinodal at this value of delta=rho/rho_r") \
@@ -43,6 +44,9 @@
     X(OVERWRITE_BINARY_INTERACTION, "OVERWRITE_BINARY_INTERACTION", false, "If true, and a pair of binary interaction pairs to be added is already there, rather than not adding the binary interaction pair (and probably throwing an exception), overwrite it") \
     X(USE_GUESSES_IN_PROPSSI, "USE_GUESSES_IN_PROPSSI", false, "If true, calls to the vectorized versions of PropsSI use the previous state as guess value while looping over the input vectors, only makes sense when working with a single fluid and with points that are not too far from each other.") \
     X(ASSUME_CRITICAL_POINT_STABLE, "ASSUME_CRIT_POINT_STABLE", false, "If true, evaluation of the stability of critical point will be skipped and point will be assumed to be stable") \
+    X(CRITICAL_POINTS_CACHE_SIZE, "CRITICAL_POINTS_CACHE_SIZE", 32.0, "The number of compositions for which a mixture state keeps the critical points that it has calculated; if zero, the critical points are recalculated at every call") \
+    X(SATURATION_CACHE_SIZE, "SATURATION_CACHE_SIZE", 8.0, "The number of pressures and temperatures for which a pure fluid state keeps the saturated states found while determining the phase; if zero, the saturation solvers are called every time") \
+    X(HS_FLASH_GUESS_MAP, "HS_FLASH_GUESS_MAP", true, "If true, the H,S flash of pure fluids starts from a coarse map of the enthalpy-entropy plane of the fluid, which is built the first time it is needed; if false, or if that fails, the temperature is found by iterating on T,S flashes") \
     X(VTPR_ALWAYS_RELOAD_LIBRARY, "VTPR_ALWAYS_RELOAD_LIBRARY", false, "If true, the library will always be reloaded, no matter what is currently loaded") \
     X(FLOAT_PUNCTUATION, "FLOAT_PUNCTUATION", ".", "The first character of this string will be used as the separator between the number fraction.")
 
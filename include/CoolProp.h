@@ -19,6 +19,7 @@ You might want to start by looking at CoolProp.h
     #include <string>
     #include <vector>
     #include "DataStructures.h"
+    #include "MemoryFootprint.h"
 
     namespace CoolProp {
 
@@ -185,6 +186,10 @@ You might want to start by looking at CoolProp.h
     /// Handy for printing the actual phase string in debug, warning, and error messages.
     /// @param Phase The enumerated phase index to be looked up
     std::string phase_lookup_string(phases Phase);
+
+    /// Get the memory used by the libraries that are shared by all the states of the process, in bytes
+    /// \note The fluid library is loaded if it has not been loaded yet
+    LibraryMemoryFootprint get_library_memory_footprint(void);
     
     } /* namespace CoolProp */
 #endif
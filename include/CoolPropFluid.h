@@ -334,6 +334,8 @@ public:
                             sigma_eta(_HUGE),epsilon_over_k(_HUGE),
                             hardcoded_viscosity(VISCOSITY_NOT_HARDCODED),
                             hardcoded_conductivity(CONDUCTIVITY_NOT_HARDCODED){}
+    /// The bytes allocated by the coefficients of the transport models
+    std::size_t heap_bytes() const;
 };
 
 struct Ancillaries
@@ -341,6 +343,11 @@ struct Ancillaries
     SaturationAncillaryFunction pL, pV, rhoL, rhoV, hL, hLV, sL, sLV;
     MeltingLineVariables melting_line;
     SurfaceTensionCorrelation surface_tension;
+    /// The bytes allocated by the coefficients of the ancillary equations
+    std::size_t heap_bytes() const {
+        return pL.heap_bytes() + pV.heap_bytes() + rhoL.heap_bytes() + rhoV.heap_bytes() + hL.heap_bytes() + hLV.heap_bytes() + sL.heap_bytes() + sLV.heap_bytes()
+               + melting_line.heap_bytes() + surface_tension.heap_bytes();
+    };
 };
 
 /// The core class for an equation of state
@@ -380,6 +387,11 @@ public:
         assert(R_u < 9 && R_u > 8);
         assert(molar_mass > 0.001 && molar_mass < 1);
     };
+    /// The bytes allocated by the coefficients of the equation of state
+    std::size_t heap_bytes() const {
+        return alphar.heap_bytes() + alpha0.heap_bytes() + CoolProp::heap_bytes(BibTeX_EOS) + CoolProp::heap_bytes(BibTeX_CP0)
+               + CoolProp::heap_bytes(critical_region_splines.cL) + CoolProp::heap_bytes(critical_region_splines.cV);
+    };
     CoolPropDbl baser(const CoolPropDbl &tau, const CoolPropDbl &delta)
     {
         return alphar.base(tau, delta);
@@ -506,6 +518,11 @@ class CoolPropFluid {
 
         double gas_constant(){ return EOS().R_u; };
         double molar_mass(){ return EOS().molar_mass; };
+
+        /// The bytes allocated by the data of the fluid; the instance itself is not included
+        std::size_t heap_bytes() const;
+        /// The bytes of the cached derivatives of the equations of state, which are part of the instance
+        std::size_t cached_bytes() const { return EOSVector.size()*2*BaseHelmholtzContainer::cached_bytes(); };
 };
 
 
@@ -222,6 +222,26 @@
      */
     EXPORT_CODE double CONVENTION HAPropsSI(const char *Output, const char *Name1, double Prop1, const char *Name2, double Prop2, const char *Name3, double Prop3);
 
+    /** \brief DLL wrapper of the HAPropsSImulti function
+     * \sa \ref HumidAir::HAPropsSImulti
+     *
+     * @param Outputs '&' delimited list of outputs
+     * @param Name1 The name of the first input
+     * @param Prop1 The values of the first input
+     * @param Name2 The name of the second input
+     * @param Prop2 The values of the second input
+     * @param Name3 The name of the third input
+     * @param Prop3 The values of the third input
+     * @param length The number of points, the length of each of Prop1, Prop2 and Prop3
+     * @param out The outputs, row-major; out[i*Noutputs+j] is output j at point i.  Must have room for length*Noutputs values
+     * @param errcode The errorcode that is returned (0 = no error, !0 = error)
+     * @param message_buffer A buffer for the error code
+     * @param buffer_length The length of the buffer for the error code
+     *
+     * \note A point that fails yields a huge value; an error code is only returned if the call as a whole is invalid
+     */
+    EXPORT_CODE void CONVENTION HAPropsSImulti(const char *Outputs, const char *Name1, const double *Prop1, const char *Name2, const double *Prop2, const char *Name3, const double *Prop3, const long length, double *out, long *errcode, char *message_buffer, const long buffer_length);
+
     /** \brief Humid air saturation specific heat at 1 atmosphere, based on a correlation from EES.
      * \sa \ref HumidAir::cair_sat(double);
      *
@@ -538,6 +558,34 @@
      */
     EXPORT_CODE void CONVENTION AbstractState_all_critical_points(const long handle, const long length, double *T, double *p, double *rhomolar, long *stable, long *errcode, char *message_buffer, const long buffer_length);
 
+    /**
+     * @brief Get the memory used by the state, in bytes
+     * @param handle The integer handle for the state class stored in memory
+     * @param owned_model The memory of the state itself and of the model data that only this state holds
+     * @param shared_model The memory of the model data that this state shares with other states, like the reducing function
+     * @param cached_derivatives The memory of the cached properties and derivatives, and of the cached saturated states
+     * @param child_states The memory of the states held by this state (SatL, SatV, TPD_state, critical_state, transient_pure_state, etc.)
+     * @param phase_envelope The memory of the phase envelope
+     * @param spinodal The memory of the spinodal and of the cached critical points
+     * @param errcode The errorcode that is returned (0 = no error, !0 = error)
+     * @param message_buffer A buffer for the error code
+     * @param buffer_length The length of the buffer for the error code
+     * @return
+     */
+    EXPORT_CODE void CONVENTION AbstractState_get_memory_footprint(const long handle, double *owned_model, double *shared_model, double *cached_derivatives, double *child_states, double *phase_envelope, double *spinodal, long *errcode, char *message_buffer, const long buffer_length);
+
+    /**
+     * @brief Get the memory used by the libraries that are shared by all the states of the process, in bytes
+     * @param fluid_library The memory of the fluids of the Helmholtz backends
+     * @param tabular_library The memory of the tables of the tabular backends
+     * @param UNIFAC_library The memory of the UNIFAC parameter libraries of the VTPR backend
+     * @param errcode The errorcode that is returned (0 = no error, !0 = error)
+     * @param message_buffer A buffer for the error code
+     * @param buffer_length The length of the buffer for the error code
+     * @return
+     */
+    EXPORT_CODE void CONVENTION get_library_memory_footprint(double *fluid_library, double *tabular_library, double *UNIFAC_library, long *errcode, char *message_buffer, const long buffer_length);
+
     // *************************************************************************************
     // *************************************************************************************
     // *****************************  DEPRECATED *******************************************
@@ -21,7 +21,11 @@
     #endif  
     
     // see http://stackoverflow.com/questions/18298280/how-to-declare-a-variable-as-thread-local-portably
-    #ifndef thread_local
+    // The C++11 compilers that implement thread_local need no macro, and their thread_local variables can have constructors and destructors
+    #if !defined(thread_local) && ((defined(__cplusplus) && __cplusplus >= 201103L && !(defined(__ISAPPLE__) && (defined(__llvm__) || defined(__clang__)) && !__has_feature(cxx_thread_local))) || (defined(_MSC_VER) && _MSC_VER >= 1900))
+        #define COOLPROP_CXX11_THREAD_LOCAL
+    #endif
+    #if !defined(thread_local) && !defined(COOLPROP_CXX11_THREAD_LOCAL)
         #if __STDC_VERSION__ >= 201112 && !defined __STDC_NO_THREADS__
         # define thread_local _Thread_local
         #elif defined _WIN32 && ( \
@@ -31,6 +35,7 @@
               defined __BORLANDC__ )
             #define thread_local __declspec(thread) 
         #elif defined(__ISAPPLE__) && (defined(__llvm__) || defined(__clang__)) && !__has_feature(cxx_thread_local)
+            // No thread-local storage; the variables are shared by all the threads
             #define thread_local 
         /* note that ICC (linux) and Clang are covered by __GNUC__ */
         #elif defined __GNUC__ || \
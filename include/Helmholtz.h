@@ -7,6 +7,7 @@
 //#include "Eigen/Core"
 #include "time.h"
 #include "CachedElement.h"
+#include "MemoryFootprint.h"
 #include "Backends/Cubics/GeneralizedCubic.h"
 #include "crossplatform_shared_ptr.h"
 
@@ -422,6 +423,8 @@ public:
     };
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc);
+    /// The bytes allocated by the coefficients of this term
+    std::size_t heap_bytes() const;
     
     void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
     //void allEigen(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
@@ -469,6 +472,8 @@ public:
         }
     };
     void to_json(rapidjson::Value &el, rapidjson::Document &doc);
+    /// The bytes allocated by the coefficients of this term
+    std::size_t heap_bytes() const { return CoolProp::heap_bytes(s) + CoolProp::heap_bytes(elements); };
     void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
 };
 
@@ -488,6 +493,8 @@ public:
     };
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc);
+    /// The bytes allocated by this term; the cubic itself is shared by the copies of the term and is not included
+    std::size_t heap_bytes() const { return CoolProp::heap_bytes(z); };
     void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
 };
 
@@ -511,6 +518,8 @@ public:
         const CoolPropDbl acentric,
         const CoolPropDbl R
         );
+    /// The bytes allocated by the coefficients of this term
+    std::size_t heap_bytes() const { return phi0.heap_bytes() + phi1.heap_bytes() + phi2.heap_bytes(); };
     void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
 };
 
@@ -579,17 +588,44 @@ public:
 };
 
 class BaseHelmholtzContainer{
+private:
+    /// The generation of the cached values; incrementing it invalidates all the instances of CachedElement of this class
+    std::size_t _cache_generation;
+    enum {N_CACHED_ELEMENTS = 15};
+    /// Return the i-th instance of CachedElement of this class
+    static CachedElement BaseHelmholtzContainer::* cached_element(std::size_t i){
+        static CachedElement BaseHelmholtzContainer::* const elements[N_CACHED_ELEMENTS] = {
+            &BaseHelmholtzContainer::_base, &BaseHelmholtzContainer::_dDelta, &BaseHelmholtzContainer::_dTau,
+            &BaseHelmholtzContainer::_dDelta2, &BaseHelmholtzContainer::_dTau2, &BaseHelmholtzContainer::_dDelta_dTau,
+            &BaseHelmholtzContainer::_dDelta3, &BaseHelmholtzContainer::_dDelta2_dTau, &BaseHelmholtzContainer::_dDelta_dTau2,
+            &BaseHelmholtzContainer::_dTau3, &BaseHelmholtzContainer::_dDelta4, &BaseHelmholtzContainer::_dDelta3_dTau,
+            &BaseHelmholtzContainer::_dDelta2_dTau2, &BaseHelmholtzContainer::_dDelta_dTau3, &BaseHelmholtzContainer::_dTau4
+        };
+        return elements[i];
+    };
+    void bind_cached_elements(){
+        for (std::size_t i = 0; i < N_CACHED_ELEMENTS; ++i){ (this->*cached_element(i)).bind(&_cache_generation); }
+    };
 protected:
     CachedElement _base, _dDelta, _dTau, _dDelta2, _dTau2, _dDelta_dTau, _dDelta3, _dDelta2_dTau, _dDelta_dTau2, _dTau3;
     CachedElement _dDelta4, _dDelta3_dTau, _dDelta2_dTau2, _dDelta_dTau3, _dTau4;
 public:
+    BaseHelmholtzContainer() : _cache_generation(0) { bind_cached_elements(); };
+    /// The copy holds the same cached values, bound to the generation counter of the copy
+    BaseHelmholtzContainer(const BaseHelmholtzContainer &other) : _cache_generation(0) {
+        bind_cached_elements();
+        *this = other;
+    };
+    BaseHelmholtzContainer &operator=(const BaseHelmholtzContainer &other){
+        for (std::size_t i = 0; i < N_CACHED_ELEMENTS; ++i){ this->*cached_element(i) = other.*cached_element(i); }
+        return *this;
+    };
+    /// Invalidate all the cached values
     void clear(){
-        _base.clear();
-        _dDelta.clear(); _dTau.clear();
-        _dDelta2.clear(); _dTau2.clear(); _dDelta_dTau.clear();
-        _dDelta3.clear(); _dTau3.clear(); _dDelta2_dTau.clear(); _dDelta_dTau2.clear();
-        _dDelta4.clear(); _dDelta3_dTau.clear(); _dDelta2_dTau2.clear(); _dDelta_dTau3.clear(); _dTau4.clear();
+        ++_cache_generation;
     };
+    /// The bytes of the cached values of a container, which are part of the container itself
+    static std::size_t cached_bytes(){ return N_CACHED_ELEMENTS*sizeof(CachedElement); };
     
     virtual void empty_the_EOS() = 0;
     virtual HelmholtzDerivatives all(const CoolPropDbl tau, const CoolPropDbl delta, bool cache_values) = 0;
@@ -677,6 +713,8 @@ public:
         cubic = ResidualHelmholtzGeneralizedCubic();
         XiangDeiters = ResidualHelmholtzXiangDeiters();
     };
+    /// The bytes allocated by the coefficients of the terms
+    std::size_t heap_bytes() const { return NonAnalytic.heap_bytes() + GenExp.heap_bytes() + cubic.heap_bytes() + XiangDeiters.heap_bytes(); };
     
     HelmholtzDerivatives all(const CoolPropDbl tau, const CoolPropDbl delta, bool cache_values = false)
     {
@@ -777,6 +815,8 @@ public:
     }
 
     bool is_enabled() const {return enabled;};
+    /// The bytes allocated by this term
+    std::size_t heap_bytes() const { return CoolProp::heap_bytes(reference); };
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc){
         el.AddMember("type","IdealHelmholtzEnthalpyEntropyOffset",doc.GetAllocator());
@@ -832,6 +872,8 @@ public:
     :n(n), t(t), N(n.size()), enabled(true) {};
 
     bool is_enabled() const {return enabled;};
+    /// The bytes allocated by the coefficients of this term
+    std::size_t heap_bytes() const { return CoolProp::heap_bytes(n) + CoolProp::heap_bytes(t); };
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc)
     {
@@ -892,6 +934,7 @@ class IdealHelmholtzPlanckEinsteinGeneralized : public BaseHelmholtzTerm{
     
 private:
     std::vector<CoolPropDbl> n,theta,c,d; // Use these variables internally
+    std::vector<double> expthetatau; ///< The scratch vector of exp(theta[i]*tau) of all()
     std::size_t N;
     bool enabled;
 public:
@@ -911,6 +954,8 @@ public:
     }
 
     bool is_enabled() const {return enabled;};
+    /// The bytes allocated by the coefficients of this term
+    std::size_t heap_bytes() const { return CoolProp::heap_bytes(n) + CoolProp::heap_bytes(theta) + CoolProp::heap_bytes(c) + CoolProp::heap_bytes(d) + CoolProp::heap_bytes(expthetatau); };
   
     void to_json(rapidjson::Value &el, rapidjson::Document &doc)
     {
@@ -977,6 +1022,8 @@ public:
     }
 
     bool is_enabled() const {return enabled;};
+    /// The bytes allocated by the coefficients of this term
+    std::size_t heap_bytes() const { return CoolProp::heap_bytes(c) + CoolProp::heap_bytes(t); };
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc);
     void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
@@ -1137,6 +1184,10 @@ public:
             CP0Constant = IdealHelmholtzCP0Constant();
             CP0PolyT = IdealHelmholtzCP0PolyT();
         };
+        /// The bytes allocated by the coefficients of the terms
+        std::size_t heap_bytes() const {
+            return EnthalpyEntropyOffsetCore.heap_bytes() + EnthalpyEntropyOffset.heap_bytes() + Power.heap_bytes() + PlanckEinstein.heap_bytes() + CP0PolyT.heap_bytes();
+        };
         
         HelmholtzDerivatives all(const CoolPropDbl tau, const CoolPropDbl delta, bool cache_values = false)
         {
@@ -4,14 +4,61 @@
 #define HUMAIR_H
 
 #include "CoolPropTools.h"
+#include "crossplatform_shared_ptr.h"
+
+namespace CoolProp{
+    class AbstractState;
+    class HelmholtzEOSBackend;
+}
 
 namespace HumidAir
 {
+
+class ScopedEvaluators;
+struct HumidAirFits;
+
+/** \brief A humid air property evaluator that owns its own evaluators for water, air and ice
+ *
+ * A single instance must not be used from several threads at once, but separate instances can be used concurrently.
+ * \ref HAPropsSI uses one instance per calling thread.
+ */
+class HumidAirState
+{
+private:
+    friend class ScopedEvaluators;
+    shared_ptr<CoolProp::HelmholtzEOSBackend> Water, Air;
+    shared_ptr<CoolProp::AbstractState> WaterIF97;
+    shared_ptr<HumidAirFits> fits; ///< The precomputed fits used when \ref UsePrecomputedFits is on
+public:
+    HumidAirState();
+    /// Same as \ref HAPropsSI, but throws a ValueError on failure rather than returning _HUGE
+    double PropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3);
+    /// Same as \ref HAPropsSImulti, evaluated on this state alone; throws a ValueError if the names are invalid
+    std::vector<std::vector<double> > PropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3);
+};
+
 /* \brief Standard I/O function using base SI units exclusively
  * 
  */
 double HAPropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3);
 
+/** \brief Vectorized version of \ref HAPropsSI for arrays of state points
+ *
+ * The names are parsed once, and the iterative solutions for each point start from the solution of the previous point.
+ * Large arrays are split into contiguous blocks that are evaluated on separate threads.
+ *
+ * @param Outputs The outputs to be calculated at each point
+ * @param Input1Name The name of the first input
+ * @param Input1 The values of the first input, one per point
+ * @param Input2Name The name of the second input
+ * @param Input2 The values of the second input, one per point
+ * @param Input3Name The name of the third input
+ * @param Input3 The values of the third input, one per point
+ * @param Nthreads The maximum number of threads to use; 0 to use one per hardware thread
+ * @returns IO[i][j] is output j at point i; _HUGE for the points that fail, and an empty vector if the names are invalid
+ */
+std::vector<std::vector<double> > HAPropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3, std::size_t Nthreads = 0);
+
 /* \brief Standard I/O function using mixed kSI units
  * 
  * \warning DEPRECATED!! Use \ref HAPropsSI
@@ -30,6 +77,8 @@ double IceProps(const char* Name, double T, double p);
 void UseVirialCorrelations(int flag);
 void UseIsothermCompressCorrelation(int flag);
 void UseIdealGasEnthalpyCorrelations(int flag);
+/// Evaluate the virial coefficients, enhancement factor, saturation and ideal-gas properties from precomputed Chebyshev fits in temperature
+void UsePrecomputedFits(int flag);
 
 // --------------
 // Help functions
@@ -48,6 +48,8 @@ This fluid instance is populated using an entry from a JSON file
 */
 class IncompressibleFluid{
 
+    friend class IncompressibleFixedComposition;
+
 protected:
     bool strict;
 
@@ -122,6 +124,15 @@ protected:
     IncompressibleData mole2input;
 
 
+    /// Coefficients derived from the ones above, prepared by the setters
+    /** They hold the polynomials that the derivative and integral functions
+     *  would otherwise derive on every call. All of them are polynomials in
+     *  (T-Tbase) and (x-xbase), except for dsdT_int_coeffs; see prepare_coefficients.
+     */
+    Eigen::MatrixXd drhodT_coeffs;   ///< Partial derivative of density with respect to temperature
+    Eigen::MatrixXd dhdT_int_coeffs; ///< Integral of c in temperature
+    Eigen::MatrixXd dsdT_int_coeffs; ///< Integral of c/T in temperature
+
     Polynomial2DFrac poly;
 
     // Forward declaration of the some internal functions
@@ -156,12 +167,12 @@ public:
     void setxmin(double xmin) {this->xmin = xmin;}
     void setxid(composition_types xid) {this->xid = xid;}
     void setTminPsat(double TminPsat) {this->TminPsat = TminPsat;}
-    void setTbase(double Tbase) {this->Tbase = Tbase;}
+    void setTbase(double Tbase) {this->Tbase = Tbase; prepare_coefficients();}
     void setxbase(double xbase) {this->xbase = xbase;}
 
     /// Setters for the coefficients
-    void setDensity(IncompressibleData density){this->density = density;}
-    void setSpecificHeat(IncompressibleData specific_heat){this->specific_heat = specific_heat;}
+    void setDensity(IncompressibleData density){this->density = density; prepare_coefficients();}
+    void setSpecificHeat(IncompressibleData specific_heat){this->specific_heat = specific_heat; prepare_coefficients();}
     void setViscosity(IncompressibleData viscosity){this->viscosity = viscosity;}
     void setConductivity(IncompressibleData conductivity){this->conductivity = conductivity;}
     void setPsat(IncompressibleData p_sat){this->p_sat = p_sat;}
@@ -179,11 +190,14 @@ public:
 
 
 protected:
+    /// Derive the coefficients of the derivative and the integrals from the current density and specific heat coefficients
+    void prepare_coefficients();
+
     /// Base functions that handle the custom function types
-    double baseExponential(IncompressibleData data, double y, double ybase);
-    double baseLogexponential(IncompressibleData data, double y, double ybase);
-    double baseExponentialOffset(IncompressibleData data, double y);
-    double basePolyOffset(IncompressibleData data, double y, double z=0.0);
+    double baseExponential(const IncompressibleData &data, double y, double ybase);
+    double baseLogexponential(const IncompressibleData &data, double y, double ybase);
+    double baseExponentialOffset(const IncompressibleData &data, double y);
+    double basePolyOffset(const IncompressibleData &data, double y, double z=0.0);
 
 public:
 
@@ -330,5 +344,55 @@ public:
     };
 };
 
+/// The polynomial properties of an incompressible fluid at a fixed composition
+/** The composition dependence is evaluated once, which leaves polynomials in
+ *  temperature alone. The integrals of the specific heat, which are monotone in
+ *  temperature, are tabulated together with their slopes, so that temperature
+ *  can be found from enthalpy or entropy with a Hermite guess and a few Newton
+ *  steps instead of a bracketing solver.
+ *
+ *  Only fluids with polynomial density and specific heat can be reduced; for
+ *  all others, is_valid() returns false.
+ */
+class IncompressibleFixedComposition{
+
+protected:
+    bool valid, invertible;
+    double x, Tbase, Tmin, Tmax;
+    /// Coefficients in powers of (T-Tbase)
+    std::vector<double> rho_coeffs, drhodT_coeffs, d2rhodT2_coeffs, c_coeffs, h_int_coeffs;
+    /// The coefficient of log(T), followed by the coefficients of T, T^2, ...
+    std::vector<double> s_int_coeffs;
+    /// The tabulated integrals of the specific heat
+    std::vector<double> T_nodes, h_nodes, s_nodes, dTdh_nodes, dTds_nodes;
+
+    /// Hermite interpolation of T in the tables of an integral y and its slopes dTdy
+    double T_guess(const std::vector<double> &y_nodes, const std::vector<double> &dTdy_nodes, double y) const;
+
+public:
+    IncompressibleFixedComposition() : valid(false), invertible(false), x(_HUGE), Tbase(_HUGE), Tmin(_HUGE), Tmax(_HUGE) {};
+
+    /// Reduce the polynomials of the fluid to the composition x
+    void set(IncompressibleFluid &fluid, double x);
+    bool is_valid() const {return valid;}
+    /// The composition this object was reduced to
+    double get_x() const {return x;}
+
+    double rho(double T) const;
+    double drhodT(double T) const;
+    double c(double T) const;
+    /// Enthalpy without the reference values, as in IncompressibleBackend::raw_calc_hmass
+    double raw_hmass(double T, double p) const;
+    /// Entropy without the reference values, as in IncompressibleBackend::raw_calc_smass
+    double raw_smass(double T, double p) const;
+
+    /// Temperature from enthalpy without the reference values and pressure
+    /** Returns _HUGE if no solution was found between Tmin and Tmax */
+    double T_hmass(double hmass, double p) const;
+    /// Temperature from entropy without the reference values and pressure
+    /** Returns _HUGE if no solution was found between Tmin and Tmax */
+    double T_smass(double smass, double p) const;
+};
+
 } /* namespace CoolProp */
 #endif /* INCOMPRESSIBLEFLUID_H_ */
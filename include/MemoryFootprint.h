@@ -0,0 +1,62 @@
+#ifndef MEMORYFOOTPRINT_H
+#define MEMORYFOOTPRINT_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace CoolProp{
+
+/** \brief The memory used by a state, in bytes, see AbstractState::memory_footprint
+ *
+ * The sizes are estimates from the sizes of the objects and the capacities of their containers; the overhead of the
+ * heap allocator is not included
+ */
+struct MemoryFootprint{
+    std::size_t owned_model, ///< The state itself and the model data that only this state holds (copies of the fluid data, departure functions, etc.)
+                shared_model, ///< The model data that this state shares with other states (the reducing function, etc.), counted in full
+                cached_derivatives, ///< The cached properties and derivatives of the state and of its equations of state, and the cached saturated states
+                child_states, ///< The states held by this state (SatL, SatV, TPD_state, critical_state, transient_pure_state, transport reference states), without the model data they share with this state
+                phase_envelope, ///< The phase envelope
+                spinodal; ///< The spinodal and the cached critical points
+    MemoryFootprint() : owned_model(0), shared_model(0), cached_derivatives(0), child_states(0), phase_envelope(0), spinodal(0) {};
+    std::size_t total() const { return owned_model + shared_model + cached_derivatives + child_states + phase_envelope + spinodal; };
+};
+
+/// The memory used by the libraries that are shared by all the states of the process, in bytes, see get_library_memory_footprint
+struct LibraryMemoryFootprint{
+    std::size_t fluid_library, ///< The fluids of the Helmholtz backends (JSONFluidLibrary), with the JSON they were loaded from
+                tabular_library, ///< The tables of the tabular backends (TabularDataLibrary)
+                UNIFAC_library; ///< The UNIFAC parameter libraries of the VTPR backend
+    LibraryMemoryFootprint() : fluid_library(0), tabular_library(0), UNIFAC_library(0) {};
+    std::size_t total() const { return fluid_library + tabular_library + UNIFAC_library; };
+};
+
+/// The bytes allocated by a vector of elements that do not allocate memory themselves
+template<class T> std::size_t heap_bytes(const std::vector<T> &v){ return v.capacity()*sizeof(T); }
+/// The bytes allocated by a vector of vectors
+template<class T> std::size_t heap_bytes(const std::vector<std::vector<T> > &v){
+    std::size_t bytes = v.capacity()*sizeof(std::vector<T>);
+    for (std::size_t i = 0; i < v.size(); ++i){ bytes += heap_bytes(v[i]); }
+    return bytes;
+}
+/// The bytes allocated by a string; short strings are stored in the string itself
+inline std::size_t heap_bytes(const std::string &s){ return (s.capacity() > 15) ? s.capacity() + 1 : 0; }
+/// The bytes allocated by a vector of strings
+inline std::size_t heap_bytes(const std::vector<std::string> &v){
+    std::size_t bytes = v.capacity()*sizeof(std::string);
+    for (std::size_t i = 0; i < v.size(); ++i){ bytes += heap_bytes(v[i]); }
+    return bytes;
+}
+/// The bytes allocated by a map from strings to vectors, including the keys and the values
+template<class V> std::size_t heap_bytes(const std::map<std::string, V> &m){
+    std::size_t bytes = m.size()*(sizeof(std::pair<const std::string, V>) + 4*sizeof(void*));
+    for (typename std::map<std::string, V>::const_iterator it = m.begin(); it != m.end(); ++it){ bytes += heap_bytes(it->first) + heap_bytes(it->second); }
+    return bytes;
+}
+/// The bytes of the nodes of a map, with an overhead of four pointers per node; the memory allocated by the keys and values is not included
+template<class K, class V> std::size_t map_node_bytes(const std::map<K, V> &m){ return m.size()*(sizeof(std::pair<const K, V>) + 4*sizeof(void*)); }
+
+} /* namespace CoolProp */
+#endif
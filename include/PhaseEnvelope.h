@@ -2,11 +2,97 @@
 #define PHASE_ENVELOPE_H
 
 #include "Exceptions.h"
+#include "MemoryFootprint.h"
+#include <algorithm>
+#include <functional>
 
 #define PHASE_ENVELOPE_MATRICES X(K) X(lnK) X(x) X(y)
 #define PHASE_ENVELOPE_VECTORS X(T) X(p) X(lnT) X(lnp) X(rhomolar_liq) X(rhomolar_vap) X(lnrhomolar_liq) X(lnrhomolar_vap) X(hmolar_liq) X(hmolar_vap) X(smolar_liq) X(smolar_vap) X(Q) X(cpmolar_liq) X(cpmolar_vap) X(cvmolar_liq) X(cvmolar_vap) X(viscosity_liq) X(viscosity_vap) X(conductivity_liq) X(conductivity_vap) X(speed_sound_vap)
+/// The vectors of the phase envelope that are indexed for the fast lookups in find_intersections and is_inside
+#define PHASE_ENVELOPE_INDEXED_VECTORS X(T) X(p) X(hmolar_vap) X(smolar_vap) X(rhomolar_vap)
 
 namespace CoolProp{
+
+/** \brief A run of consecutive segments of one of the phase envelope curves along which the curve is monotonic
+ *
+ * The piece spans the points ifirst, ifirst+1, ..., ilast, so the segments
+ * (ifirst,ifirst+1) through (ilast-1,ilast) belong to this piece
+ */
+struct PhaseEnvelopeMonotonePiece
+{
+    std::size_t ifirst, ///< The index of the first point in the piece
+                ilast; ///< The index of the last point in the piece
+    bool increasing; ///< True if the values are non-decreasing along the piece, false if non-increasing
+    PhaseEnvelopeMonotonePiece(std::size_t ifirst, std::size_t ilast, bool increasing) : ifirst(ifirst), ilast(ilast), increasing(increasing) {};
+};
+
+/** \brief An index over one curve of the phase envelope, broken into its monotone pieces
+ *
+ * Since the phase envelope only has a handful of maxima and minima, the number of pieces is small,
+ * and each piece can be bisected, which makes a lookup O(log n) rather than O(n) in the number of points
+ */
+class PhaseEnvelopeMonotoneIndex
+{
+public:
+    std::vector<PhaseEnvelopeMonotonePiece> pieces;
+    
+    void clear(){ pieces.clear(); }
+    bool empty() const { return pieces.empty(); }
+    
+    /// Break the curve given by the values in v into monotone pieces
+    void build(const std::vector<double> &v){
+        pieces.clear();
+        if (v.size() < 2){ return; }
+        std::size_t ifirst = 0;
+        int direction = 0; // 0: not yet known, +1: increasing, -1: decreasing
+        for (std::size_t i = 0; i < v.size()-1; ++i){
+            int step = (v[i+1] > v[i]) ? 1 : ((v[i+1] < v[i]) ? -1 : 0);
+            if (step == 0){ continue; } // Flat segments are compatible with either direction
+            if (direction == 0){ direction = step; }
+            else if (step != direction){
+                // Turning point at i, the next piece starts where this one ends
+                pieces.push_back(PhaseEnvelopeMonotonePiece(ifirst, i, direction > 0));
+                ifirst = i; direction = step;
+            }
+        }
+        pieces.push_back(PhaseEnvelopeMonotonePiece(ifirst, v.size()-1, direction >= 0));
+    }
+    
+    /** \brief Find all the segments (i,i+1) of the curve for which value is within the closed range [v[i],v[i+1]]
+     *
+     * The segments are returned in increasing order of i, in exactly the same way as a linear scan over all the segments would
+     */
+    void find_segments(const std::vector<double> &v, double value, std::vector<std::pair<std::size_t, std::size_t> > &segments) const {
+        if (value != value){ return; } // NaN never matches
+        for (std::size_t k = 0; k < pieces.size(); ++k){
+            const PhaseEnvelopeMonotonePiece &piece = pieces[k];
+            // Neighboring pieces share the turning point, but not any segments
+            std::size_t istart = piece.ifirst;
+            if (istart >= piece.ilast){ continue; }
+            std::vector<double>::const_iterator b = v.begin() + istart, e = v.begin() + piece.ilast + 1;
+            std::size_t ilow, ihigh; // The first and last segment indices that match
+            if (piece.increasing){
+                if (value < *b || value > *(e-1)){ continue; }
+                // First point with v >= value, the segment ending at it is the first one that matches
+                std::size_t j = std::lower_bound(b, e, value) - v.begin();
+                ilow = (j > istart) ? j - 1 : istart;
+                // First point with v > value, the segment starting just before it is the last one that matches
+                std::size_t m = std::upper_bound(b, e, value) - v.begin();
+                ihigh = std::min(m - 1, piece.ilast - 1);
+            }
+            else{
+                if (value > *b || value < *(e-1)){ continue; }
+                std::size_t j = std::lower_bound(b, e, value, std::greater<double>()) - v.begin();
+                ilow = (j > istart) ? j - 1 : istart;
+                std::size_t m = std::upper_bound(b, e, value, std::greater<double>()) - v.begin();
+                ihigh = std::min(m - 1, piece.ilast - 1);
+            }
+            for (std::size_t i = ilow; i <= ihigh; ++i){
+                segments.push_back(std::pair<std::size_t, std::size_t>(i, i+1));
+            }
+        }
+    }
+};
     
 /** \brief A data structure to hold the data for a phase envelope
  * 
@@ -32,7 +118,40 @@ public:
     PHASE_ENVELOPE_MATRICES
     #undef X
     
+    // Use X macros to auto-generate the indices;
+    // each will look something like: PhaseEnvelopeMonotoneIndex T_index;
+    #define X(name) PhaseEnvelopeMonotoneIndex name##_index;
+    PHASE_ENVELOPE_INDEXED_VECTORS
+    #undef X
+    
     PhaseEnvelopeData() : TypeI(false), built(false), iTsat_max(-1), ipsat_max(-1), icrit(-1)  {}
+    
+    /// The bytes allocated by the curves and the indices of the phase envelope
+    std::size_t heap_bytes() const {
+        std::size_t bytes = 0;
+        #define X(name) bytes += CoolProp::heap_bytes(name);
+        PHASE_ENVELOPE_VECTORS
+        PHASE_ENVELOPE_MATRICES
+        #undef X
+        #define X(name) bytes += CoolProp::heap_bytes(name##_index.pieces);
+        PHASE_ENVELOPE_INDEXED_VECTORS
+        #undef X
+        return bytes;
+    }
+    
+    /// Build the indices of the monotone pieces of the curves; must be called again after the envelope has been modified
+    void build_index(){
+        /* Use X macros to auto-generate the building code; each will look something like: T_index.build(T); */
+        #define X(name) name##_index.build(name);
+        PHASE_ENVELOPE_INDEXED_VECTORS
+        #undef X
+    }
+    /// Clear the indices of the monotone pieces of the curves, the lookups fall back to linear scans until build_index() is called
+    void clear_index(){
+        #define X(name) name##_index.clear();
+        PHASE_ENVELOPE_INDEXED_VECTORS
+        #undef X
+    }
         
     void resize(std::size_t N)
     {
@@ -49,6 +168,7 @@ public:
         #define X(name) name.clear();
         PHASE_ENVELOPE_MATRICES
         #undef X
+        clear_index();
     }
     void insert_variables(const CoolPropDbl T, 
                           const CoolPropDbl p, 
@@ -64,6 +184,7 @@ public:
     {
         std::size_t N = K.size();
         if (N==0){throw CoolProp::ValueError("Cannot insert variables in phase envelope since resize() function has not been called");}
+        clear_index();
         this->p.insert(this->p.begin() + i, p);
         this->T.insert(this->T.begin() + i, T);
         this->lnT.insert(this->lnT.begin() + i, log(T));
@@ -103,6 +224,7 @@ public:
     {
         std::size_t N = K.size();
         if (N==0){throw CoolProp::ValueError("Cannot store variables in phase envelope since resize() function has not been called");}
+        clear_index();
         this->p.push_back(p);
         this->T.push_back(T);
         this->lnT.push_back(log(T));
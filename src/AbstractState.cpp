@@ -165,20 +165,54 @@ std::vector<std::string> AbstractState::fluid_names(void)
     return calc_fluid_names();
 }
 
+CachedElement AbstractState::* const *AbstractState::cached_elements(std::size_t &N) {
+    static CachedElement AbstractState::* const elements[] = {
+        &AbstractState::_molar_mass, &AbstractState::_gas_constant, &AbstractState::_tau, &AbstractState::_delta,
+        &AbstractState::_viscosity, &AbstractState::_conductivity, &AbstractState::_surface_tension,
+        &AbstractState::_hmolar, &AbstractState::_smolar, &AbstractState::_umolar, &AbstractState::_logp,
+        &AbstractState::_logrhomolar, &AbstractState::_cpmolar, &AbstractState::_cp0molar, &AbstractState::_cvmolar,
+        &AbstractState::_speed_sound, &AbstractState::_gibbsmolar, &AbstractState::_helmholtzmolar,
+        &AbstractState::_hmolar_excess, &AbstractState::_smolar_excess, &AbstractState::_gibbsmolar_excess,
+        &AbstractState::_umolar_excess, &AbstractState::_volumemolar_excess, &AbstractState::_helmholtzmolar_excess,
+        &AbstractState::_rhoLanc, &AbstractState::_rhoVanc, &AbstractState::_pLanc, &AbstractState::_pVanc,
+        &AbstractState::_TLanc, &AbstractState::_TVanc, &AbstractState::_fugacity_coefficient,
+        &AbstractState::_rho_spline, &AbstractState::_drho_spline_dh__constp, &AbstractState::_drho_spline_dp__consth,
+        &AbstractState::_alpha0, &AbstractState::_dalpha0_dTau, &AbstractState::_dalpha0_dDelta,
+        &AbstractState::_d2alpha0_dTau2, &AbstractState::_d2alpha0_dDelta_dTau, &AbstractState::_d2alpha0_dDelta2,
+        &AbstractState::_d3alpha0_dTau3, &AbstractState::_d3alpha0_dDelta_dTau2, &AbstractState::_d3alpha0_dDelta2_dTau,
+        &AbstractState::_d3alpha0_dDelta3, &AbstractState::_alphar, &AbstractState::_dalphar_dTau,
+        &AbstractState::_dalphar_dDelta, &AbstractState::_d2alphar_dTau2, &AbstractState::_d2alphar_dDelta_dTau,
+        &AbstractState::_d2alphar_dDelta2, &AbstractState::_d3alphar_dTau3, &AbstractState::_d3alphar_dDelta_dTau2,
+        &AbstractState::_d3alphar_dDelta2_dTau, &AbstractState::_d3alphar_dDelta3, &AbstractState::_d4alphar_dTau4,
+        &AbstractState::_d4alphar_dDelta_dTau3, &AbstractState::_d4alphar_dDelta2_dTau2,
+        &AbstractState::_d4alphar_dDelta3_dTau, &AbstractState::_d4alphar_dDelta4, &AbstractState::_dalphar_dDelta_lim,
+        &AbstractState::_d2alphar_dDelta2_lim, &AbstractState::_d2alphar_dDelta_dTau_lim,
+        &AbstractState::_d3alphar_dDelta2_dTau_lim, &AbstractState::_rhoLmolar, &AbstractState::_rhoVmolar
+    };
+    N = sizeof(elements)/sizeof(elements[0]);
+    return elements;
+}
+void AbstractState::bind_cached_elements() {
+    std::size_t N;
+    CachedElement AbstractState::* const *elements = cached_elements(N);
+    for (std::size_t i = 0; i < N; ++i){
+        (this->*elements[i]).bind(&_cache_generation);
+    }
+}
+MemoryFootprint AbstractState::calc_memory_footprint() {
+    MemoryFootprint footprint;
+    std::size_t N;
+    cached_elements(N);
+    footprint.cached_derivatives = N*sizeof(CachedElement);
+    footprint.owned_model = sizeof(AbstractState) - footprint.cached_derivatives;
+    return footprint;
+}
+
 bool AbstractState::clear() {
-    // Reset all instances of CachedElement and overwrite
+    // Invalidate all instances of CachedElement at once and overwrite
     // the internal double values with -_HUGE
+    ++this->_cache_generation;
     this->_R = _HUGE;
-    this->_gas_constant.clear();
-    this->_molar_mass.clear();
-
-    /// Ancillary curve values
-    this->_rhoLanc.clear();
-    this->_rhoVanc.clear();
-    this->_pVanc.clear();
-    this->_pLanc.clear();
-    this->_TVanc.clear();
-    this->_TLanc.clear();
 
     this->_critical.fill(_HUGE);
     this->_reducing.fill(_HUGE);
@@ -188,68 +222,6 @@ bool AbstractState::clear() {
     this->_T = -_HUGE;
     this->_p = -_HUGE;
     this->_Q = -_HUGE;
-    this->_tau.clear();
-    this->_delta.clear();
-
-    this->_umolar.clear();
-    this->_cpmolar.clear();
-    this->_cp0molar.clear();
-    this->_cvmolar.clear();
-    this->_speed_sound.clear();
-    this->_hmolar.clear();
-    this->_smolar.clear();
-    this->_gibbsmolar.clear();
-    this->_helmholtzmolar.clear();
-    this->_logp.clear();
-    this->_logrhomolar.clear();
-
-    this->_hmolar_excess.clear();
-    this->_smolar_excess.clear();
-    this->_gibbsmolar_excess.clear();
-    this->_volumemolar_excess.clear();
-    this->_umolar_excess.clear();
-    this->_helmholtzmolar_excess.clear();
-
-    /// Smoothing values
-	this->_rho_spline.clear();
-	this->_drho_spline_dh__constp.clear();
-	this->_drho_spline_dp__consth.clear();
-
-    /// Cached low-level elements for in-place calculation of other properties
-    this->_alpha0.clear();
-    this->_dalpha0_dTau.clear();
-    this->_dalpha0_dDelta.clear();
-    this->_d2alpha0_dTau2.clear();
-    this->_d2alpha0_dDelta_dTau.clear();
-    this->_d2alpha0_dDelta2.clear();
-    this->_d3alpha0_dTau3.clear();
-    this->_d3alpha0_dDelta_dTau2.clear();
-    this->_d3alpha0_dDelta2_dTau.clear();
-    this->_d3alpha0_dDelta3.clear();
-    this->_alphar.clear();
-    this->_dalphar_dTau.clear();
-    this->_dalphar_dDelta.clear();
-    this->_d2alphar_dTau2.clear();
-    this->_d2alphar_dDelta_dTau.clear();
-    this->_d2alphar_dDelta2.clear();
-    this->_d3alphar_dTau3.clear();
-    this->_d3alphar_dDelta_dTau2.clear();
-    this->_d3alphar_dDelta2_dTau.clear();
-    this->_d3alphar_dDelta3.clear();
-
-    this->_dalphar_dDelta_lim.clear();
-    this->_d2alphar_dDelta2_lim.clear();
-    this->_d2alphar_dDelta_dTau_lim.clear();
-    this->_d3alphar_dDelta2_dTau_lim.clear();
-
-    /// Two-Phase variables
-    this->_rhoLmolar.clear();
-    this->_rhoVmolar.clear();
-
-    /// Transport properties
-    this->_viscosity.clear();
-    this->_conductivity.clear();
-    this->_surface_tension.clear();
 
     return true;
 }
@@ -475,6 +447,103 @@ double AbstractState::keyed_output(parameters key)
     }
 }
 
+/// Return the intermediate values of the backend that the output key uses, a combination of OutputPlan::Intermediates
+static int output_intermediates_of(parameters key)
+{
+    switch (key)
+    {
+    case iHmolar: case iHmass: case iSmolar: case iSmass: case iUmolar: case iUmass:
+    case iGmolar: case iGmass: case iHelmholtzmolar: case iHelmholtzmass:
+    case iCvmolar: case iCvmass: case iCpmolar: case iCpmass: case ispeed_sound:
+    case iisentropic_expansion_coefficient: case ifundamental_derivative_of_gas_dynamics:
+        return OutputPlan::INTERMEDIATE_ALPHAR | OutputPlan::INTERMEDIATE_ALPHA0;
+    case iCp0molar: case iCp0mass: case ialpha0: case idalpha0_ddelta_consttau: case idalpha0_dtau_constdelta:
+        return OutputPlan::INTERMEDIATE_ALPHA0;
+    case iSmolar_residual: case ialphar: case idalphar_ddelta_consttau: case idalphar_dtau_constdelta:
+    case iisothermal_compressibility: case iisobaric_expansion_coefficient: case iPIP:
+        return OutputPlan::INTERMEDIATE_ALPHAR;
+    default:
+        return OutputPlan::INTERMEDIATE_NONE;
+    }
+}
+
+OutputPlan::OutputPlan(const std::vector<std::string> &outputs) : m_intermediates(INTERMEDIATE_NONE)
+{
+    for (std::vector<std::string>::const_iterator str = outputs.begin(); str != outputs.end(); ++str){
+        Output out;
+        CoolProp::parameters iOutput;
+        if (is_valid_parameter(*str, iOutput)){
+            out.Of1 = iOutput;
+            out.type = is_trivial_parameter(iOutput) ? OUTPUT_TYPE_TRIVIAL : OUTPUT_TYPE_NORMAL;
+        }
+        else if (is_valid_first_saturation_derivative(*str, out.Of1, out.Wrt1)){
+            out.type = OUTPUT_TYPE_FIRST_SATURATION_DERIVATIVE;
+        }
+        else if (is_valid_first_derivative(*str, out.Of1, out.Wrt1, out.Constant1)){
+            out.type = OUTPUT_TYPE_FIRST_DERIVATIVE;
+        }
+        else if (is_valid_second_derivative(*str, out.Of1, out.Wrt1, out.Constant1, out.Wrt2, out.Constant2)){
+            out.type = OUTPUT_TYPE_SECOND_DERIVATIVE;
+        }
+        else{
+            throw ValueError(format("Output string is invalid [%s]", str->c_str()));
+        }
+        add(out);
+    }
+}
+OutputPlan::OutputPlan(const std::vector<parameters> &outputs) : m_intermediates(INTERMEDIATE_NONE)
+{
+    for (std::vector<parameters>::const_iterator key = outputs.begin(); key != outputs.end(); ++key){
+        Output out;
+        out.Of1 = *key;
+        out.type = is_trivial_parameter(*key) ? OUTPUT_TYPE_TRIVIAL : OUTPUT_TYPE_NORMAL;
+        add(out);
+    }
+}
+void OutputPlan::add(const Output &out)
+{
+    switch (out.type){
+        case OUTPUT_TYPE_TRIVIAL:
+            break;
+        case OUTPUT_TYPE_NORMAL:
+            m_intermediates |= output_intermediates_of(out.Of1); break;
+        default:
+            // The derivatives are built from the derivatives of the residual Helmholtz energy, and
+            // from those of the ideal-gas part if one of the variables is a caloric property
+            m_intermediates |= INTERMEDIATE_ALPHAR | output_intermediates_of(out.Of1) | output_intermediates_of(out.Wrt1);
+            if (out.Constant1 != INVALID_PARAMETER){ m_intermediates |= output_intermediates_of(out.Constant1); }
+            if (out.Wrt2 != INVALID_PARAMETER){ m_intermediates |= output_intermediates_of(out.Wrt2) | output_intermediates_of(out.Constant2); }
+    }
+    m_outputs.push_back(out);
+}
+double OutputPlan::evaluate(AbstractState &AS, std::size_t i) const
+{
+    const Output &out = m_outputs[i];
+    switch (out.type){
+        case OUTPUT_TYPE_TRIVIAL:
+            return AS.trivial_keyed_output(out.Of1);
+        case OUTPUT_TYPE_NORMAL:
+            return AS.keyed_output(out.Of1);
+        case OUTPUT_TYPE_FIRST_DERIVATIVE:
+            return AS.first_partial_deriv(out.Of1, out.Wrt1, out.Constant1);
+        case OUTPUT_TYPE_FIRST_SATURATION_DERIVATIVE:
+            return AS.first_saturation_deriv(out.Of1, out.Wrt1);
+        case OUTPUT_TYPE_SECOND_DERIVATIVE:
+            return AS.second_partial_deriv(out.Of1, out.Wrt1, out.Constant1, out.Wrt2, out.Constant2);
+        default:
+            throw ValueError(format("Output %d of the plan is not set", static_cast<int>(i)));
+    }
+}
+void OutputPlan::evaluate(AbstractState &AS, double *values) const
+{
+    if (m_intermediates != INTERMEDIATE_NONE){
+        AS.output_intermediates(m_intermediates);
+    }
+    for (std::size_t i = 0; i < m_outputs.size(); ++i){
+        values[i] = evaluate(AS, i);
+    }
+}
+
 double AbstractState::tau(void){
     if (!_tau) _tau = calc_reciprocal_reduced_temperature();
     return _tau;
@@ -884,26 +953,55 @@ CoolPropDbl AbstractState::calc_first_partial_deriv(parameters Of, parameters Wr
     get_dT_drho(*this, Wrt, dWrt_dT, dWrt_drho);
     get_dT_drho(*this, Constant, dConstant_dT, dConstant_drho);
 
-    return (dOf_dT*dConstant_drho-dOf_drho*dConstant_dT)/(dWrt_dT*dConstant_drho-dWrt_drho*dConstant_dT);
+    return StateDerivatives::first_partial_deriv(dOf_dT, dOf_drho, dWrt_dT, dWrt_drho, dConstant_dT, dConstant_drho);
 }
 CoolPropDbl AbstractState::calc_second_partial_deriv(parameters Of1, parameters Wrt1, parameters Constant1, parameters Wrt2, parameters Constant2)
 {
-    CoolPropDbl dOf1_dT, dOf1_drho, dWrt1_dT, dWrt1_drho, dConstant1_dT, dConstant1_drho, d2Of1_dT2, d2Of1_drhodT,
-                d2Of1_drho2, d2Wrt1_dT2, d2Wrt1_drhodT, d2Wrt1_drho2, d2Constant1_dT2, d2Constant1_drhodT, d2Constant1_drho2,
-                dWrt2_dT, dWrt2_drho, dConstant2_dT, dConstant2_drho, N, D, dNdrho__T, dDdrho__T, dNdT__rho, dDdT__rho,
-                dderiv1_drho, dderiv1_dT, second;
+    // Derivatives in the order {d/dT, d/drho, d2/dT2, d2/drhodT, d2/drho2}
+    CoolPropDbl Of1d[5], Wrt1d[5], Constant1d[5], Wrt2d[5], Constant2d[5];
 
     // First and second partials needed for terms involved in first derivative
-    get_dT_drho(*this, Of1, dOf1_dT, dOf1_drho);
-    get_dT_drho(*this, Wrt1, dWrt1_dT, dWrt1_drho);
-    get_dT_drho(*this, Constant1, dConstant1_dT, dConstant1_drho);
-    get_dT_drho_second_derivatives(*this, Of1, d2Of1_dT2, d2Of1_drhodT, d2Of1_drho2);
-    get_dT_drho_second_derivatives(*this, Wrt1, d2Wrt1_dT2, d2Wrt1_drhodT, d2Wrt1_drho2);
-    get_dT_drho_second_derivatives(*this, Constant1, d2Constant1_dT2, d2Constant1_drhodT, d2Constant1_drho2);
+    get_dT_drho(*this, Of1, Of1d[0], Of1d[1]);
+    get_dT_drho(*this, Wrt1, Wrt1d[0], Wrt1d[1]);
+    get_dT_drho(*this, Constant1, Constant1d[0], Constant1d[1]);
+    get_dT_drho_second_derivatives(*this, Of1, Of1d[2], Of1d[3], Of1d[4]);
+    get_dT_drho_second_derivatives(*this, Wrt1, Wrt1d[2], Wrt1d[3], Wrt1d[4]);
+    get_dT_drho_second_derivatives(*this, Constant1, Constant1d[2], Constant1d[3], Constant1d[4]);
 
     // First derivatives of terms involved in the second derivative
-    get_dT_drho(*this, Wrt2, dWrt2_dT, dWrt2_drho);
-    get_dT_drho(*this, Constant2, dConstant2_dT, dConstant2_drho);
+    get_dT_drho(*this, Wrt2, Wrt2d[0], Wrt2d[1]);
+    get_dT_drho(*this, Constant2, Constant2d[0], Constant2d[1]);
+
+    return StateDerivatives::second_partial_deriv(Of1d, Wrt1d, Constant1d, Wrt2d, Constant2d);
+}
+void AbstractState::calc_state_derivatives(const std::vector<parameters> &keys, bool second_derivatives, StateDerivatives &derivs)
+{
+    // The intermediate values that get_dT_drho uses are calculated once for all the keys
+    output_intermediates(OutputPlan::INTERMEDIATE_ALPHAR | OutputPlan::INTERMEDIATE_ALPHA0);
+
+    std::size_t N = keys.size();
+    derivs.keys = keys;
+    derivs.dX.resize(N); derivs.dY.resize(N);
+    derivs.dX2.clear(); derivs.dXdY.clear(); derivs.dY2.clear();
+    for (std::size_t i = 0; i < N; ++i){
+        get_dT_drho(*this, keys[i], derivs.dX[i], derivs.dY[i]);
+    }
+    if (second_derivatives){
+        derivs.dX2.resize(N); derivs.dXdY.resize(N); derivs.dY2.resize(N);
+        for (std::size_t i = 0; i < N; ++i){
+            get_dT_drho_second_derivatives(*this, keys[i], derivs.dX2[i], derivs.dXdY[i], derivs.dY2[i]);
+        }
+    }
+}
+
+CoolPropDbl StateDerivatives::second_partial_deriv(const CoolPropDbl Of1[5], const CoolPropDbl Wrt1[5], const CoolPropDbl Constant1[5], const CoolPropDbl Wrt2[5], const CoolPropDbl Constant2[5])
+{
+    const CoolPropDbl &dOf1_dT = Of1[0], &dOf1_drho = Of1[1], &d2Of1_dT2 = Of1[2], &d2Of1_drhodT = Of1[3], &d2Of1_drho2 = Of1[4],
+                      &dWrt1_dT = Wrt1[0], &dWrt1_drho = Wrt1[1], &d2Wrt1_dT2 = Wrt1[2], &d2Wrt1_drhodT = Wrt1[3], &d2Wrt1_drho2 = Wrt1[4],
+                      &dConstant1_dT = Constant1[0], &dConstant1_drho = Constant1[1], &d2Constant1_dT2 = Constant1[2],
+                      &d2Constant1_drhodT = Constant1[3], &d2Constant1_drho2 = Constant1[4],
+                      &dWrt2_dT = Wrt2[0], &dWrt2_drho = Wrt2[1], &dConstant2_dT = Constant2[0], &dConstant2_drho = Constant2[1];
+    CoolPropDbl N, D, dNdrho__T, dDdrho__T, dNdT__rho, dDdT__rho, dderiv1_drho, dderiv1_dT, second;
 
     // Numerator and denominator of first partial derivative term
     N = dOf1_dT*dConstant1_drho - dOf1_drho*dConstant1_dT;
@@ -930,6 +1028,53 @@ CoolPropDbl AbstractState::calc_second_partial_deriv(parameters Of1, parameters
 
     return second;
 }
+std::size_t StateDerivatives::index(parameters key) const
+{
+    for (std::size_t i = 0; i < keys.size(); ++i){
+        if (keys[i] == key){ return i; }
+    }
+    throw ValueError(format("The parameter [%s] is not one of the keys of the state derivatives", get_parameter_information(key,"short").c_str()));
+}
+void StateDerivatives::get(std::size_t i, CoolPropDbl d[5]) const
+{
+    d[0] = dX[i]; d[1] = dY[i];
+    if (dX2.empty()){
+        d[2] = _HUGE; d[3] = _HUGE; d[4] = _HUGE;
+    }
+    else{
+        d[2] = dX2[i]; d[3] = dXdY[i]; d[4] = dY2[i];
+    }
+}
+CoolPropDbl StateDerivatives::first_partial_deriv(parameters Of, parameters Wrt, parameters Constant) const
+{
+    std::size_t iOf = index(Of), iWrt = index(Wrt), iConstant = index(Constant);
+    return first_partial_deriv(dX[iOf], dY[iOf], dX[iWrt], dY[iWrt], dX[iConstant], dY[iConstant]);
+}
+CoolPropDbl StateDerivatives::second_partial_deriv(parameters Of1, parameters Wrt1, parameters Constant1, parameters Wrt2, parameters Constant2) const
+{
+    if (dX2.empty()){
+        throw ValueError("The second derivatives of the state variables were not calculated");
+    }
+    CoolPropDbl Of1d[5], Wrt1d[5], Constant1d[5], Wrt2d[5], Constant2d[5];
+    get(index(Of1), Of1d);
+    get(index(Wrt1), Wrt1d);
+    get(index(Constant1), Constant1d);
+    get(index(Wrt2), Wrt2d);
+    get(index(Constant2), Constant2d);
+    return second_partial_deriv(Of1d, Wrt1d, Constant1d, Wrt2d, Constant2d);
+}
+std::vector<std::vector<double> > StateDerivatives::first_partial_deriv_matrix(parameters Constant) const
+{
+    std::size_t N = keys.size(), iConstant = index(Constant);
+    std::vector<std::vector<double> > J(N, std::vector<double>(N, _HUGE));
+    for (std::size_t i = 0; i < N; ++i){
+        for (std::size_t j = 0; j < N; ++j){
+            if (j == iConstant){ continue; }
+            J[i][j] = static_cast<double>(first_partial_deriv(dX[i], dY[i], dX[j], dY[j], dX[iConstant], dY[iConstant]));
+        }
+    }
+    return J;
+}
 //    // ----------------------------------------
 //    // Smoothing functions for density
 //    // ----------------------------------------
@@ -971,6 +1116,114 @@ TEST_CASE("Check AbstractState","[AbstractState]")
     }
 }
 
+TEST_CASE("Invalidation of cached values by the generation counter","[AbstractState],[CachedElement]")
+{
+    SECTION("bound elements")
+    {
+        std::size_t generation = 0;
+        CoolProp::CachedElement a, b;
+        a.bind(&generation);
+        a = 1.0;
+        CHECK(a.is_valid());
+        ++generation;
+        CHECK(!a.is_valid());
+        a = 2.0;
+        b = a; // b keeps its own binding
+        ++generation;
+        CHECK(!a.is_valid());
+        CHECK(b.is_valid());
+        CHECK(static_cast<double>(b) == 2.0);
+    }
+    SECTION("values after updates match those of a new state")
+    {
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", "Water"));
+        AS->update(CoolProp::PT_INPUTS, 101325, 300);
+        double h300 = AS->hmolar(), cp300 = AS->cpmolar();
+        AS->update(CoolProp::QT_INPUTS, 0.5, 400);
+        double hL = AS->saturated_liquid_keyed_output(CoolProp::iHmolar);
+        AS->update(CoolProp::PT_INPUTS, 101325, 350);
+        shared_ptr<CoolProp::AbstractState> AS2(CoolProp::AbstractState::factory("HEOS", "Water"));
+        AS2->update(CoolProp::PT_INPUTS, 101325, 350);
+        CHECK(AS->hmolar() == AS2->hmolar());
+        CHECK(AS->cpmolar() == AS2->cpmolar());
+        CHECK(AS->hmolar() != h300);
+        CHECK(AS->cpmolar() != cp300);
+        AS2->update(CoolProp::QT_INPUTS, 0.5, 410);
+        AS->update(CoolProp::QT_INPUTS, 0.5, 410);
+        CHECK(AS->saturated_liquid_keyed_output(CoolProp::iHmolar) == AS2->saturated_liquid_keyed_output(CoolProp::iHmolar));
+        CHECK(AS->saturated_liquid_keyed_output(CoolProp::iHmolar) != hL);
+    }
+}
+
+TEST_CASE("Compiled output plans give the same values as the individual outputs","[AbstractState],[OutputPlan]")
+{
+    std::vector<std::string> outputs = strsplit("Hmass&Smass&Cpmass&A&Cp0molar&molar_mass&d(Hmass)/d(T)|P&d(d(P)/d(T)|Dmolar)/d(T)|Dmolar", '&');
+    CoolProp::OutputPlan plan(outputs);
+    REQUIRE(plan.size() == outputs.size());
+    CHECK(plan[5].type == CoolProp::OutputPlan::OUTPUT_TYPE_TRIVIAL);
+    CHECK(plan[6].type == CoolProp::OutputPlan::OUTPUT_TYPE_FIRST_DERIVATIVE);
+    CHECK(plan[7].type == CoolProp::OutputPlan::OUTPUT_TYPE_SECOND_DERIVATIVE);
+    CHECK(plan.intermediates() == (CoolProp::OutputPlan::INTERMEDIATE_ALPHAR | CoolProp::OutputPlan::INTERMEDIATE_ALPHA0));
+    CHECK_THROWS(CoolProp::OutputPlan(strsplit("Hmass&NOT_AN_OUTPUT", '&')));
+
+    const char *fluids[] = {"Water", "Methane&Ethane"};
+    for (std::size_t k = 0; k < 2; ++k){
+        CAPTURE(fluids[k]);
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", fluids[k])), ref(CoolProp::AbstractState::factory("HEOS", fluids[k]));
+        if (k == 1){
+            std::vector<double> z(2, 0.5);
+            AS->set_mole_fractions(z); ref->set_mole_fractions(z);
+        }
+        AS->update(CoolProp::PT_INPUTS, 2e6, 400);
+        ref->update(CoolProp::PT_INPUTS, 2e6, 400);
+        std::vector<double> values = plan.evaluate(*AS);
+        CHECK(values[0] == ref->hmass());
+        CHECK(values[1] == ref->smass());
+        CHECK(values[2] == ref->cpmass());
+        CHECK(values[3] == ref->speed_sound());
+        CHECK(values[4] == ref->cp0molar());
+        CHECK(values[5] == ref->molar_mass());
+        CHECK(values[6] == ref->first_partial_deriv(CoolProp::iHmass, CoolProp::iT, CoolProp::iP));
+        CHECK(values[7] == ref->second_partial_deriv(CoolProp::iP, CoolProp::iT, CoolProp::iDmolar, CoolProp::iT, CoolProp::iDmolar));
+    }
+}
+
+TEST_CASE("State derivatives give the same values as the individual partial derivatives","[AbstractState],[StateDerivatives]")
+{
+    std::vector<CoolProp::parameters> keys;
+    keys.push_back(CoolProp::iT); keys.push_back(CoolProp::iP); keys.push_back(CoolProp::iDmass);
+    keys.push_back(CoolProp::iHmass); keys.push_back(CoolProp::iSmass); keys.push_back(CoolProp::iUmass);
+    const char *backends[] = {"HEOS", "SRK"};
+    for (std::size_t k = 0; k < 2; ++k){
+        CAPTURE(backends[k]);
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory(backends[k], "Propane"));
+        AS->update(CoolProp::PT_INPUTS, 1e6, 400);
+        CoolProp::StateDerivatives derivs = AS->state_derivatives(keys, true);
+        for (std::size_t i = 0; i < keys.size(); ++i){
+            for (std::size_t j = 0; j < keys.size(); ++j){
+                if (i == j || keys[j] == CoolProp::iP || keys[j] == CoolProp::iSmass){ continue; }
+                CHECK(derivs.first_partial_deriv(keys[i], keys[j], CoolProp::iP) == AS->first_partial_deriv(keys[i], keys[j], CoolProp::iP));
+                CHECK(derivs.second_partial_deriv(keys[i], keys[j], CoolProp::iP, keys[j], CoolProp::iSmass) == AS->second_partial_deriv(keys[i], keys[j], CoolProp::iP, keys[j], CoolProp::iSmass));
+            }
+        }
+        std::vector<std::vector<double> > J = derivs.first_partial_deriv_matrix(CoolProp::iSmass);
+        CHECK(J[3][1] == AS->first_partial_deriv(CoolProp::iHmass, CoolProp::iP, CoolProp::iSmass));
+        CHECK(J[0][0] == 1);
+        CHECK(!ValidNumber(J[0][4]));
+        CHECK_THROWS(derivs.first_partial_deriv(CoolProp::iHmolar, CoolProp::iT, CoolProp::iP));
+    }
+    SECTION("two-phase states are consistent with first_two_phase_deriv")
+    {
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", "Water"));
+        AS->update(CoolProp::PQ_INPUTS, 101325, 0.3);
+        CoolProp::StateDerivatives derivs = AS->state_derivatives(keys);
+        CHECK(std::abs(derivs.first_partial_deriv(CoolProp::iDmass, CoolProp::iHmass, CoolProp::iP)/AS->first_two_phase_deriv(CoolProp::iDmass, CoolProp::iHmass, CoolProp::iP) - 1) < 1e-12);
+        CHECK(std::abs(derivs.first_partial_deriv(CoolProp::iDmass, CoolProp::iP, CoolProp::iHmass)/AS->first_two_phase_deriv(CoolProp::iDmass, CoolProp::iP, CoolProp::iHmass) - 1) < 1e-12);
+        CHECK(derivs.first_partial_deriv(CoolProp::iT, CoolProp::iHmass, CoolProp::iP) == 0);
+        CHECK_THROWS(AS->state_derivatives(keys, true));
+    }
+}
+
 TEST_CASE("Check derivatives in first_partial_deriv","[derivs_in_first_partial_deriv]")
 {
     shared_ptr<CoolProp::AbstractState> Water(CoolProp::AbstractState::factory("HEOS", "Water"));
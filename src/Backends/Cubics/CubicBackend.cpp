@@ -157,7 +157,7 @@ CoolPropDbl CoolProp::AbstractCubicBackend::calc_pressure_nocache(CoolPropDbl T,
     AbstractCubic *cubic = get_cubic().get();
     double tau = cubic->get_Tr() / T;
     double delta = rhomolar / cubic->get_rhor();
-    return _rhomolar*gas_constant()*_T*(1+delta*cubic->alphar(tau, delta, this->get_mole_fractions_doubleref(), 0, 1));
+    return rhomolar*gas_constant()*T*(1+delta*cubic->alphar(tau, delta, this->get_mole_fractions_doubleref(), 0, 1));
 }
 void CoolProp::AbstractCubicBackend::update_DmolarT()
 {
@@ -174,58 +174,12 @@ void CoolProp::AbstractCubicBackend::update_DmolarT()
 };
 
 CoolPropDbl CoolProp::AbstractCubicBackend::calc_alphar_deriv_nocache(const int nTau, const int nDelta, const std::vector<CoolPropDbl> & mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta){
-    bool cache_values = true;
-    HelmholtzDerivatives derivs = residual_helmholtz->all(*this, mole_fractions, tau, delta, cache_values);
-    switch (nTau){
-        case 0:
-        {
-            switch (nDelta){
-                case 0: return derivs.alphar;
-                case 1: return derivs.dalphar_ddelta;
-                case 2: return derivs.d2alphar_ddelta2;
-                case 3: return derivs.d3alphar_ddelta3;
-                case 4: return derivs.d4alphar_ddelta4;
-                default: throw ValueError(format("nDelta (%d) is invalid",nDelta));
-            }
-            break;
-        }
-        case 1:
-        {
-            switch (nDelta){
-                case 0: return derivs.dalphar_dtau;
-                case 1: return derivs.d2alphar_ddelta_dtau;
-                case 2: return derivs.d3alphar_ddelta2_dtau;
-                case 3: return derivs.d4alphar_ddelta3_dtau;
-                default: throw ValueError(format("nDelta (%d) is invalid",nDelta));
-            }
-            break;
-        }
-        case 2:
-        {
-            switch (nDelta){
-                case 0: return derivs.d2alphar_dtau2;
-                case 1: return derivs.d3alphar_ddelta_dtau2;
-                case 2: return derivs.d4alphar_ddelta2_dtau2;
-                default: throw ValueError(format("nDelta (%d) is invalid",nDelta));
-            }
-        }
-        case 3:
-        {
-            switch (nDelta){
-                case 0: return derivs.d3alphar_dtau3;
-                case 1: return derivs.d4alphar_ddelta_dtau3;
-                default: throw ValueError(format("nDelta (%d) is invalid",nDelta));
-            }
-        }
-        case 4:
-        {
-            switch (nDelta){
-                case 0: return derivs.d4alphar_dtau4;
-                default: throw ValueError(format("nDelta (%d) is invalid",nDelta));
-            }
-        }
-        default: throw ValueError(format("nTau (%d) is invalid",nTau));
+    // Derivatives of up to fourth order are available; only the one requested is evaluated
+    if (nTau < 0 || nDelta < 0 || nTau + nDelta > 4){
+        throw ValueError(format("nTau (%d) and nDelta (%d) are invalid", nTau, nDelta));
     }
+    std::vector<double> z(mole_fractions.begin(), mole_fractions.end());
+    return get_cubic()->alphar(tau, delta, z, nTau, nDelta);
 }
 
 void CoolProp::AbstractCubicBackend::update(CoolProp::input_pairs input_pair, double value1, double value2){
@@ -245,15 +199,43 @@ void CoolProp::AbstractCubicBackend::update(CoolProp::input_pairs input_pair, do
             _p = value1; _Q = value2; saturation(input_pair); break;
         case DmolarT_INPUTS:
             _rhomolar = value1; _T = value2; update_DmolarT(); break;
+        case HmolarP_INPUTS:
+            _hmolar = value1; _p = value2;
+            if (is_pure_or_pseudopure && imposed_phase_index == iphase_not_imposed){ flash_pure(input_pair); }
+            else{ HelmholtzEOSMixtureBackend::update(input_pair, value1, value2); }
+            break;
+        case PSmolar_INPUTS:
+            _p = value1; _smolar = value2;
+            if (is_pure_or_pseudopure && imposed_phase_index == iphase_not_imposed){ flash_pure(input_pair); }
+            else{ HelmholtzEOSMixtureBackend::update(input_pair, value1, value2); }
+            break;
+        case HmolarSmolar_INPUTS:
+            _hmolar = value1; _smolar = value2;
+            if (is_pure_or_pseudopure && imposed_phase_index == iphase_not_imposed){ flash_pure(input_pair); }
+            else{ HelmholtzEOSMixtureBackend::update(input_pair, value1, value2); }
+            break;
         case SmolarT_INPUTS:
+            _smolar = value1; _T = value2;
+            if (is_pure_or_pseudopure && imposed_phase_index == iphase_not_imposed){ flash_pure(input_pair); }
+            else{ HelmholtzEOSMixtureBackend::update(input_pair, value1, value2); }
+            break;
         case DmolarP_INPUTS:
+            _rhomolar = value1; _p = value2;
+            if (is_pure_or_pseudopure && imposed_phase_index == iphase_not_imposed){ flash_pure(input_pair); }
+            else{ HelmholtzEOSMixtureBackend::update(input_pair, value1, value2); }
+            break;
         case DmolarHmolar_INPUTS:
+            _rhomolar = value1; _hmolar = value2;
+            if (is_pure_or_pseudopure && imposed_phase_index == iphase_not_imposed){ flash_pure(input_pair); }
+            else{ HelmholtzEOSMixtureBackend::update(input_pair, value1, value2); }
+            break;
         case DmolarSmolar_INPUTS:
+            _rhomolar = value1; _smolar = value2;
+            if (is_pure_or_pseudopure && imposed_phase_index == iphase_not_imposed){ flash_pure(input_pair); }
+            else{ HelmholtzEOSMixtureBackend::update(input_pair, value1, value2); }
+            break;
         case DmolarUmolar_INPUTS:
-        case HmolarP_INPUTS:
-        case PSmolar_INPUTS:
         case PUmolar_INPUTS:
-        case HmolarSmolar_INPUTS:
         case QSmolar_INPUTS:
         case HmolarQ_INPUTS:
         case DmolarQ_INPUTS:
@@ -336,6 +318,59 @@ public:
     };
 };
 
+/// Difference in Gibbs energy between the phases along an isobar.  Where the cubic only has one root, the sign of the
+/// phase that is stable is returned instead, so that the saturation temperature can be bracketed
+class SaturationTemperatureResidual : public SaturationResidual{
+public:
+    double rhomolar_critical;
+
+    SaturationTemperatureResidual(CoolProp::AbstractCubicBackend *ACB, double p, double rhomolar_critical) : SaturationResidual(ACB, CoolProp::PQ_INPUTS, p), rhomolar_critical(rhomolar_critical) {};
+
+    double call(double T){
+        double DELTAgibbs = SaturationResidual::call(T);
+        if (deltaL == deltaV){
+            // Liquid is stable below the saturation temperature
+            return (deltaL*ACB->get_cubic()->get_rhor() > rhomolar_critical) ? 1 : -1;
+        }
+        return DELTAgibbs;
+    };
+};
+
+/// Difference in Gibbs energy between the phases and its derivative with respect to the iteration variable, which is
+/// the temperature along an isobar or the logarithm of the pressure along an isotherm
+class SaturationNewtonResidual : public CoolProp::FuncWrapper1DWithDeriv{
+public:
+    SaturationResidual resid;
+    double dDELTAgibbs;
+
+    SaturationNewtonResidual(CoolProp::AbstractCubicBackend *ACB, CoolProp::input_pairs inputs, double imposed_variable) : resid(ACB, inputs, imposed_variable) {};
+
+    double call(double x){
+        double DELTAgibbs = resid.call((resid.inputs == CoolProp::QT_INPUTS) ? exp(x) : x);
+        double deltaL = resid.deltaL, deltaV = resid.deltaV;
+        if (!(deltaL > deltaV)){
+            throw CoolProp::ValueError("The cubic has only one root");
+        }
+        AbstractCubic *cubic = resid.ACB->get_cubic().get();
+        if (resid.inputs == CoolProp::PQ_INPUTS){
+            // d(g/RT)/dT = -h/(RT^2) along an isobar; the ideal-gas parts of the enthalpies of the phases are the same
+            const std::vector<double> &z = resid.ACB->get_mole_fractions_doubleref();
+            double tau = cubic->get_Tr()/x;
+            double hrL = tau*cubic->alphar(tau, deltaL, z, 1, 0) + deltaL*cubic->alphar(tau, deltaL, z, 0, 1);
+            double hrV = tau*cubic->alphar(tau, deltaV, z, 1, 0) + deltaV*cubic->alphar(tau, deltaV, z, 0, 1);
+            dDELTAgibbs = -(hrV - hrL)/x;
+        }
+        else{
+            // d(g/RT)/d(ln(p)) = pv/(RT) along an isotherm
+            dDELTAgibbs = exp(x)/(cubic->get_R_u()*resid.imposed_variable*cubic->get_rhor())*(1/deltaV - 1/deltaL);
+        }
+        return DELTAgibbs;
+    };
+    double deriv(double x){
+        return dDELTAgibbs;
+    };
+};
+
 std::vector<double> CoolProp::AbstractCubicBackend::spinodal_densities(){
     //// SPINODAL
     AbstractCubic *cubic = get_cubic().get();
@@ -364,20 +399,12 @@ std::vector<double> CoolProp::AbstractCubicBackend::spinodal_densities(){
 }
 
 void CoolProp::AbstractCubicBackend::saturation(CoolProp::input_pairs inputs){
-    AbstractCubic *cubic = get_cubic().get();
-    double Tc = cubic->get_Tc()[0], pc = cubic->get_pc()[0], acentric = cubic->get_acentric()[0];
     double rhoL=-1, rhoV=-1;
     if (inputs == PQ_INPUTS){
         if (is_pure_or_pseudopure){
-            // Estimate temperature from the acentric factor relationship
-            double theta = -log10(_p/pc)*(1/0.7-1)/(acentric+1);
-            double Ts_est = Tc/(theta+1);
-            SaturationResidual resid(this, inputs, _p);
-            static std::string errstr;
-            double Ts = CoolProp::Secant(resid, Ts_est, -0.1, 1e-10, 100);
-            _T = Ts;
-            rhoL = resid.deltaL*cubic->get_Tr();
-            rhoV = resid.deltaV*cubic->get_Tr();
+            CoolPropDbl rhoLsat, rhoVsat;
+            _T = saturation_T_pure(_p, rhoLsat, rhoVsat);
+            rhoL = rhoLsat; rhoV = rhoVsat;
             this->SatL->update(DmolarT_INPUTS, rhoL, _T);
             this->SatV->update(DmolarT_INPUTS, rhoV, _T);
         }
@@ -388,36 +415,9 @@ void CoolProp::AbstractCubicBackend::saturation(CoolProp::input_pairs inputs){
     }
     else if (inputs == QT_INPUTS){
         if (is_pure_or_pseudopure){
-            SaturationResidual resid(this, inputs, _T);
-            static std::string errstr;
-            // ** Spinodal densities is disabled for now because it is VERY slow :(
-            // std::vector<double> roots = spinodal_densities();
-            std::vector<double> roots;
-
-            // Estimate pressure from the acentric factor relationship
-            double neg_log10_pr = (acentric + 1) / (1 / 0.7 - 1)*(Tc / _T - 1);
-            double ps_est = pc*pow(10.0, -neg_log10_pr);
-
-            double ps;
-            if (roots.size() == 2){
-                double p0 = calc_pressure_nocache(_T, roots[0]);
-                double p1 = calc_pressure_nocache(_T, roots[1]);
-                if (p1 < p0){ std::swap(p0, p1); }
-                //ps = CoolProp::BoundedSecant(resid, p0, p1, pc, -0.01*ps_est, 1e-5, 100);
-                if (p0 > 0 && p1 < pc){
-                    ps = CoolProp::Brent(resid, p0*1.0001, p1*0.9999, DBL_EPSILON, 1e-10, 100);
-                }
-                else{
-                    ps = CoolProp::BoundedSecant(resid, ps_est, 1e-10, pc, -0.01*ps_est, 1e-5, 100);
-                }
-            }
-            else{
-                ps = CoolProp::BoundedSecant(resid, ps_est, 1e-10, pc, -0.01*ps_est, 1e-5, 100);
-            }
-            
-            _p = ps;
-            rhoL = resid.deltaL*cubic->get_Tr();
-            rhoV = resid.deltaV*cubic->get_Tr();
+            CoolPropDbl rhoLsat, rhoVsat;
+            _p = saturation_p_pure(_T, rhoLsat, rhoVsat);
+            rhoL = rhoLsat; rhoV = rhoVsat;
             this->SatL->update(DmolarT_INPUTS, rhoL, _T);
             this->SatV->update(DmolarT_INPUTS, rhoV, _T);
         }
@@ -429,73 +429,472 @@ void CoolProp::AbstractCubicBackend::saturation(CoolProp::input_pairs inputs){
     _rhomolar = 1/(_Q/rhoV+(1-_Q)/rhoL);
     _phase = iphase_twophase;
 }
-CoolPropDbl CoolProp::AbstractCubicBackend::solver_rho_Tp_global(CoolPropDbl T, CoolPropDbl p, CoolPropDbl rhomolar_max)
-{
-    _rhomolar = solver_rho_Tp(T, p, 40000);
-    return static_cast<double>(_rhomolar);
-    
+CoolPropDbl CoolProp::AbstractCubicBackend::saturation_p_pure(CoolPropDbl T, CoolPropDbl &rhoL, CoolPropDbl &rhoV){
+    AbstractCubic *cubic = get_cubic().get();
+    double Tc = cubic->get_Tc()[0], pc = cubic->get_pc()[0], acentric = cubic->get_acentric()[0];
+    // Estimate pressure from the acentric factor relationship
+    double neg_log10_pr = (acentric + 1) / (1 / 0.7 - 1)*(Tc / T - 1);
+    double ps_est = pc*pow(10.0, -neg_log10_pr);
+    // Newton's method in ln(p), starting from the Clausius-Clapeyron extrapolation of the last saturation state
+    double lnp0 = log(ps_est);
+    if (saturation_guess.T > 0){
+        double lnp_guess = log(saturation_guess.p) + saturation_guess.dlnp_dinvT*(1/T - 1/saturation_guess.T);
+        if (lnp_guess < log(pc)){ lnp0 = lnp_guess; }
+    }
+    try{
+        SaturationNewtonResidual newton(this, QT_INPUTS, T);
+        double ps = exp(Newton(newton, lnp0, 1e-12, 50));
+        if (ps < pc){
+            rhoL = newton.resid.deltaL*cubic->get_rhor();
+            rhoV = newton.resid.deltaV*cubic->get_rhor();
+            set_saturation_guess(T, ps, rhoL, rhoV);
+            return ps;
+        }
+    }
+    catch(const CoolPropBaseError &){
+        // Newton's method left the range where the cubic has three roots; fall back to the secant method
+    }
+    SaturationResidual resid(this, QT_INPUTS, T);
+    static std::string errstr;
+    // ** Spinodal densities is disabled for now because it is VERY slow :(
+    // std::vector<double> roots = spinodal_densities();
+    std::vector<double> roots;
+
+    double ps;
+    if (roots.size() == 2){
+        double p0 = calc_pressure_nocache(T, roots[0]);
+        double p1 = calc_pressure_nocache(T, roots[1]);
+        if (p1 < p0){ std::swap(p0, p1); }
+        //ps = CoolProp::BoundedSecant(resid, p0, p1, pc, -0.01*ps_est, 1e-5, 100);
+        if (p0 > 0 && p1 < pc){
+            ps = CoolProp::Brent(resid, p0*1.0001, p1*0.9999, DBL_EPSILON, 1e-10, 100);
+        }
+        else{
+            ps = CoolProp::BoundedSecant(resid, ps_est, 1e-10, pc, -0.01*ps_est, 1e-5, 100);
+        }
+    }
+    else{
+        ps = CoolProp::BoundedSecant(resid, ps_est, 1e-10, pc, -0.01*ps_est, 1e-5, 100);
+    }
+    // Densities of the phases at the converged pressure
+    rhoL = resid.deltaL*cubic->get_rhor();
+    rhoV = resid.deltaV*cubic->get_rhor();
+    set_saturation_guess(T, ps, rhoL, rhoV);
+    return ps;
 }
-CoolPropDbl CoolProp::AbstractCubicBackend::solver_rho_Tp(CoolPropDbl T, CoolPropDbl p, CoolPropDbl rho_guess){
-    int Nsoln = 0;
-    double rho0=0, rho1=0, rho2=0, rho = -1;
-    rho_Tp_cubic(T, p, Nsoln, rho0, rho1, rho2); // Densities are sorted in increasing order
-    if (Nsoln == 1){
-        rho = rho0;
-    }
-    else if (Nsoln == 3){
-        if (imposed_phase_index != iphase_not_imposed){
-            // Use imposed phase to select root
-            if (imposed_phase_index == iphase_gas || imposed_phase_index == iphase_supercritical_gas){
-                if (rho0 > 0){
-                    rho = rho0;
-                }
-                else if (rho1 > 0){
-                    rho = rho1;
-                }
-                else{
-                    throw CoolProp::ValueError(format("Unable to find gaseous density for T: %g K, p: %g Pa", T, p));
-                }
-            }
-            else if (imposed_phase_index == iphase_liquid || imposed_phase_index == iphase_supercritical_liquid){
-                rho = rho2;
+CoolPropDbl CoolProp::AbstractCubicBackend::saturation_T_pure(CoolPropDbl p, CoolPropDbl &rhoL, CoolPropDbl &rhoV){
+    AbstractCubic *cubic = get_cubic().get();
+    double Tc = cubic->get_Tc()[0], pc = cubic->get_pc()[0], acentric = cubic->get_acentric()[0];
+    if (!(p < pc)){
+        throw ValueError(format("Pressure [%g Pa] must be less than the critical pressure [%g Pa]", p, pc));
+    }
+    // Estimate temperature from the acentric factor relationship
+    double theta = -log10(p/pc)*(1/0.7-1)/(acentric+1);
+    double Ts_est = std::min(Tc/(theta+1), 0.9999*Tc);
+    // Newton's method in T, starting from the Clausius-Clapeyron extrapolation of the last saturation state
+    double T0 = Ts_est;
+    if (saturation_guess.p > 0){
+        double T_guess = 1/(1/saturation_guess.T + log(p/saturation_guess.p)/saturation_guess.dlnp_dinvT);
+        if (T_guess > 0 && T_guess < Tc){ T0 = T_guess; }
+    }
+    try{
+        SaturationNewtonResidual newton(this, PQ_INPUTS, p);
+        double Ts = Newton(newton, T0, 1e-12, 50);
+        if (Ts < Tc){
+            rhoL = newton.resid.deltaL*cubic->get_rhor();
+            rhoV = newton.resid.deltaV*cubic->get_rhor();
+            set_saturation_guess(Ts, p, rhoL, rhoV);
+            return Ts;
+        }
+    }
+    catch(const CoolPropBaseError &){
+        // Newton's method left the range where the cubic has three roots; fall back to bracketing
+    }
+    SaturationTemperatureResidual resid(this, p, rho_Tp_root(Tc, pc, iphase_not_imposed));
+    // Bracket the saturation temperature between the estimate and either the critical temperature
+    // (the vapor is stable) or a lower temperature at which the liquid is stable
+    T0 = Ts_est;
+    double T1 = Tc, f0 = resid.call(T0);
+    if (f0 < 0){
+        T1 = T0;
+        for (int i = 0; f0 < 0; ++i){
+            if (i > 50){
+                throw ValueError(format("Unable to bracket the saturation temperature for p: %g Pa", p));
             }
-            else{
-                throw ValueError("Specified phase is invalid");
+            T0 *= 0.9; f0 = resid.call(T0);
+        }
+    }
+    double Ts = CoolProp::Brent(resid, T0, T1, DBL_EPSILON, 1e-12, 100);
+    // Densities of the phases at the converged temperature
+    resid.call(Ts);
+    rhoL = resid.deltaL*cubic->get_rhor();
+    rhoV = resid.deltaV*cubic->get_rhor();
+    set_saturation_guess(Ts, p, rhoL, rhoV);
+    return Ts;
+}
+void CoolProp::AbstractCubicBackend::set_saturation_guess(CoolPropDbl T, CoolPropDbl p, CoolPropDbl rhoL, CoolPropDbl rhoV){
+    // Clausius-Clapeyron: d(ln(p))/d(1/T) = -(hV-hL)/(R*(zV-zL)); the ideal-gas parts of the enthalpies are the same
+    AbstractCubic *cubic = get_cubic().get();
+    const std::vector<double> &x = get_mole_fractions_doubleref();
+    double tau = cubic->get_Tr()/T, deltaL = rhoL/cubic->get_rhor(), deltaV = rhoV/cubic->get_rhor();
+    double hrL = tau*cubic->alphar(tau, deltaL, x, 1, 0) + deltaL*cubic->alphar(tau, deltaL, x, 0, 1);
+    double hrV = tau*cubic->alphar(tau, deltaV, x, 1, 0) + deltaV*cubic->alphar(tau, deltaV, x, 0, 1);
+    double DELTAz = p/(cubic->get_R_u()*T)*(1/rhoV - 1/rhoL);
+    saturation_guess.T = T;
+    saturation_guess.p = p;
+    saturation_guess.dlnp_dinvT = -T*(hrV - hrL)/DELTAz;
+}
+void CoolProp::AbstractCubicBackend::calc_hmolar_smolar_cubic(CoolPropDbl T, CoolPropDbl rhomolar, CoolPropDbl &hmolar, CoolPropDbl &smolar){
+    AbstractCubic *cubic = get_cubic().get();
+    const std::vector<double> &x = get_mole_fractions_doubleref();
+    double Tr = cubic->get_Tr(), rhor = cubic->get_rhor(), tau = Tr/T, delta = rhomolar/rhor;
+    double ar = cubic->alphar(tau, delta, x, 0, 0);
+    double dar_dTau = cubic->alphar(tau, delta, x, 1, 0);
+    double dar_dDelta = cubic->alphar(tau, delta, x, 0, 1);
+    HelmholtzDerivatives a0 = calc_alpha0_pure_cubic(tau, delta);
+    CoolPropDbl R_u = gas_constant();
+    hmolar = R_u*T*(1 + tau*(a0.dalphar_dtau+dar_dTau) + delta*dar_dDelta);
+    smolar = R_u*(tau*(a0.dalphar_dtau+dar_dTau) - a0.alphar - ar);
+}
+CoolProp::HelmholtzDerivatives CoolProp::AbstractCubicBackend::calc_alpha0_pure_cubic(CoolPropDbl tau, CoolPropDbl delta){
+    // As in calc_alpha0_deriv_nocache, the ideal-gas part uses tau^*=Tc/T and delta^*=rho/rhoc
+    AbstractCubic *cubic = get_cubic().get();
+    double ft = cubic->get_Tc()[0]/cubic->get_Tr(), fd = cubic->get_rhor()/components[0].rhomolarc;
+    HelmholtzDerivatives a0 = HelmholtzEOSMixtureBackend::get_components()[0].EOS().alpha0.all(ft*tau, fd*delta);
+    // Derivatives up to second order with respect to tau and delta
+    a0.dalphar_dtau *= ft; a0.d2alphar_dtau2 *= ft*ft;
+    a0.dalphar_ddelta *= fd; a0.d2alphar_ddelta2 *= fd*fd;
+    a0.d2alphar_ddelta_dtau *= ft*fd;
+    return a0;
+}
+
+void CoolProp::AbstractCubicBackend::calc_hmolar_smolar_cubic(CoolPropDbl T, CoolPropDbl rhomolar, CoolPropDbl &hmolar, CoolPropDbl &smolar, CoolPropDbl &cpmolar){
+    AbstractCubic *cubic = get_cubic().get();
+    const std::vector<double> &x = get_mole_fractions_doubleref();
+    double Tr = cubic->get_Tr(), rhor = cubic->get_rhor(), tau = Tr/T, delta = rhomolar/rhor;
+    double ar = cubic->alphar(tau, delta, x, 0, 0);
+    double dar_dTau = cubic->alphar(tau, delta, x, 1, 0);
+    double dar_dDelta = cubic->alphar(tau, delta, x, 0, 1);
+    double d2ar_dTau2 = cubic->alphar(tau, delta, x, 2, 0);
+    double d2ar_dDelta2 = cubic->alphar(tau, delta, x, 0, 2);
+    double d2ar_dDelta_dTau = cubic->alphar(tau, delta, x, 1, 1);
+    HelmholtzDerivatives a0 = calc_alpha0_pure_cubic(tau, delta);
+    CoolPropDbl R_u = gas_constant();
+    hmolar = R_u*T*(1 + tau*(a0.dalphar_dtau+dar_dTau) + delta*dar_dDelta);
+    smolar = R_u*(tau*(a0.dalphar_dtau+dar_dTau) - a0.alphar - ar);
+    double dp_dT = 1 + delta*dar_dDelta - delta*tau*d2ar_dDelta_dTau, dp_drho = 1 + 2*delta*dar_dDelta + delta*delta*d2ar_dDelta2;
+    cpmolar = R_u*(-tau*tau*(a0.d2alphar_dtau2 + d2ar_dTau2) + dp_dT*dp_dT/dp_drho);
+}
+
+class PureFlashTemperatureResidual : public CoolProp::FuncWrapper1DWithDeriv{
+public:
+    CoolProp::AbstractCubicBackend *ACB;
+    double p, value;
+    CoolProp::parameters key;
+    CoolProp::phases phase;
+
+    double dy_dT;
+
+    PureFlashTemperatureResidual(CoolProp::AbstractCubicBackend *ACB, double p, CoolProp::parameters key, double value, CoolProp::phases phase) : ACB(ACB), p(p), value(value), key(key), phase(phase) {};
+
+    double call(double T){
+        CoolPropDbl rhomolar = ACB->rho_Tp_root(T, p, phase), hmolar, smolar, cpmolar;
+        ACB->calc_hmolar_smolar_cubic(T, rhomolar, hmolar, smolar, cpmolar);
+        // Along an isobar, dh/dT = cp and ds/dT = cp/T
+        dy_dT = (key == CoolProp::iHmolar) ? cpmolar : cpmolar/T;
+        return ((key == CoolProp::iHmolar) ? hmolar : smolar) - value;
+    };
+    double deriv(double T){
+        return dy_dT;
+    };
+};
+
+void CoolProp::AbstractCubicBackend::flash_p_pure(CoolPropDbl p, parameters key, CoolPropDbl value, PureFlashState &state){
+    if (key != iHmolar && key != iSmolar){
+        throw ValueError(format("Invalid key [%s] for flash_p_pure", get_parameter_information(key, "short").c_str()));
+    }
+    AbstractCubic *cubic = get_cubic().get();
+    // Above the critical pressure, start well away from the critical point where the roots of the cubic coalesce
+    double T0 = 1.5*cubic->get_Tc()[0];
+    phases phase = iphase_not_imposed;
+    state.p = p; state.Q = -1; state.rhoL = -1; state.rhoV = -1;
+    CoolPropDbl rhoL = -1, rhoV = -1, Ts = -1;
+    if (p < cubic->get_pc()[0]){
+        Ts = saturation_T_pure(p, rhoL, rhoV);
+    }
+    // Very close to the critical point the phases cannot be resolved and the state is taken to be single-phase
+    if (rhoL > rhoV){
+        CoolPropDbl hL, sL, hV, sV;
+        calc_hmolar_smolar_cubic(Ts, rhoL, hL, sL);
+        calc_hmolar_smolar_cubic(Ts, rhoV, hV, sV);
+        CoolPropDbl yL = (key == iHmolar) ? hL : sL, yV = (key == iHmolar) ? hV : sV;
+        if (value >= yL && value <= yV){
+            // Two-phase, the quality follows from the lever rule
+            state.Q = (value - yL)/(yV - yL);
+            state.T = Ts; state.rhoL = rhoL; state.rhoV = rhoV;
+            state.rhomolar = 1/(state.Q/rhoV + (1 - state.Q)/rhoL);
+            state.hmolar = hL + state.Q*(hV - hL);
+            state.smolar = sL + state.Q*(sV - sL);
+            return;
+        }
+        // Single-phase, start from the saturation temperature along the liquid or vapor root
+        phase = (value < yL) ? iphase_liquid : iphase_gas;
+        T0 = Ts;
+    }
+    PureFlashTemperatureResidual resid(this, p, key, value, phase);
+    try{
+        // Newton's method; the solution must stay on the side of the saturation temperature of the selected root
+        double T = Newton(resid, T0, 1e-10, 50);
+        bool same_side = (phase == iphase_liquid) ? T <= Ts : (phase == iphase_gas) ? T >= Ts : true;
+        if (T > 0 && same_side){
+            state.T = T;
+            state.rhomolar = rho_Tp_root(state.T, p, phase);
+            calc_hmolar_smolar_cubic(state.T, state.rhomolar, state.hmolar, state.smolar);
+            return;
+        }
+    }
+    catch(const CoolPropBaseError &){
+        // Fall back to bracketing the temperature
+    }
+    // Enthalpy and entropy increase with temperature along an isobar; expand until the solution is bracketed
+    double f0 = resid.call(T0), factor = (f0 > 0) ? 0.8 : 1.25;
+    double T1 = T0*factor, f1 = resid.call(T1);
+    for (int i = 0; f0*f1 > 0; ++i){
+        if (i > 50){
+            throw ValueError(format("Unable to bracket the temperature for p: %g Pa and %s: %g", p, get_parameter_information(key, "short").c_str(), value));
+        }
+        T0 = T1; f0 = f1;
+        T1 *= factor; f1 = resid.call(T1);
+    }
+    state.T = Brent(resid, T0, T1, DBL_EPSILON, 1e-10, 100);
+    state.rhomolar = rho_Tp_root(state.T, p, phase);
+    calc_hmolar_smolar_cubic(state.T, state.rhomolar, state.hmolar, state.smolar);
+}
+
+class PureHSPressureResidual : public CoolProp::FuncWrapper1D{
+public:
+    CoolProp::AbstractCubicBackend *ACB;
+    double hmolar, smolar;
+
+    PureHSPressureResidual(CoolProp::AbstractCubicBackend *ACB, double hmolar, double smolar) : ACB(ACB), hmolar(hmolar), smolar(smolar) {};
+
+    double call(double lnp){
+        CoolProp::AbstractCubicBackend::PureFlashState state;
+        ACB->flash_p_pure(exp(lnp), CoolProp::iHmolar, hmolar, state);
+        return state.smolar - smolar;
+    };
+};
+
+void CoolProp::AbstractCubicBackend::flash_DT_pure(CoolPropDbl T, CoolPropDbl rhomolar, PureFlashState &state){
+    state.T = T; state.rhomolar = rhomolar; state.Q = -1; state.rhoL = -1; state.rhoV = -1;
+    if (T < get_cubic()->get_Tc()[0]){
+        CoolPropDbl rhoL, rhoV, ps = saturation_p_pure(T, rhoL, rhoV);
+        if (rhomolar > rhoV && rhomolar < rhoL){
+            // Two-phase, the quality follows from the lever rule on the specific volume
+            CoolPropDbl hL, sL, hV, sV;
+            calc_hmolar_smolar_cubic(T, rhoL, hL, sL);
+            calc_hmolar_smolar_cubic(T, rhoV, hV, sV);
+            state.Q = (1/rhomolar - 1/rhoL)/(1/rhoV - 1/rhoL);
+            state.p = ps; state.rhoL = rhoL; state.rhoV = rhoV;
+            state.hmolar = hL + state.Q*(hV - hL);
+            state.smolar = sL + state.Q*(sV - sL);
+            return;
+        }
+    }
+    state.p = calc_pressure_nocache(T, rhomolar);
+    calc_hmolar_smolar_cubic(T, rhomolar, state.hmolar, state.smolar);
+}
+
+class PureFlashDensityResidual : public CoolProp::FuncWrapper1D{
+public:
+    CoolProp::AbstractCubicBackend *ACB;
+    double rhomolar, value;
+    CoolProp::parameters key;
+    CoolProp::AbstractCubicBackend::PureFlashState state;
+    bool single_phase; ///< If true, the state is known to be single-phase and the dome is not checked
+
+    PureFlashDensityResidual(CoolProp::AbstractCubicBackend *ACB, double rhomolar, CoolProp::parameters key, double value) : ACB(ACB), rhomolar(rhomolar), value(value), key(key), single_phase(false) {};
+
+    double call(double T){
+        if (single_phase && key == CoolProp::iP){
+            return ACB->calc_pressure_nocache(T, rhomolar)/value - 1;
+        }
+        ACB->flash_DT_pure(T, rhomolar, state);
+        switch (key){
+            // For p, use the fractional error
+            case CoolProp::iP: return state.p/value - 1;
+            case CoolProp::iHmolar: return state.hmolar - value;
+            default: return state.smolar - value;
+        }
+    };
+};
+
+void CoolProp::AbstractCubicBackend::flash_D_pure(CoolPropDbl rhomolar, parameters key, CoolPropDbl value, PureFlashState &state){
+    if (key != iP && key != iHmolar && key != iSmolar){
+        throw ValueError(format("Invalid key [%s] for flash_D_pure", get_parameter_information(key, "short").c_str()));
+    }
+    PureFlashDensityResidual resid(this, rhomolar, key, value);
+    if (key == iP){
+        // The state is two-phase if the density lies between the saturated densities at the given pressure
+        if (value < get_cubic()->get_pc()[0]){
+            CoolPropDbl rhoL, rhoV, Ts = saturation_T_pure(value, rhoL, rhoV);
+            if (rhomolar > rhoV && rhomolar < rhoL){
+                CoolPropDbl hL, sL, hV, sV;
+                calc_hmolar_smolar_cubic(Ts, rhoL, hL, sL);
+                calc_hmolar_smolar_cubic(Ts, rhoV, hV, sV);
+                state.Q = (1/rhomolar - 1/rhoL)/(1/rhoV - 1/rhoL);
+                state.T = Ts; state.p = value; state.rhomolar = rhomolar; state.rhoL = rhoL; state.rhoV = rhoV;
+                state.hmolar = hL + state.Q*(hV - hL);
+                state.smolar = sL + state.Q*(sV - sL);
+                return;
             }
         }
-        else{
-            if (p < p_critical()){
-                add_transient_pure_state();
-		transient_pure_state->set_mole_fractions(this->mole_fractions);
-                transient_pure_state->update(PQ_INPUTS, p, 0);
-                if (T > transient_pure_state->T()){
-                    double rhoV = transient_pure_state->saturated_vapor_keyed_output(iDmolar);
-                    // Gas
-                    if (rho0 > 0 && rho0 < rhoV){
-                        rho = rho0;
-                    }
-                    else if( rho1 > 0 && rho1 < rhoV){
-                        rho = rho1;
-                    }
-                    else{
-                        throw CoolProp::ValueError(format("Unable to find gaseous density for T: %g K, p: %g Pa", T, p));
-                    }
-                }
-                else{
-                    // Liquid
-                    rho = rho2;
-                }
+        // Otherwise the pressure follows directly from the cubic
+        resid.single_phase = true;
+    }
+    // Pressure, enthalpy and entropy increase with temperature along an isochore, in the two-phase region as well;
+    // start at the critical temperature and expand until the solution is bracketed
+    double T0 = get_cubic()->get_Tc()[0], f0 = resid.call(T0), factor = (f0 > 0) ? 0.8 : 1.25;
+    double T1 = T0*factor, f1 = resid.call(T1);
+    for (int i = 0; f0*f1 > 0; ++i){
+        if (i > 50){
+            throw ValueError(format("Unable to bracket the temperature for rho: %g mol/m^3 and %s: %g", rhomolar, get_parameter_information(key, "short").c_str(), value));
+        }
+        T0 = T1; f0 = f1;
+        T1 *= factor; f1 = resid.call(T1);
+    }
+    double T = Brent(resid, T0, T1, DBL_EPSILON, 1e-10, 100);
+    if (resid.single_phase){
+        state.T = T; state.p = value; state.rhomolar = rhomolar; state.Q = -1; state.rhoL = -1; state.rhoV = -1;
+        calc_hmolar_smolar_cubic(T, rhomolar, state.hmolar, state.smolar);
+    }
+    else{
+        flash_DT_pure(T, rhomolar, state);
+    }
+}
+
+class PureSTDensityResidual : public CoolProp::FuncWrapper1D{
+public:
+    CoolProp::AbstractCubicBackend *ACB;
+    double T, smolar;
+
+    PureSTDensityResidual(CoolProp::AbstractCubicBackend *ACB, double T, double smolar) : ACB(ACB), T(T), smolar(smolar) {};
+
+    double call(double rhomolar){
+        CoolPropDbl hmolar, s;
+        ACB->calc_hmolar_smolar_cubic(T, rhomolar, hmolar, s);
+        return s - smolar;
+    };
+};
+
+void CoolProp::AbstractCubicBackend::flash_ST_pure(CoolPropDbl T, CoolPropDbl smolar, PureFlashState &state){
+    // Entropy decreases with density along an isotherm, from infinity at zero density to minus infinity at the covolume
+    double rho_max = (1 - 1e-12)/get_cubic()->bm_term(get_mole_fractions_doubleref()), rho_min = -1;
+    if (T < get_cubic()->get_Tc()[0]){
+        CoolPropDbl rhoL, rhoV, hL, sL, hV, sV, ps = saturation_p_pure(T, rhoL, rhoV);
+        calc_hmolar_smolar_cubic(T, rhoL, hL, sL);
+        calc_hmolar_smolar_cubic(T, rhoV, hV, sV);
+        if (smolar >= sL && smolar <= sV){
+            // Two-phase, the quality follows from the lever rule
+            state.Q = (smolar - sL)/(sV - sL);
+            state.T = T; state.p = ps; state.rhoL = rhoL; state.rhoV = rhoV;
+            state.rhomolar = 1/(state.Q/rhoV + (1 - state.Q)/rhoL);
+            state.hmolar = hL + state.Q*(hV - hL);
+            state.smolar = smolar;
+            return;
+        }
+        // Single-phase, the density lies on the liquid or the vapor side of the dome
+        if (smolar < sL){ rho_min = rhoL; }
+        else{ rho_max = rhoV; }
+    }
+    PureSTDensityResidual resid(this, T, smolar);
+    if (rho_min < 0){
+        // Decrease the density until the solution is bracketed
+        rho_min = 0.1*rho_max;
+        for (int i = 0; resid.call(rho_min) < 0; ++i){
+            if (i > 50){
+                throw ValueError(format("Unable to bracket the density for T: %g K and s: %g J/mol/K", T, smolar));
             }
-            else{
-                throw ValueError("Cubic has three roots, but phase not imposed and guess density not provided");
+            rho_min *= 0.1;
+        }
+    }
+    state.rhomolar = Brent(resid, rho_min, rho_max, DBL_EPSILON, 1e-12, 100);
+    flash_DT_pure(T, state.rhomolar, state);
+}
+
+void CoolProp::AbstractCubicBackend::flash_pure(CoolProp::input_pairs inputs){
+    PureFlashState state;
+    if (inputs == HmolarP_INPUTS){
+        flash_p_pure(_p, iHmolar, _hmolar, state);
+    }
+    else if (inputs == PSmolar_INPUTS){
+        flash_p_pure(_p, iSmolar, _smolar, state);
+    }
+    else if (inputs == HmolarSmolar_INPUTS){
+        // Entropy decreases with pressure along an isenthalp; expand in ln(p) until the solution is bracketed
+        PureHSPressureResidual resid(this, _hmolar, _smolar);
+        double lnp0 = log(get_cubic()->get_pc()[0]), f0 = resid.call(lnp0), dlnp = (f0 > 0) ? log(10.0) : -log(10.0);
+        double lnp1 = lnp0 + dlnp, f1 = resid.call(lnp1);
+        for (int i = 0; f0*f1 > 0; ++i){
+            if (i > 20){
+                throw ValueError(format("Unable to bracket the pressure for h: %g J/mol and s: %g J/mol/K", _hmolar, _smolar));
             }
+            lnp0 = lnp1; f0 = f1;
+            lnp1 += dlnp; f1 = resid.call(lnp1);
         }
+        _p = exp(Brent(resid, lnp0, lnp1, DBL_EPSILON, 1e-12, 100));
+        flash_p_pure(_p, iHmolar, _hmolar, state);
+    }
+    else if (inputs == DmolarP_INPUTS){
+        flash_D_pure(_rhomolar, iP, _p, state);
+    }
+    else if (inputs == DmolarHmolar_INPUTS){
+        flash_D_pure(_rhomolar, iHmolar, _hmolar, state);
+    }
+    else if (inputs == DmolarSmolar_INPUTS){
+        flash_D_pure(_rhomolar, iSmolar, _smolar, state);
+    }
+    else if (inputs == SmolarT_INPUTS){
+        flash_ST_pure(_T, _smolar, state);
     }
     else{
-        throw ValueError("Obtained neither 1 nor three roots");
+        throw ValueError(format("Invalid input pair [%s] for flash_pure", get_input_pair_short_desc(inputs).c_str()));
+    }
+    _T = state.T;
+    _p = state.p;
+    _rhomolar = state.rhomolar;
+    _hmolar = state.hmolar;
+    _smolar = state.smolar;
+    if (state.Q >= 0){
+        _Q = state.Q;
+        _phase = iphase_twophase;
+        this->SatL->update(DmolarT_INPUTS, state.rhoL, _T);
+        this->SatV->update(DmolarT_INPUTS, state.rhoV, _T);
+    }
+    else{
+        _Q = -1;
+        this->recalculate_singlephase_phase();
+    }
+}
+CoolPropDbl CoolProp::AbstractCubicBackend::solver_rho_Tp_global(CoolPropDbl T, CoolPropDbl p, CoolPropDbl rhomolar_max)
+{
+    _rhomolar = solver_rho_Tp(T, p, 40000);
+    return static_cast<double>(_rhomolar);
+    
+}
+CoolPropDbl CoolProp::AbstractCubicBackend::solver_rho_Tp(CoolPropDbl T, CoolPropDbl p, CoolPropDbl rho_guess){
+    // Use imposed phase to select root, otherwise take the stable root
+    phases phase = iphase_not_imposed;
+    if (imposed_phase_index == iphase_gas || imposed_phase_index == iphase_supercritical_gas){
+        phase = iphase_gas;
+    }
+    else if (imposed_phase_index == iphase_liquid || imposed_phase_index == iphase_supercritical_liquid){
+        phase = iphase_liquid;
     }
+    CoolPropDbl rho = rho_Tp_root(T, p, phase);
     if (is_pure_or_pseudopure){
         // Set some variables at the end
+        _rhomolar = rho;
         this->recalculate_singlephase_phase();
     }
     else{
@@ -505,6 +904,41 @@ CoolPropDbl CoolProp::AbstractCubicBackend::solver_rho_Tp(CoolPropDbl T, CoolPro
     return rho;
 }
 
+CoolPropDbl CoolProp::AbstractCubicBackend::rho_Tp_root(CoolPropDbl T, CoolPropDbl p, phases phase){
+    int Nsoln = 0;
+    double rho0 = 0, rho1 = 0, rho2 = 0;
+    rho_Tp_cubic(T, p, Nsoln, rho0, rho1, rho2); // Densities are sorted in increasing order
+    if (Nsoln == 1){
+        return rho0;
+    }
+    else if (Nsoln != 3){
+        throw ValueError("Obtained neither 1 nor three roots");
+    }
+    if (phase == iphase_liquid){
+        return rho2;
+    }
+    double rhoV;
+    if (rho0 > 0){
+        rhoV = rho0;
+    }
+    else if (rho1 > 0){
+        rhoV = rho1;
+    }
+    else{
+        throw CoolProp::ValueError(format("Unable to find gaseous density for T: %g K, p: %g Pa", T, p));
+    }
+    if (phase == iphase_gas){
+        return rhoV;
+    }
+    // Compare the Gibbs energies of the liquid and vapor roots
+    AbstractCubic *cubic = get_cubic().get();
+    const std::vector<double> &x = get_mole_fractions_doubleref();
+    double tau = cubic->get_Tr()/T, deltaL = rho2/cubic->get_rhor(), deltaV = rhoV/cubic->get_rhor();
+    double gL = log(deltaL) + cubic->alphar(tau, deltaL, x, 0, 0) + deltaL*cubic->alphar(tau, deltaL, x, 0, 1);
+    double gV = log(deltaV) + cubic->alphar(tau, deltaV, x, 0, 0) + deltaV*cubic->alphar(tau, deltaV, x, 0, 1);
+    return (gV < gL) ? rhoV : rho2;
+}
+
 CoolPropDbl CoolProp::AbstractCubicBackend::calc_molar_mass(void)
 {
     double summer = 0;
@@ -516,6 +950,8 @@ CoolPropDbl CoolProp::AbstractCubicBackend::calc_molar_mass(void)
 }
 
 void CoolProp::AbstractCubicBackend::set_binary_interaction_double(const std::size_t i, const std::size_t j, const std::string &parameter, const double value){
+    clear_critical_points_cache();
+    clear_saturation_cache();
     if (parameter == "kij" || parameter == "k_ij"){
         get_cubic()->set_kij(i, j, value);
     }
@@ -544,6 +980,8 @@ void CoolProp::AbstractCubicBackend::copy_all_alpha_functions(AbstractCubicBacke
 }
 
 void CoolProp::AbstractCubicBackend::copy_k(AbstractCubicBackend *donor){
+    clear_critical_points_cache();
+    clear_saturation_cache();
     get_cubic()->set_kmat(donor->get_cubic()->get_kmat());
     for (std::vector<shared_ptr<HelmholtzEOSMixtureBackend> >::iterator it = linked_states.begin(); it != linked_states.end(); ++it) {
         AbstractCubicBackend *ACB = static_cast<AbstractCubicBackend *>(it->get());
@@ -552,6 +990,8 @@ void CoolProp::AbstractCubicBackend::copy_k(AbstractCubicBackend *donor){
 }
 
 void CoolProp::AbstractCubicBackend::copy_internals(AbstractCubicBackend &donor){
+    clear_critical_points_cache();
+    clear_saturation_cache();
     this->copy_k(&donor);
     
     this->components = donor.components;
@@ -567,6 +1007,8 @@ void CoolProp::AbstractCubicBackend::copy_internals(AbstractCubicBackend &donor)
 
 
 void CoolProp::AbstractCubicBackend::set_cubic_alpha_C(const size_t i, const std::string &parameter, const double c1, const double c2, const double c3){
+    clear_critical_points_cache();
+    clear_saturation_cache();
     if (parameter == "MC" || parameter == "mc" || parameter == "Mathias-Copeman") {
         get_cubic()->set_C_MC(i,c1, c2, c3);
     }
@@ -584,6 +1026,8 @@ void CoolProp::AbstractCubicBackend::set_cubic_alpha_C(const size_t i, const std
 
 void CoolProp::AbstractCubicBackend::set_fluid_parameter_double(const size_t i, const std::string &parameter, const double value)
 {
+    clear_critical_points_cache();
+    clear_saturation_cache();
     // Set the volume translation parrameter, currently applied to the whole fluid, not to components.
     if (parameter == "c" || parameter == "cm" || parameter == "c_m") {
         get_cubic()->set_cm(value);
@@ -616,3 +1060,68 @@ double CoolProp::AbstractCubicBackend::get_fluid_parameter_double(const size_t i
         throw ValueError(format("I don't know what to do with parameter [%s]", parameter.c_str()));
     }
 }
+
+#ifdef ENABLE_CATCH
+#include "catch.hpp"
+
+TEST_CASE("Check the native flashes of the cubic backends for pure fluids", "[cubic_flash]")
+{
+    std::vector<std::string> backends; backends.push_back("SRK"); backends.push_back("PR");
+    for (std::size_t b = 0; b < backends.size(); ++b){
+        CAPTURE(backends[b]);
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory(backends[b], "Propane"));
+        double Ts[] = {250, 300, 340, 420}, ps[] = {2e5, 1e6, 6e6};
+        for (std::size_t i = 0; i < 4; ++i){
+            for (std::size_t j = 0; j < 3; ++j){
+                CAPTURE(Ts[i]);
+                CAPTURE(ps[j]);
+                AS->update(CoolProp::PT_INPUTS, ps[j], Ts[i]);
+                double h = AS->hmolar(), s = AS->smolar(), rho = AS->rhomolar();
+                AS->update(CoolProp::HmolarP_INPUTS, h, ps[j]);
+                CHECK(std::abs(AS->T()/Ts[i]-1) < 1e-8);
+                CHECK(std::abs(AS->rhomolar()/rho-1) < 1e-8);
+                AS->update(CoolProp::PSmolar_INPUTS, ps[j], s);
+                CHECK(std::abs(AS->T()/Ts[i]-1) < 1e-8);
+                AS->update(CoolProp::HmolarSmolar_INPUTS, h, s);
+                CHECK(std::abs(AS->T()/Ts[i]-1) < 1e-8);
+                CHECK(std::abs(AS->p()/ps[j]-1) < 1e-8);
+                // Density-based pairs and entropy-temperature
+                AS->update(CoolProp::DmolarP_INPUTS, rho, ps[j]);
+                CHECK(std::abs(AS->T()/Ts[i]-1) < 1e-6);
+                AS->update(CoolProp::DmolarHmolar_INPUTS, rho, h);
+                CHECK(std::abs(AS->T()/Ts[i]-1) < 1e-6);
+                AS->update(CoolProp::DmolarSmolar_INPUTS, rho, s);
+                CHECK(std::abs(AS->T()/Ts[i]-1) < 1e-6);
+                AS->update(CoolProp::SmolarT_INPUTS, s, Ts[i]);
+                CHECK(std::abs(AS->p()/ps[j]-1) < 1e-6);
+            }
+        }
+        SECTION("two-phase"){
+            AS->update(CoolProp::PQ_INPUTS, 1e6, 0.3);
+            double T = AS->T(), h = AS->hmolar(), s = AS->smolar(), rho = AS->rhomolar();
+            // On either side of the saturation temperature, the stable root is the liquid or the vapor
+            AS->update(CoolProp::PT_INPUTS, 1e6, T - 0.01);
+            CHECK(AS->rhomolar() > AS->saturated_liquid_keyed_output(CoolProp::iDmolar)*0.99);
+            AS->update(CoolProp::PT_INPUTS, 1e6, T + 0.01);
+            CHECK(AS->rhomolar() < AS->saturated_vapor_keyed_output(CoolProp::iDmolar)*1.01);
+            AS->update(CoolProp::HmolarP_INPUTS, h, 1e6);
+            CHECK(std::abs(AS->Q()-0.3) < 1e-10);
+            CHECK(std::abs(AS->T()/T-1) < 1e-10);
+            AS->update(CoolProp::PSmolar_INPUTS, 1e6, s);
+            CHECK(std::abs(AS->Q()-0.3) < 1e-10);
+            AS->update(CoolProp::HmolarSmolar_INPUTS, h, s);
+            CHECK(std::abs(AS->Q()-0.3) < 1e-6);
+            CHECK(std::abs(AS->p()/1e6-1) < 1e-6);
+            AS->update(CoolProp::DmolarP_INPUTS, rho, 1e6);
+            CHECK(std::abs(AS->Q()-0.3) < 1e-6);
+            AS->update(CoolProp::DmolarHmolar_INPUTS, rho, h);
+            CHECK(std::abs(AS->Q()-0.3) < 1e-6);
+            CHECK(std::abs(AS->T()/T-1) < 1e-6);
+            AS->update(CoolProp::SmolarT_INPUTS, s, T);
+            CHECK(std::abs(AS->Q()-0.3) < 1e-6);
+            CHECK(std::abs(AS->p()/1e6-1) < 1e-6);
+        }
+    }
+}
+
+#endif
@@ -33,6 +33,12 @@ class AbstractCubicBackend : public HelmholtzEOSMixtureBackend  {
 protected:
     shared_ptr<AbstractCubic> cubic;
     std::vector<CubicLibrary::CubicsValues> components; ///< The components that are in use
+
+    /// The last saturation state of a pure fluid, from which the Newton iterations of the saturation solvers are started
+    struct PureSaturationGuess{
+        CoolPropDbl T, p, dlnp_dinvT; ///< Temperature, pressure and the Clausius-Clapeyron slope \f$ d\ln p/d(1/T) \f$
+        PureSaturationGuess() : T(-1), p(-1), dlnp_dinvT(0) {};
+    } saturation_guess;
 public:
 	
 	/// Set the pointer to the residual helmholtz class, etc.
@@ -191,9 +197,75 @@ public:
         TPD_state.reset(get_copy());
     };
     
+    /** \brief Select one of the (sorted) density roots of the cubic at the given temperature and pressure
+     *
+     * If the phase is iphase_liquid, the largest root is returned; if the phase is iphase_gas, the smallest positive root.
+     * Otherwise the stable root is returned, which is the one with the lowest Gibbs energy; the comparison only requires
+     * \f$ \ln\delta + \alpha^r + \delta\alpha^r_\delta \f$ since all other terms are only a function of temperature
+     */
+    CoolPropDbl rho_Tp_root(CoolPropDbl T, CoolPropDbl p, phases phase);
+
     /// Cubic backend flashes for PQ, and QT
     void saturation(CoolProp::input_pairs inputs);
 
+    /// Solve for the saturation temperature of a pure fluid at the given pressure from the equality of Gibbs energies of the phases
+    CoolPropDbl saturation_T_pure(CoolPropDbl p, CoolPropDbl &rhoL, CoolPropDbl &rhoV);
+
+    /// Solve for the saturation pressure of a pure fluid at the given temperature from the equality of Gibbs energies of the phases
+    CoolPropDbl saturation_p_pure(CoolPropDbl T, CoolPropDbl &rhoL, CoolPropDbl &rhoV);
+
+    /// Store the saturation state of a pure fluid as the starting point of the next call to saturation_T_pure or saturation_p_pure
+    void set_saturation_guess(CoolPropDbl T, CoolPropDbl p, CoolPropDbl rhoL, CoolPropDbl rhoV);
+
+    /// Calculate the molar enthalpy and molar entropy at the given temperature and density directly from the cubic
+    void calc_hmolar_smolar_cubic(CoolPropDbl T, CoolPropDbl rhomolar, CoolPropDbl &hmolar, CoolPropDbl &smolar);
+    /// The derivatives of up to second order of the ideal-gas Helmholtz energy of a pure fluid from one evaluation, in the reduced variables of the cubic
+    HelmholtzDerivatives calc_alpha0_pure_cubic(CoolPropDbl tau, CoolPropDbl delta);
+
+    /// Calculate the molar enthalpy, molar entropy and molar isobaric heat capacity at the given temperature and density directly from the cubic
+    void calc_hmolar_smolar_cubic(CoolPropDbl T, CoolPropDbl rhomolar, CoolPropDbl &hmolar, CoolPropDbl &smolar, CoolPropDbl &cpmolar);
+
+    /// The state that results from a flash of a pure fluid with the cubic
+    struct PureFlashState{
+        CoolPropDbl T, p, rhomolar, Q, rhoL, rhoV, hmolar, smolar;
+    };
+
+    /** \brief Flash a pure fluid with pressure and one of molar enthalpy or molar entropy as inputs
+     *
+     * Below the critical pressure, the saturation state at the given pressure is evaluated first.  If the input
+     * lies between the saturated liquid and vapor values the state is two-phase and the quality follows from the lever rule.
+     * Otherwise the temperature is obtained with Brent's method along the liquid or vapor root of the cubic. Nothing
+     * is stored in this instance.
+     *
+     * \param p The pressure in Pa
+     * \param key iHmolar or iSmolar
+     * \param value The value of the molar enthalpy or molar entropy
+     * \param state The resulting state
+     */
+    void flash_p_pure(CoolPropDbl p, parameters key, CoolPropDbl value, PureFlashState &state);
+
+    /// Evaluate the state of a pure fluid at the given temperature and density, which is two-phase if the density lies inside the dome
+    void flash_DT_pure(CoolPropDbl T, CoolPropDbl rhomolar, PureFlashState &state);
+
+    /** \brief Flash a pure fluid with molar density and one of pressure, molar enthalpy or molar entropy as inputs
+     *
+     * All three increase with temperature along an isochore, so the temperature is obtained with Brent's method on
+     * the state from flash_DT_pure.  Nothing is stored in this instance.
+     *
+     * \param rhomolar The molar density in mol/m^3
+     * \param key iP, iHmolar or iSmolar
+     * \param value The value of the pressure, molar enthalpy or molar entropy
+     * \param state The resulting state
+     */
+    void flash_D_pure(CoolPropDbl rhomolar, parameters key, CoolPropDbl value, PureFlashState &state);
+
+    /// Flash a pure fluid with temperature and molar entropy as inputs; outside the dome the density is obtained with Brent's method
+    void flash_ST_pure(CoolPropDbl T, CoolPropDbl smolar, PureFlashState &state);
+
+    /// Cubic backend flashes for HmolarP, PSmolar, HmolarSmolar, DmolarP, DmolarHmolar, DmolarSmolar and SmolarT of pure fluids;
+    /// the HS flash iterates on the pressure of a HmolarP flash
+    void flash_pure(CoolProp::input_pairs inputs);
+
     CoolPropDbl calc_molar_mass(void);
     
     void set_binary_interaction_double(const std::size_t i1, const std::size_t i2, const std::string &parameter, const double value);
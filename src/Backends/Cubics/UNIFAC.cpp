@@ -1,11 +1,10 @@
 #include "UNIFAC.h"
 
 void UNIFAC::UNIFACMixture::set_interaction_parameters() {
-    for (std::set<std::size_t>::const_iterator itisgi = unique_groups.begin(); itisgi != unique_groups.end(); ++itisgi) {
-        for (std::set<std::size_t>::const_iterator itjsgi = unique_groups.begin(); itjsgi != unique_groups.end(); ++itjsgi) {
-            if (*itjsgi >= *itisgi){ continue; }
-            std::size_t mgi1 = m_sgi_to_mgi.find(*itisgi)->second;
-            std::size_t mgi2 = m_sgi_to_mgi.find(*itjsgi)->second;
+    for (std::size_t i = 0; i < G; ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+            std::size_t mgi1 = m_mgi[i];
+            std::size_t mgi2 = m_mgi[j];
             // Insert in normal order
             std::pair< std::pair<int, int>, UNIFACLibrary::InteractionParameters> m_pair(std::pair<int, int>(mgi1, mgi2), library.get_interaction_parameters(mgi1, mgi2));
             interaction.insert(m_pair);
@@ -16,6 +15,7 @@ void UNIFAC::UNIFACMixture::set_interaction_parameters() {
             }
         }
     }
+    m_interaction_changed = true;
 }
 
 void UNIFAC::UNIFACMixture::set_interaction_parameter(const std::size_t mgi1, const std::size_t mgi2, const std::string &parameter, const double value) {
@@ -31,6 +31,7 @@ void UNIFAC::UNIFACMixture::set_interaction_parameter(const std::size_t mgi1, co
     else {
         throw CoolProp::ValueError(format("I don't know what to do with parameter [%s]", parameter.c_str()));
     }
+    m_interaction_changed = true;
 }
 double UNIFAC::UNIFACMixture::get_interaction_parameter(const std::size_t mgi1, const std::size_t mgi2, const std::string &parameter) {
     std::map< std::pair<int,int>, UNIFACLibrary::InteractionParameters>::iterator it = this->interaction.find(std::pair<int,int>(mgi1,mgi2));
@@ -55,47 +56,87 @@ double UNIFAC::UNIFACMixture::get_interaction_parameter(const std::size_t mgi1,
 
 /// Set the mole fractions of the components in the mixtures (not the groups)
 void UNIFAC::UNIFACMixture::set_mole_fractions(const std::vector<double> &z) {
-//    // If the vector fractions are the same as last ones, don't do anything and return
-//    if (!mole_fractions.empty() && maxvectordiff(z, mole_fractions) < 1e-15){
-//        return;
-//    }
-    this->mole_fractions = z;
     if (this->N != z.size()) {
         throw CoolProp::ValueError("Size of molar fraction do not match number of components.");
     }
-    
-    std::map<std::size_t, double> &Xg = m_Xg, &thetag = m_thetag;
-    Xg.clear(); thetag.clear();
-    
-    // Iterate over the fluids
+    // If the mole fractions are the same as the last ones, the group fractions and the cached values are still valid
+    if (z == this->mole_fractions){
+        return;
+    }
+    this->mole_fractions = z;
+    set_group_fractions();
+}
+
+/// Calculate the mole fraction and theta of each group in the mixture
+void UNIFAC::UNIFACMixture::set_group_fractions() {
+    clear_cached_values();
+    m_Xg.assign(G, 0.0); m_thetag.assign(G, 0.0);
+
     double X_summer = 0;
-    for (std::size_t i = 0; i < this->mole_fractions.size(); ++i) {
-        X_summer += this->mole_fractions[i] * pure_data[i].group_count;
-    }
-    /// Calculations for each group in the total mixture
-    for (std::set<std::size_t>::iterator itsgi = unique_groups.begin(); itsgi != unique_groups.end(); ++itsgi){
-        double X = 0;
-        // Iterate over the fluids
-        for (std::size_t i = 0; i < this->mole_fractions.size(); ++i) {
-            X += this->mole_fractions[i]*group_count(i, *itsgi);
+    for (std::size_t i = 0; i < N; ++i) {
+        const double *count = &(m_count[i*G]);
+        for (std::size_t k = 0; k < G; ++k) {
+            m_Xg[k] += this->mole_fractions[i]*count[k];
         }
-        Xg.insert(std::pair<std::size_t, double>(*itsgi, X));
     }
-    /// Now come back through and divide by the sum(z_i*count) for this fluid
-    for (std::map<std::size_t, double>::iterator it = Xg.begin(); it != Xg.end(); ++it) {
-        it->second /= X_summer;
-        //printf("X_{%d}: %g\n", it->first, it->second);
+    for (std::size_t k = 0; k < G; ++k) {
+        X_summer += m_Xg[k];
     }
+    /// Now divide by the sum(z_i*count) over all the groups, and form theta from X*Q divided by sum(X*Q)
     double theta_summer = 0;
-    for (std::set<std::size_t>::iterator itsgi = unique_groups.begin(); itsgi != unique_groups.end(); ++itsgi) {
-        double cont = Xg.find(*itsgi)->second * m_Q.find(*itsgi)->second;
-        theta_summer += cont;
-        thetag.insert(std::pair<std::size_t, double>(*itsgi, cont));
+    for (std::size_t k = 0; k < G; ++k) {
+        m_Xg[k] /= X_summer;
+        m_thetag[k] = m_Xg[k]*m_Q[k];
+        theta_summer += m_thetag[k];
+    }
+    for (std::size_t k = 0; k < G; ++k) {
+        m_thetag[k] /= theta_summer;
+    }
+}
+
+void UNIFAC::UNIFACMixture::clear_cached_values() {
+    _T.clear();
+    m_lnGammaR_tau.clear();
+}
+
+void UNIFAC::UNIFACMixture::set_interaction_matrices() {
+    if (this->interaction.size() == 0) {
+        throw CoolProp::ValueError("interaction parameters for UNIFAC not yet set");
     }
-    /// Now come back through and divide by the sum(X*Q) for this fluid
-    for (std::map<std::size_t, double>::iterator it = thetag.begin(); it != thetag.end(); ++it) {
-        it->second /= theta_summer;
-        //printf("theta_{%d}: %g\n", it->first, it->second);
+    m_aij.assign(G*G, 0.0); m_bij.assign(G*G, 0.0); m_cij.assign(G*G, 0.0);
+    for (std::size_t k = 0; k < G; ++k) {
+        for (std::size_t m = 0; m < G; ++m) {
+            if (m_mgi[k] == m_mgi[m]) { continue; } // Psi is 1 within a main group
+            std::map<std::pair<int, int>, UNIFACLibrary::InteractionParameters>::const_iterator it = this->interaction.find(std::pair<int, int>(static_cast<int>(m_mgi[k]), static_cast<int>(m_mgi[m])));
+            if (it == this->interaction.end()) {
+                throw CoolProp::ValueError(format("Could not match mgi[%d]-mgi[%d] interaction in UNIFAC", static_cast<int>(m_mgi[k]), static_cast<int>(m_mgi[m])));
+            }
+            m_aij[k*G + m] = it->second.a_ij; m_bij[k*G + m] = it->second.b_ij; m_cij[k*G + m] = it->second.c_ij;
+        }
+    }
+    m_interaction_changed = false;
+    m_T_Psi = _HUGE;
+    clear_cached_values();
+}
+
+/// Calculate ln(Gamma_k) = Q_k*(1 - ln(sum_m theta_m*Psi_mk) - sum_m theta_m*Psi_km/sum_n theta_n*Psi_nm) for all the G groups
+static void group_activities(std::size_t G, const double *theta, const double *Psi, const double *Q, double *lnGamma, double *sum_theta_Psi) {
+    for (std::size_t m = 0; m < G; ++m) {
+        sum_theta_Psi[m] = 0;
+    }
+    for (std::size_t n = 0; n < G; ++n) {
+        const double theta_n = theta[n], *Psi_n = Psi + n*G;
+        for (std::size_t m = 0; m < G; ++m) {
+            sum_theta_Psi[m] += theta_n*Psi_n[m];
+        }
+    }
+    for (std::size_t k = 0; k < G; ++k) {
+        const double *Psi_k = Psi + k*G;
+        double s = 1 - log(sum_theta_Psi[k]);
+        for (std::size_t m = 0; m < G; ++m) {
+            s -= theta[m]*Psi_k[m]/sum_theta_Psi[m];
+        }
+        lnGamma[k] = Q[k]*s;
     }
 }
 
@@ -129,91 +170,81 @@ std::size_t UNIFAC::UNIFACMixture::group_count(std::size_t i, std::size_t sgi) c
 }
 
 double UNIFAC::UNIFACMixture::theta_pure(std::size_t i, std::size_t sgi) const {
-    return pure_data[i].theta.find(sgi)->second;
+    std::map<std::size_t, std::size_t>::const_iterator it = m_group_index.find(sgi);
+    return (it == m_group_index.end()) ? 0.0 : m_theta_pure[i*G + it->second];
 }
 
 void UNIFAC::UNIFACMixture::set_temperature(const double T){
-//    // Check whether you are using exactly the same temperature as last time
-//    if (static_cast<bool>(_T) && std::abs(static_cast<double>(_T) - T) < 1e-15 {
-//        // 
-//        return;
-//    }
-    this->m_T = T;
-    
     if (this->mole_fractions.empty()){
         throw CoolProp::ValueError("mole fractions must be set before calling set_temperature");
     }
+    if (m_interaction_changed){
+        set_interaction_matrices();
+    }
+    // Check whether you are using exactly the same temperature as last time
+    if (static_cast<bool>(_T) && static_cast<double>(_T) == T) {
+        return;
+    }
+    this->m_T = T;
 
-    // Compute Psi once for the different calls
-    for (std::set<std::size_t>::iterator itk = unique_groups.begin(); itk != unique_groups.end(); ++itk) {
-        for (std::set<std::size_t>::iterator itm = unique_groups.begin(); itm != unique_groups.end(); ++itm) {
-            Psi_[std::pair<std::size_t, std::size_t>(*itk, *itm)] = Psi(*itk, *itm);
+    // Psi and the group activities in the pure components only depend on the temperature
+    if (m_T_Psi != T) {
+        m_Psi.resize(G*G);
+        for (std::size_t km = 0; km < G*G; ++km) {
+            m_Psi[km] = exp(-(m_aij[km]/T + m_bij[km] + m_cij[km]*T));
         }
-    }
-    
-    for (std::size_t i = 0; i < this->mole_fractions.size(); ++i) {
-        const UNIFACLibrary::Component &c = components[i];
-        for (std::size_t k = 0; k < c.groups.size(); ++k) {
-            double Q = c.groups[k].group.Q_k;
-            int sgik = c.groups[k].group.sgi;
-            double sum1 = 0;
-            for (std::size_t m = 0; m < c.groups.size(); ++m) {
-                int sgim = c.groups[m].group.sgi;
-                sum1 += theta_pure(i, sgim)*Psi_.find(std::pair<std::size_t, std::size_t>(sgim, sgik))->second;
-            }
-            double s = 1 - log(sum1);
-            for (std::size_t m = 0; m < c.groups.size(); ++m) {
-                int sgim = c.groups[m].group.sgi;
-                double sum2 = 0;
-                for (std::size_t n = 0; n < c.groups.size(); ++n) {
-                    int sgin = c.groups[n].group.sgi;
-                    sum2 += theta_pure(i, sgin)*Psi_.find(std::pair<std::size_t, std::size_t>(sgin, sgim))->second;
-                }
-                s -= theta_pure(i, sgim)*Psi_.find(std::pair<std::size_t, std::size_t>(sgik, sgim))->second/sum2;
-            }
-            pure_data[i].lnGamma[sgik] = Q*s;
-            //printf("ln(Gamma)^(%d)_{%d}: %g\n", static_cast<int>(i + 1), sgik, Q*s);
+        m_lnGamma_pure.resize(N*G);
+        m_work.resize(G);
+        for (std::size_t i = 0; i < N; ++i) {
+            // The groups that are not in the pure component have theta = 0 and so do not contribute to the sums
+            group_activities(G, &(m_theta_pure[i*G]), &(m_Psi[0]), &(m_Q[0]), &(m_lnGamma_pure[i*G]), &(m_work[0]));
         }
+        m_T_Psi = T;
     }
-    
-    std::map<std::size_t, double> &thetag = m_thetag, &lnGammag = m_lnGammag;
-    lnGammag.clear();
 
-    for (std::set<std::size_t>::iterator itksgi = unique_groups.begin(); itksgi != unique_groups.end(); ++itksgi) {
-        double sum1 = 0;
-        for (std::set<std::size_t>::iterator itmsgi = unique_groups.begin(); itmsgi != unique_groups.end(); ++itmsgi) {
-            sum1 += thetag.find(*itmsgi)->second*Psi_.find(std::pair<std::size_t, std::size_t>(*itmsgi, *itksgi))->second;
-        }
-        double s = 1-log(sum1);
-        for (std::set<std::size_t>::iterator itmsgi = unique_groups.begin(); itmsgi != unique_groups.end(); ++itmsgi) {
-            double sum3 = 0;
-            for (std::set<std::size_t>::iterator itnsgi = unique_groups.begin(); itnsgi != unique_groups.end(); ++itnsgi) {
-                sum3 += thetag.find(*itnsgi)->second*Psi_.find(std::pair<std::size_t, std::size_t>(*itnsgi, *itmsgi))->second;
-            }
-            s -= thetag.find(*itmsgi)->second*Psi_.find(std::pair<std::size_t, std::size_t>(*itksgi, *itmsgi))->second/sum3;
+    m_lnGammag.resize(G);
+    group_activities(G, &(m_thetag[0]), &(m_Psi[0]), &(m_Q[0]), &(m_lnGammag[0]), &(m_work[0]));
+
+    m_lnGammaR.resize(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        const double *count = &(m_count[i*G]), *lnGamma_pure = &(m_lnGamma_pure[i*G]);
+        double summer = 0;
+        for (std::size_t k = 0; k < G; ++k) {
+            summer += count[k]*(m_lnGammag[k] - lnGamma_pure[k]);
         }
-        lnGammag.insert(std::pair<std::size_t, double>(*itksgi, m_Q.find(*itksgi)->second*s));
-        //printf("log(Gamma)_{%d}: %g\n", itk->sgi, itk->Q_k*s);
+        m_lnGammaR[i] = summer;
     }
     _T = m_T;
 }
-double UNIFAC::UNIFACMixture::ln_gamma_R(const double tau, std::size_t i, std::size_t itau){
-    if (itau == 0) {
-        set_temperature(T_r / tau);
-        double summer = 0;
-        for (std::set<std::size_t>::const_iterator itsgi = unique_groups.begin(); itsgi != unique_groups.end(); ++itsgi) {
-            std::size_t count = group_count(i, *itsgi);
-            if (count > 0){
-                summer += count*(m_lnGammag.find(*itsgi)->second - pure_data[i].lnGamma.find(*itsgi)->second);
+const std::vector<double> & UNIFAC::UNIFACMixture::ln_gamma_R(const double tau, std::size_t itau){
+    // Apply the pending changes of the parameters first, since that empties the cache
+    if (m_interaction_changed){
+        set_interaction_matrices();
+    }
+    if (m_lnGammaR_tau.size() <= itau) {
+        m_lnGammaR_tau.resize(itau + 1, std::pair<double, std::vector<double> >(_HUGE, std::vector<double>()));
+    }
+    if (m_lnGammaR_tau[itau].first != tau) {
+        if (itau == 0) {
+            set_temperature(T_r / tau);
+            m_lnGammaR_tau[0].second = m_lnGammaR;
+        }
+        else {
+            double dtau = 0.01*tau;
+            std::vector<double> plus = ln_gamma_R(tau + dtau, itau - 1);
+            const std::vector<double> &minus = ln_gamma_R(tau - dtau, itau - 1);
+            std::vector<double> &derivs = m_lnGammaR_tau[itau].second;
+            derivs.resize(N);
+            for (std::size_t i = 0; i < N; ++i) {
+                derivs[i] = (plus[i] - minus[i]) / (2 * dtau);
             }
         }
-        //printf("log(gamma)_{%d}: %g\n", i+1, summer);
-        return summer;
-    }
-    else {
-        double dtau = 0.01*tau;
-        return (ln_gamma_R(tau + dtau, i, itau - 1) - ln_gamma_R(tau - dtau, i, itau - 1)) / (2 * dtau);
+        m_lnGammaR_tau[itau].first = tau;
     }
+    return m_lnGammaR_tau[itau].second;
+}
+double UNIFAC::UNIFACMixture::ln_gamma_R(const double tau, std::size_t i, std::size_t itau){
+    return ln_gamma_R(tau, itau)[i];
 }
 void UNIFAC::UNIFACMixture::activity_coefficients(double tau, const std::vector<double> &z, std::vector<double> &gamma){
     if (this->N != z.size()) {
@@ -274,36 +305,49 @@ void UNIFAC::UNIFACMixture::set_components(const std::string &identifier_type, s
 
 /// Calculate the parameters X and theta for the pure components, which does not depend on temperature nor molar fraction
 void UNIFAC::UNIFACMixture::set_pure_data() {
-    pure_data.clear();
-    unique_groups.clear();
-    m_Q.clear();
+    // Number the unique groups of the mixture in order of their sgi
+    m_group_index.clear();
+    for (std::size_t i = 0; i < N; ++i) {
+        const UNIFACLibrary::Component &c = components[i];
+        for (std::size_t j = 0; j < c.groups.size(); ++j) {
+            m_group_index.insert(std::pair<std::size_t, std::size_t>(c.groups[j].group.sgi, 0));
+        }
+    }
+    G = m_group_index.size();
+    m_sgi.resize(G); m_mgi.resize(G); m_Q.resize(G);
+    std::size_t k = 0;
+    for (std::map<std::size_t, std::size_t>::iterator it = m_group_index.begin(); it != m_group_index.end(); ++it, ++k) {
+        it->second = k;
+        m_sgi[k] = it->first;
+        m_mgi[k] = m_sgi_to_mgi.find(it->first)->second;
+    }
+    m_count.assign(N*G, 0.0);
+    m_theta_pure.assign(N*G, 0.0);
     for (std::size_t i = 0; i < N; ++i) {
         const UNIFACLibrary::Component &c = components[i];
-        ComponentData cd;
         double summerxq = 0;
-        cd.group_count = 0;
         for (std::size_t j = 0; j < c.groups.size(); ++j) {
             const UNIFACLibrary::ComponentGroup &cg = c.groups[j];
-            double x = static_cast<double>(cg.count);
-            double theta = static_cast<double>(cg.count*cg.group.Q_k);
-            cd.X.insert(std::pair<int, double>(cg.group.sgi, x));
-            cd.theta.insert(std::pair<int, double>(cg.group.sgi, theta));
-            cd.group_count += cg.count;
-            summerxq += x*cg.group.Q_k;
-            unique_groups.insert(cg.group.sgi);
-            m_Q.insert(std::pair<std::size_t, double>(cg.group.sgi,cg.group.Q_k));
-        }
-        /// Now come back through and divide by the total # groups for this fluid
-        for (std::map<std::size_t, double>::iterator it = cd.X.begin(); it != cd.X.end(); ++it) {
-            it->second /= cd.group_count;
-            //printf("X^(%d)_{%d}: %g\n", static_cast<int>(i + 1), static_cast<int>(it->first), it->second);
+            std::size_t kg = m_group_index.find(cg.group.sgi)->second;
+            m_count[i*G + kg] = static_cast<double>(cg.count);
+            m_theta_pure[i*G + kg] = static_cast<double>(cg.count*cg.group.Q_k);
+            m_Q[kg] = cg.group.Q_k;
+            summerxq += cg.count*cg.group.Q_k;
         }
         /// Now come back through and divide by the sum(X*Q) for this fluid
-        for (std::map<std::size_t, double>::iterator it = cd.theta.begin(); it != cd.theta.end(); ++it) {
-            it->second /= summerxq;
-            //printf("theta^(%d)_{%d}: %g\n", static_cast<int>(i+1), static_cast<int>(it->first), it->second);
+        for (std::size_t kg = 0; kg < G; ++kg) {
+            m_theta_pure[i*G + kg] /= summerxq;
         }
-        pure_data.push_back(cd);
+    }
+    // Everything that depends on the groups has to be recalculated
+    m_interaction_changed = true;
+    m_T_Psi = _HUGE;
+    if (this->mole_fractions.size() == N) {
+        set_group_fractions();
+    }
+    else {
+        this->mole_fractions.clear();
+        clear_cached_values();
     }
 }
 
@@ -7,12 +7,6 @@
 #include "CachedElement.h"
 #include "Exceptions.h"
 
-/// Structure containing data for the pure fluid in the mixture
-struct ComponentData {
-    std::map<std::size_t, double> X, theta, lnGamma;
-    int group_count; ///< The total number of groups in the pure fluid
-};
-
 namespace UNIFAC
 {
     class UNIFACMixture
@@ -21,38 +15,61 @@ namespace UNIFAC
         /// A const reference to the library of group and interaction parameters
         const UNIFACLibrary::UNIFACParameterLibrary &library;
         
-        CoolProp::CachedElement _T; ///< The cached temperature
+        CoolProp::CachedElement _T; ///< The temperature of the mixture group activities and ln(gamma_R) in K
 
         std::size_t N; ///< Number of components
 
         double m_T; ///< The temperature in K
         double T_r; ///< Reducing temperature
 
-        std::map<std::pair<std::size_t, std::size_t>, double> Psi_; /// < temporary storage for Psi
-
-        std::map<std::size_t, double> m_Xg,  ///< Map from sgi to mole fraction of group in the mixture
-                                      m_thetag, ///< Map from sgi to theta for the group in the mixture
-                                      m_lnGammag, ///< Map from sgi to ln(Gamma) for the group in the mixture
-                                      m_Q; ///< Map from sgi to Q for the sgi
-
         /// A map from (i, j) indices for subgroup, subgroup indices to the interaction parameters for this pair
         std::map<std::pair<int, int>, UNIFACLibrary::InteractionParameters> interaction;
 
         /// A map from SGI to MGI
         std::map<std::size_t, std::size_t> m_sgi_to_mgi;
 
-        /// The set of unique groups in this mixture
-        std::set<std::size_t> unique_groups;
-    
         std::vector<double> mole_fractions;
 
         std::vector<UNIFACLibrary::Component> components;
 
-        std::vector<ComponentData> pure_data;
+        /// The groups of the mixture are numbered 0..G-1 when the components are set, and all the arrays below use
+        /// these dense indices; the G x G and N x G matrices are stored row by row
+        std::size_t G; ///< Number of unique groups in the mixture
+        std::map<std::size_t, std::size_t> m_group_index; ///< Map from sgi to the dense index of the group
+        std::vector<std::size_t> m_sgi, ///< The sgi of each group
+                                 m_mgi; ///< The mgi of each group
+        std::vector<double> m_Q, ///< Q_k of each group
+                            m_count, ///< N x G, the number of each group in each component
+                            m_theta_pure; ///< N x G, theta of each group in each pure component
+
+        bool m_interaction_changed; ///< True if the matrices of interaction parameters must be rebuilt from \ref interaction
+        std::vector<double> m_aij, m_bij, m_cij; ///< G x G, the interaction parameters between the main groups of two groups
+
+        double m_T_Psi; ///< The temperature of m_Psi and m_lnGamma_pure in K
+        std::vector<double> m_Psi, ///< G x G, Psi between two groups
+                            m_lnGamma_pure; ///< N x G, ln(Gamma) of each group in each pure component
+
+        std::vector<double> m_Xg, ///< Mole fraction of each group in the mixture
+                            m_thetag, ///< theta of each group in the mixture
+                            m_lnGammag, ///< ln(Gamma) of each group in the mixture
+                            m_lnGammaR, ///< ln(gamma_R) of each component at _T
+                            m_work; ///< Scratch space of G values
+
+        /// The last ln(gamma_R) of all the components for each number of tau derivatives, with the tau they were evaluated at
+        std::vector<std::pair<double, std::vector<double> > > m_lnGammaR_tau;
+
+        /// Build the matrices of interaction parameters from \ref interaction
+        void set_interaction_matrices();
+
+        /// Calculate the mole fraction and theta of each group in the mixture from the mole fractions of the components
+        void set_group_fractions();
+
+        /// Forget the cached values that depend on the composition and temperature
+        void clear_cached_values();
     
     public:
         
-        UNIFACMixture(const UNIFACLibrary::UNIFACParameterLibrary &library, const double T_r) : library(library), T_r(T_r) {};
+        UNIFACMixture(const UNIFACLibrary::UNIFACParameterLibrary &library, const double T_r) : library(library), N(0), m_T(_HUGE), T_r(T_r), G(0), m_interaction_changed(true), m_T_Psi(_HUGE) {};
 
         /** 
         * \brief Set all the interaction parameters between groups
@@ -71,7 +88,7 @@ namespace UNIFAC
         /// Get the mole fractions of the components in the mixtures (not the groups)
         const std::vector<double> & get_mole_fractions() { return mole_fractions; }
 
-        /// Set the temperature of the components in the mixtures (not the groups)
+        /// Set the temperature of the components in the mixtures (not the groups); nothing is recalculated if it has not changed
         void set_temperature(const double T);
 
         /// Get the temperature
@@ -83,8 +100,12 @@ namespace UNIFAC
 
         void activity_coefficients(double tau, const std::vector<double> &z, std::vector<double> &gamma);
 
+        /// The residual part of ln(gamma) of component i, or its itau-th derivative with respect to tau
         double ln_gamma_R(const double tau, std::size_t i, std::size_t itau);
 
+        /// The residual part of ln(gamma) of all the components, or its itau-th derivative with respect to tau, from one evaluation of the group activities
+        const std::vector<double> & ln_gamma_R(const double tau, std::size_t itau);
+
         std::size_t group_count(std::size_t i, std::size_t sgi) const;
 
         /// Add a component with the defined groups defined by (count, sgi) pairs
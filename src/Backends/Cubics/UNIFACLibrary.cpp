@@ -14,13 +14,10 @@ namespace UNIFACLibrary{
             return;
         }
     }
-    void UNIFACParameterLibrary::populate(rapidjson::Value &group_data, rapidjson::Value &interaction_data, rapidjson::Value &comp_data)
+    void UNIFACParameterLibrary::populate(rapidjson::Value &group_data, rapidjson::Value &interaction_data)
     {
-        if (CoolProp::get_config_bool(VTPR_ALWAYS_RELOAD_LIBRARY)){
-            groups.clear();
-            interaction_parameters.clear();
-            components.clear();
-        }
+        groups.clear(); group_index.clear();
+        interaction_parameters.clear(); interaction_index.clear();
         // Schema should have been used to validate the data already, so by this point we are can safely consume the data without checking ...
         for (rapidjson::Value::ValueIterator itr = group_data.Begin(); itr != group_data.End(); ++itr)
         {
@@ -29,6 +26,7 @@ namespace UNIFACLibrary{
             g.mgi = (*itr)["mgi"].GetInt();
             g.R_k = (*itr)["R_k"].GetDouble();
             g.Q_k = (*itr)["Q_k"].GetDouble();
+            group_index.insert(std::pair<int, std::size_t>(g.sgi, groups.size()));
             groups.push_back(g);
         }
         for (rapidjson::Value::ValueIterator itr = interaction_data.Begin(); itr != interaction_data.End(); ++itr)
@@ -42,66 +40,74 @@ namespace UNIFACLibrary{
             ip.b_ji = (*itr)["b_ji"].GetDouble();
             ip.c_ij = (*itr)["c_ij"].GetDouble();
             ip.c_ji = (*itr)["c_ji"].GetDouble();
+            interaction_index.insert(std::pair<std::pair<int, int>, std::size_t>(std::pair<int, int>(ip.mgi1, ip.mgi2), interaction_parameters.size()));
             interaction_parameters.push_back(ip);
         }
-        for (rapidjson::Value::ValueIterator itr = comp_data.Begin(); itr != comp_data.End(); ++itr)
+    }
+    Component UNIFACParameterLibrary::parse_component(rapidjson::Value &comp_data) const
+    {
+        Component c;
+        c.inchikey = comp_data["inchikey"].GetString();
+        c.registry_number = comp_data["registry_number"].GetString();
+        c.name = comp_data["name"].GetString();
+        c.Tc = comp_data["Tc"].GetDouble();
+        c.pc = comp_data["pc"].GetDouble();
+        c.acentric = comp_data["acentric"].GetDouble();
+        c.molemass = comp_data["molemass"].GetDouble();
+        // userid is an optional user identifier
+        if (comp_data.HasMember("userid")){
+            c.userid = comp_data["userid"].GetString();
+        }
+        // If provided, store information about the alpha function in use
+        if (comp_data.HasMember("alpha") && comp_data["alpha"].IsObject()){
+            rapidjson::Value &alpha = comp_data["alpha"];
+            c.alpha_type = cpjson::get_string(alpha, "type");
+            c.alpha_coeffs = cpjson::get_double_array(alpha, "c");
+        }
+        else{
+            c.alpha_type = "default";
+        }
+        if (comp_data.HasMember("alpha0") && comp_data["alpha0"].IsArray()) {
+            c.alpha0 = CoolProp::JSONFluidLibrary::parse_alpha0(comp_data["alpha0"]);
+        }
+        rapidjson::Value &groups = comp_data["groups"];
+        for (rapidjson::Value::ValueIterator itrg = groups.Begin(); itrg != groups.End(); ++itrg)
         {
-            Component c;
-            c.inchikey = (*itr)["inchikey"].GetString();
-            c.registry_number = (*itr)["registry_number"].GetString();
-            c.name = (*itr)["name"].GetString();
-            c.Tc = (*itr)["Tc"].GetDouble();
-            c.pc = (*itr)["pc"].GetDouble();
-            c.acentric = (*itr)["acentric"].GetDouble();
-            c.molemass = (*itr)["molemass"].GetDouble();
-            // userid is an optional user identifier
-            if ((*itr).HasMember("userid")){
-                c.userid = (*itr)["userid"].GetString();
-            }
-            // If provided, store information about the alpha function in use
-            if ((*itr).HasMember("alpha") && (*itr)["alpha"].IsObject()){
-                rapidjson::Value &alpha = (*itr)["alpha"];
-                c.alpha_type = cpjson::get_string(alpha, "type");
-                c.alpha_coeffs = cpjson::get_double_array(alpha, "c");
-            }
-            else{
-                c.alpha_type = "default";
+            int count = (*itrg)["count"].GetInt();
+            int sgi = (*itrg)["sgi"].GetInt();
+            if  (has_group(sgi)){
+                ComponentGroup cg(count, get_group(sgi));
+                c.groups.push_back(cg);
             }
-            if ((*itr).HasMember("alpha0") && (*itr)["alpha0"].IsArray()) {
-                c.alpha0 = CoolProp::JSONFluidLibrary::parse_alpha0((*itr)["alpha0"]);
-            }
-            rapidjson::Value &groups = (*itr)["groups"];
-            for (rapidjson::Value::ValueIterator itrg = groups.Begin(); itrg != groups.End(); ++itrg)
-            {
-                int count = (*itrg)["count"].GetInt();
-                int sgi = (*itrg)["sgi"].GetInt();
-                if  (has_group(sgi)){
-                    ComponentGroup cg(count, get_group(sgi));
-                    c.groups.push_back(cg);
-                }
-            }
-            components.push_back(c);
         }
+        return c;
     }
     void UNIFACParameterLibrary::populate(std::string &group_data, std::string &interaction_data, std::string &decomp_data)
     {
         rapidjson::Document group_JSON; jsonize(group_data, group_JSON);
         rapidjson::Document interaction_JSON; jsonize(interaction_data, interaction_JSON);
-        rapidjson::Document decomp_JSON; jsonize(decomp_data, decomp_JSON);
-        populate(group_JSON, interaction_JSON, decomp_JSON);
+        shared_ptr<rapidjson::Document> decomp_JSON(new rapidjson::Document()); jsonize(decomp_data, *decomp_JSON);
+        populate(group_JSON, interaction_JSON);
+
+        // Only index the components by name; they are converted when they are first requested
+        std::lock_guard<std::mutex> lock(components_mutex);
+        component_data = decomp_JSON;
+        component_index.clear();
+        std::size_t i = 0;
+        for (rapidjson::Value::ValueIterator itr = component_data->Begin(); itr != component_data->End(); ++itr, ++i)
+        {
+            component_index.insert(std::pair<std::string, std::size_t>((*itr)["name"].GetString(), i));
+        }
+        components.assign(i, shared_ptr<Component>());
         m_populated = true;
     }
     Group UNIFACParameterLibrary::get_group(int sgi) const {
-        for (std::vector<Group>::const_iterator it = groups.begin(); it != groups.end(); ++it) {
-            if (it->sgi == sgi) { return *it; }
-        }
+        std::map<int, std::size_t>::const_iterator it = group_index.find(sgi);
+        if (it != group_index.end()) { return groups[it->second]; }
         throw CoolProp::ValueError("Could not find group");
     }
     bool UNIFACParameterLibrary::has_group(int sgi) const {
-        for (std::vector<Group>::const_iterator it = groups.begin(); it != groups.end(); ++it) {
-            if (it->sgi == sgi) { return true; }
-        }
-        return false;
+        return group_index.find(sgi) != group_index.end();
     }
 
     InteractionParameters UNIFACParameterLibrary::get_interaction_parameters(int mgi1, int mgi2) const {
@@ -112,30 +118,58 @@ namespace UNIFACLibrary{
             ip.zero_out();
             return ip;
         }
-        for (std::vector<InteractionParameters>::const_iterator it = interaction_parameters.begin(); it != interaction_parameters.end(); ++it) {
-            if (it->mgi1 == mgi1 && it->mgi2 == mgi2) {
-                // Correct order, return it
-                return *it;
-            }
-            if (it->mgi2 == mgi1 && it->mgi1 == mgi2) {
-                // Backwards, swap the parameters
-                InteractionParameters ip = *it;
-                ip.swap();
-                return ip;
-            }
+        // If the pair is stored in both orders, the one that comes first in the library is used
+        std::map<std::pair<int, int>, std::size_t>::const_iterator it = interaction_index.find(std::pair<int, int>(mgi1, mgi2)),
+                                                                   itback = interaction_index.find(std::pair<int, int>(mgi2, mgi1));
+        if (it != interaction_index.end() && (itback == interaction_index.end() || it->second < itback->second)) {
+            // Correct order, return it
+            return interaction_parameters[it->second];
+        }
+        if (itback != interaction_index.end()) {
+            // Backwards, swap the parameters
+            InteractionParameters ip = interaction_parameters[itback->second];
+            ip.swap();
+            return ip;
         }
         throw CoolProp::ValueError(format("Could not find interaction between pair mgi[%d]-mgi[%d]", static_cast<int>(mgi1), static_cast<int>(mgi2)));
     }
 
     Component UNIFACParameterLibrary::get_component(const std::string &identifier, const std::string &value) const {
         if (identifier == "name"){
-            for (std::vector<Component>::const_iterator it = components.begin(); it != components.end(); ++it ){
-                if (it->name == value ){ return *it; }
+            std::lock_guard<std::mutex> lock(components_mutex);
+            std::map<std::string, std::size_t>::const_iterator it = component_index.find(value);
+            if (it != component_index.end()){
+                shared_ptr<Component> &c = components[it->second];
+                if (!c){
+                    c.reset(new Component(parse_component((*component_data)[static_cast<rapidjson::SizeType>(it->second)])));
+                }
+                return *c;
             }
         }
         throw CoolProp::ValueError(format("Could not find component: %s with identifier: %s", value.c_str(), identifier.c_str()));
     }
 
+    std::size_t UNIFACParameterLibrary::heap_bytes() const {
+        std::size_t bytes = CoolProp::heap_bytes(groups) + CoolProp::heap_bytes(interaction_parameters)
+                          + CoolProp::map_node_bytes(group_index) + CoolProp::map_node_bytes(interaction_index) + CoolProp::map_node_bytes(component_index);
+        for (std::map<std::string, std::size_t>::const_iterator it = component_index.begin(); it != component_index.end(); ++it){
+            bytes += CoolProp::heap_bytes(it->first);
+        }
+        if (component_data){
+            bytes += sizeof(rapidjson::Document) + component_data->GetAllocator().Capacity();
+        }
+        std::lock_guard<std::mutex> lock(components_mutex);
+        bytes += CoolProp::heap_bytes(components);
+        for (std::size_t i = 0; i < components.size(); ++i){
+            const shared_ptr<Component> &c = components[i];
+            if (!c){ continue; }
+            bytes += sizeof(Component) + CoolProp::heap_bytes(c->name) + CoolProp::heap_bytes(c->inchikey) + CoolProp::heap_bytes(c->registry_number)
+                   + CoolProp::heap_bytes(c->userid) + CoolProp::heap_bytes(c->groups) + CoolProp::heap_bytes(c->alpha_type)
+                   + CoolProp::heap_bytes(c->alpha_coeffs) + c->alpha0.heap_bytes();
+        }
+        return bytes;
+    }
+
 }; /* namespace UNIFACLibrary */
 
 #if defined(ENABLE_CATCH)
@@ -177,6 +211,71 @@ TEST_CASE("Check Poling example for UNIFAC", "[UNIFAC]")
         CHECK(std::abs(gamma[0] - 4.99) < 1e-2);
         CHECK(std::abs(gamma[1] - 1.005) < 1e-3);
     };
+    SECTION("Cached values follow changes of the composition and the parameters") {
+        UNIFACLibrary::UNIFACParameterLibrary lib;
+        lib.populate(groups, interactions, acetone_pentane_groups);
+        std::vector<std::string> names; names.push_back("Acetone"); names.push_back("n-Pentane");
+        UNIFAC::UNIFACMixture mix(lib,1.0), fresh(lib,1.0);
+        mix.set_components("name",names);
+        mix.set_interaction_parameters();
+        fresh.set_components("name",names);
+        fresh.set_interaction_parameters();
+
+        std::vector<double> z1(2,0.047), z2(2,0.5); z1[1] = 1-z1[0];
+        mix.set_mole_fractions(z1);
+        double lngammaR0 = mix.ln_gamma_R(1.0/307,0,0), dlngammaR0_dtau = mix.ln_gamma_R(1.0/307,0,1);
+        mix.set_mole_fractions(z2);
+        CHECK(mix.ln_gamma_R(1.0/307,0,0) != lngammaR0);
+        mix.set_mole_fractions(z1);
+        CHECK(mix.ln_gamma_R(1.0/307,0,0) == lngammaR0);
+        CHECK(mix.ln_gamma_R(1.0/307,0,1) == dlngammaR0_dtau);
+
+        mix.set_interaction_parameter(1, 9, "aij", 500);
+        fresh.set_interaction_parameter(1, 9, "aij", 500);
+        fresh.set_mole_fractions(z1);
+        CHECK(mix.ln_gamma_R(1.0/307,0,0) != lngammaR0);
+        CHECK(mix.ln_gamma_R(1.0/307,0,0) == fresh.ln_gamma_R(1.0/307,0,0));
+        CHECK(mix.ln_gamma_R(1.0/307,1,1) == fresh.ln_gamma_R(1.0/307,1,1));
+
+        mix.set_Q_k(18, 1.5);
+        fresh.set_Q_k(18, 1.5);
+        CHECK(mix.ln_gamma_R(1.0/307,0,0) == fresh.ln_gamma_R(1.0/307,0,0));
+    };
 };
 
+TEST_CASE("Indexed lookups in the UNIFAC parameter library", "[UNIFAC]")
+{
+    std::string components = "[{ \"Tc\": 508.1, \"acentric\": 0.3071, \"groups\": [ { \"count\": 1,  \"sgi\": 1 },  {\"count\": 1, \"sgi\": 18 }, {\"count\": 1, \"sgi\": 99 } ],  \"molemass\": 0.05808, \"inchikey\": \"?\",  \"name\": \"Acetone\", \"pc\": 4700000.0, \"registry_number\": \"67-64-1\" },"
+                             "{ \"Tc\": 1, \"acentric\": 0, \"groups\": [], \"molemass\": 1, \"inchikey\": \"?\", \"name\": \"Acetone\", \"pc\": 1, \"registry_number\": \"\" }]";
+    std::string groups = "[{\"Q_k\": 0.848, \"R_k\": 0.9011, \"maingroup_name\": \"CH2\", \"mgi\": 1, \"sgi\": 1, \"subgroup_name\": \"CH3\"},"
+        "{\"Q_k\": 1.488, \"R_k\": 1.6724, \"maingroup_name\": \"CH2CO\", \"mgi\": 9, \"sgi\": 18, \"subgroup_name\": \"CH3CO\"}]";
+    std::string interactions = "[{\"a_ij\": 476.4, \"a_ji\": 26.76, \"b_ij\": 1.0, \"b_ji\": 2.0,  \"c_ij\": 3.0, \"c_ji\": 4.0, \"mgi1\": 1, \"mgi2\": 9}]";
+    UNIFACLibrary::UNIFACParameterLibrary lib;
+    // Populating twice replaces the contents rather than adding to them
+    lib.populate(groups, interactions, components);
+    lib.populate(groups, interactions, components);
+
+    CHECK(lib.has_group(18));
+    CHECK(!lib.has_group(2));
+    CHECK(lib.get_group(18).mgi == 9);
+    CHECK_THROWS(lib.get_group(2));
+
+    UNIFACLibrary::InteractionParameters ip = lib.get_interaction_parameters(1, 9), ipback = lib.get_interaction_parameters(9, 1);
+    CHECK(ip.a_ij == 476.4);
+    CHECK(ip.c_ji == 4.0);
+    CHECK(ipback.a_ij == 26.76);
+    CHECK(ipback.b_ji == 1.0);
+    CHECK(lib.get_interaction_parameters(9, 9).a_ij == 0);
+    CHECK_THROWS(lib.get_interaction_parameters(1, 2));
+
+    // The first component with a given name is used, and the unknown groups are skipped
+    UNIFACLibrary::Component c = lib.get_component("name", "Acetone");
+    CHECK(c.Tc == 508.1);
+    REQUIRE(c.groups.size() == 2);
+    CHECK(c.groups[1].group.sgi == 18);
+    CHECK(lib.get_component("name", "Acetone").molemass == c.molemass);
+    CHECK_THROWS(lib.get_component("name", "Water"));
+    CHECK_THROWS(lib.get_component("inchikey", "?"));
+}
+
 #endif
@@ -2,10 +2,13 @@
 #define UNIFAC_LIBRARY_H
 
 #include <vector>
+#include <map>
 #include <exception>
+#include <mutex>
 
 #include "rapidjson_include.h"
 #include "CoolPropFluid.h"
+#include "crossplatform_shared_ptr.h"
 
 namespace UNIFACLibrary{
 
@@ -72,19 +75,31 @@ namespace UNIFACLibrary{
      * 
      * Input of parameters (population) is done using JSON-formatted strings, and the class can be interrogated to return
      * the desired group information and/or interaction parameters
+     *
+     * Groups and interaction parameters are indexed by sgi and by mgi-mgi pair when the library is populated.  The components
+     * are only indexed by name then, and each one is converted from JSON the first time it is requested.
      */
     struct UNIFACParameterLibrary{
     private:
         bool m_populated; ///< True if the library has been populated
         std::vector<Group> groups; ///< The collection of groups forming the component from the group decomposition
         std::vector<InteractionParameters> interaction_parameters; ///< The collection of interaction parameters between main groups in the library
-        std::vector<Component> components; ///< The collection of components that are included in this library
+        std::map<int, std::size_t> group_index; ///< Map from sgi to the first group in groups with this sgi
+        std::map<std::pair<int, int>, std::size_t> interaction_index; ///< Map from (mgi1, mgi2) to the first parameters in interaction_parameters stored in this order
+
+        shared_ptr<rapidjson::Document> component_data; ///< The JSON array of the components in this library
+        std::map<std::string, std::size_t> component_index; ///< Map from name to the first component in component_data with this name
+        mutable std::vector<shared_ptr<Component> > components; ///< The components that have been converted from JSON; NULL until requested
+        mutable std::mutex components_mutex; ///< Serializes the conversion of the components
 
         /// Convert string to JSON document
         void jsonize(std::string &s, rapidjson::Document &doc);
 
         /// Populate internal data structures based on rapidjson Documents
-        void populate(rapidjson::Value &group_data, rapidjson::Value &interaction_data, rapidjson::Value &decomp_data);
+        void populate(rapidjson::Value &group_data, rapidjson::Value &interaction_data);
+
+        /// Convert one component from its JSON description
+        Component parse_component(rapidjson::Value &comp_data) const;
 
     public:
         UNIFACParameterLibrary() : m_populated(false) {};
@@ -106,6 +121,9 @@ namespace UNIFACLibrary{
         
         /// Get the interaction parameters for given mgi-mgi pair
         InteractionParameters get_interaction_parameters(int mgi1, int mgi2) const;
+
+        /// The bytes used by the parameters, the JSON of the components and the components converted from it
+        std::size_t heap_bytes() const;
     };
 
 }; /* namespace UNIFACLibrary*/
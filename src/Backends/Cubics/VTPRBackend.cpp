@@ -4,12 +4,34 @@
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include <map>
+#include <mutex>
 
 #include "VTPRBackend.h"
 #include "Configuration.h"
 #include "Exceptions.h"
 
-static UNIFACLibrary::UNIFACParameterLibrary lib;
+/// A UNIFAC library loaded from one VTPR_UNIFAC_PATH, and the contents of the files it was populated from
+struct LoadedUNIFACLibrary {
+    std::string groups, interaction, decomps;
+    shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> lib;
+};
+/// The latest library loaded from each path; a library is shared by the VTPR instances built with it and lives as long as they do
+static std::map<std::string, LoadedUNIFACLibrary> UNIFAC_libraries;
+static std::mutex UNIFAC_libraries_mutex;
+
+std::size_t CoolProp::get_UNIFAC_library_bytes(){
+    std::lock_guard<std::mutex> lock(UNIFAC_libraries_mutex);
+    std::size_t bytes = CoolProp::map_node_bytes(UNIFAC_libraries);
+    for (std::map<std::string, LoadedUNIFACLibrary>::const_iterator it = UNIFAC_libraries.begin(); it != UNIFAC_libraries.end(); ++it){
+        const LoadedUNIFACLibrary &loaded = it->second;
+        bytes += CoolProp::heap_bytes(it->first) + CoolProp::heap_bytes(loaded.groups) + CoolProp::heap_bytes(loaded.interaction) + CoolProp::heap_bytes(loaded.decomps);
+        if (loaded.lib){
+            bytes += sizeof(UNIFACLibrary::UNIFACParameterLibrary) + loaded.lib->heap_bytes();
+        }
+    }
+    return bytes;
+}
 
 void CoolProp::VTPRBackend::setup(const std::vector<std::string> &names, bool generate_SatL_and_SatV){
 
@@ -104,6 +126,8 @@ CoolPropDbl CoolProp::VTPRBackend::calc_molar_mass(void)
 }
 
 void CoolProp::VTPRBackend::set_binary_interaction_double(const std::size_t i, const std::size_t j, const std::string &parameter, const double value) {
+    clear_critical_points_cache();
+    clear_saturation_cache();
     cubic->set_interaction_parameter(i, j, parameter, value);
     for (std::vector<shared_ptr<HelmholtzEOSMixtureBackend> >::iterator it = linked_states.begin(); it != linked_states.end(); ++it) {
         (*it)->set_binary_interaction_double(i, j, parameter, value);
@@ -111,6 +135,8 @@ void CoolProp::VTPRBackend::set_binary_interaction_double(const std::size_t i, c
 };
 
 void CoolProp::VTPRBackend::set_Q_k(const size_t sgi, const double value) {
+    clear_critical_points_cache();
+    clear_saturation_cache();
     cubic->set_Q_k(sgi, value);
 };
 
@@ -118,24 +144,35 @@ double CoolProp::VTPRBackend::get_binary_interaction_double(const std::size_t i,
     return cubic->get_interaction_parameter(i, j, parameter);
 };
 
-const UNIFACLibrary::UNIFACParameterLibrary & CoolProp::VTPRBackend::LoadLibrary(){
-    if (!lib.is_populated() || get_config_bool(VTPR_ALWAYS_RELOAD_LIBRARY)){
-        std::string UNIFAC_path = get_config_string(VTPR_UNIFAC_PATH);
-        if (UNIFAC_path.empty()){
-            throw ValueError("You must provide the path to the UNIFAC library files as VTPR_UNIFAC_PATH");
-        }
-        if (!(UNIFAC_path[UNIFAC_path.size()-1] == '\\' || UNIFAC_path[UNIFAC_path.size()-1] == '/')){
-            throw ValueError("VTPR_UNIFAC_PATH must end with / or \\ character");
-        }
-        std::string group_path = UNIFAC_path + "group_data.json";
-        std::string groups = get_file_contents(group_path.c_str());
-        std::string interaction_path = UNIFAC_path + "interaction_parameters.json";
-        std::string interaction = get_file_contents(interaction_path.c_str());
-        std::string decomps_path = UNIFAC_path + "decompositions.json";
-        std::string decomps = get_file_contents(decomps_path.c_str());
-        lib.populate(groups, interaction, decomps);
+shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> CoolProp::VTPRBackend::LoadLibrary(){
+    std::string UNIFAC_path = get_config_string(VTPR_UNIFAC_PATH);
+    if (UNIFAC_path.empty()){
+        throw ValueError("You must provide the path to the UNIFAC library files as VTPR_UNIFAC_PATH");
+    }
+    if (!(UNIFAC_path[UNIFAC_path.size()-1] == '\\' || UNIFAC_path[UNIFAC_path.size()-1] == '/')){
+        throw ValueError("VTPR_UNIFAC_PATH must end with / or \\ character");
+    }
+    std::lock_guard<std::mutex> lock(UNIFAC_libraries_mutex);
+    LoadedUNIFACLibrary &loaded = UNIFAC_libraries[UNIFAC_path];
+    if (loaded.lib && !get_config_bool(VTPR_ALWAYS_RELOAD_LIBRARY)){
+        return loaded.lib;
+    }
+    std::string group_path = UNIFAC_path + "group_data.json";
+    std::string groups = get_file_contents(group_path.c_str());
+    std::string interaction_path = UNIFAC_path + "interaction_parameters.json";
+    std::string interaction = get_file_contents(interaction_path.c_str());
+    std::string decomps_path = UNIFAC_path + "decompositions.json";
+    std::string decomps = get_file_contents(decomps_path.c_str());
+    // When reloading, only parse the files again if they have changed
+    if (loaded.lib && groups == loaded.groups && interaction == loaded.interaction && decomps == loaded.decomps){
+        return loaded.lib;
     }
-    return lib;
+    // A changed library is built as a new object; the existing VTPR instances hold the old one, which is never modified
+    shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> lib(new UNIFACLibrary::UNIFACParameterLibrary());
+    lib->populate(groups, interaction, decomps);
+    loaded.lib = lib;
+    loaded.groups = groups; loaded.interaction = interaction; loaded.decomps = decomps;
+    return loaded.lib;
 }
 
 CoolPropDbl CoolProp::VTPRBackend::calc_fugacity_coefficient(std::size_t i){
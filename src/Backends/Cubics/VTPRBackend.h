@@ -39,10 +39,20 @@ public:
 		const std::vector<double> &acentric,
 		double R_u,
 		bool generate_SatL_and_SatV = true) {
-		const UNIFACLibrary::UNIFACParameterLibrary & lib = LoadLibrary();
-		cubic.reset(new VTPRCubic(Tc, pc, acentric, R_u, lib));
+		cubic.reset(new VTPRCubic(Tc, pc, acentric, R_u, LoadLibrary()));
 		setup(fluid_identifiers, generate_SatL_and_SatV);
 	};
+    /// Build an instance that uses the given UNIFAC library rather than loading it; used for the copies of an instance
+    VTPRBackend(const std::vector<std::string> fluid_identifiers,
+                const std::vector<double> &Tc,
+                const std::vector<double> &pc,
+                const std::vector<double> &acentric,
+                double R_u,
+                const shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> &lib,
+                bool generate_SatL_and_SatV = true) {
+        cubic.reset(new VTPRCubic(Tc, pc, acentric, R_u, lib));
+        setup(fluid_identifiers, generate_SatL_and_SatV);
+    };
     VTPRBackend(const std::vector<std::string> fluid_identifiers,
                 const double R_u = get_config_double(R_U_CODATA),
                 bool generate_SatL_and_SatV = true)
@@ -51,9 +61,9 @@ public:
         N = fluid_identifiers.size();
         components.resize(N);
         // Extract data from the UNIFAC parameter library
-        const UNIFACLibrary::UNIFACParameterLibrary & lib = LoadLibrary();
+        shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> lib = LoadLibrary();
         for (std::size_t i = 0; i < fluid_identifiers.size(); ++i){
-            UNIFACLibrary::Component comp = lib.get_component("name", fluid_identifiers[i]);
+            UNIFACLibrary::Component comp = lib->get_component("name", fluid_identifiers[i]);
             Tc.push_back(comp.Tc); // [K]
             pc.push_back(comp.pc); // [Pa]
             acentric.push_back(comp.acentric); // [-]
@@ -66,7 +76,8 @@ public:
     std::string backend_name(void) { return get_backend_string(VTPR_BACKEND); }
 
     HelmholtzEOSMixtureBackend * get_copy(bool generate_SatL_and_SatV = true){
-        AbstractCubicBackend * ACB = new VTPRBackend(calc_fluid_names(),cubic->get_Tc(),cubic->get_pc(),cubic->get_acentric(),cubic->get_R_u(),generate_SatL_and_SatV);
+        const shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> &lib = static_cast<VTPRCubic *>(cubic.get())->get_library();
+        AbstractCubicBackend * ACB = new VTPRBackend(calc_fluid_names(),cubic->get_Tc(),cubic->get_pc(),cubic->get_acentric(),cubic->get_R_u(),lib,generate_SatL_and_SatV);
         ACB->copy_k(this); ACB->copy_all_alpha_functions(this);
         return static_cast<HelmholtzEOSMixtureBackend *>(ACB);
     }
@@ -79,8 +90,8 @@ public:
     /// Set the pointer to the residual helmholtz class, etc.
     void setup(const std::vector<std::string> &names, bool generate_SatL_and_SatV = true);
     
-    /// Load the UNIFAC library if needed and get const reference to it
-    const UNIFACLibrary::UNIFACParameterLibrary &LoadLibrary();
+    /// Load the UNIFAC library if needed and get a pointer to it; a reloaded library replaces the shared one and the existing instances keep the old one
+    shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> LoadLibrary();
     
     void set_mole_fractions(const std::vector<double> &z){
         mole_fractions = z;
@@ -104,6 +115,9 @@ public:
     void set_Q_k(const size_t sgi, const double value);
     
 };
+
+/// The bytes used by the UNIFAC parameter libraries that have been loaded by the VTPR backend, and by the files they were loaded from
+std::size_t get_UNIFAC_library_bytes();
     
 }; /* namespace CoolProp */
 
@@ -15,25 +15,28 @@
 class VTPRCubic : public PengRobinson
 {
 private:
+    shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> library; ///< The UNIFAC library; held so that it outlives \ref unifaq
     UNIFAC::UNIFACMixture unifaq;
 public:
     VTPRCubic(std::vector<double> Tc,
         std::vector<double> pc,
         std::vector<double> acentric,
         double R_u,
-        const UNIFACLibrary::UNIFACParameterLibrary & lib
+        const shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> & lib
     )
-        : PengRobinson(Tc, pc, acentric, R_u), unifaq(lib,T_r) {};
+        : PengRobinson(Tc, pc, acentric, R_u), library(lib), unifaq(*lib,T_r) {};
 
     VTPRCubic(double Tc,
         double pc,
         double acentric,
         double R_u,
-        const UNIFACLibrary::UNIFACParameterLibrary & lib)
-        : PengRobinson(std::vector<double>(1, Tc), std::vector<double>(1, pc), std::vector<double>(1, acentric), R_u), unifaq(lib,T_r) {};
+        const shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> & lib)
+        : PengRobinson(std::vector<double>(1, Tc), std::vector<double>(1, pc), std::vector<double>(1, acentric), R_u), library(lib), unifaq(*lib,T_r) {};
 
     /// Get a reference to the managed UNIFAC instance
     UNIFAC::UNIFACMixture &get_unifaq() { return unifaq; }
+    /// Get the UNIFAC library this instance was built with
+    const shared_ptr<UNIFACLibrary::UNIFACParameterLibrary> &get_library() { return library; }
 
     /// Calculate the non-dimensionalized gE/RT term
     double gE_R_RT(double tau, const std::vector<double> &x, std::size_t itau) {
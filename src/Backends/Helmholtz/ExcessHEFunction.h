@@ -29,6 +29,8 @@ public:
     DepartureFunction *copy_ptr(){
         return new DepartureFunction(phi);
     }
+    /// The bytes allocated by the coefficients of the departure function
+    std::size_t heap_bytes() const { return phi.heap_bytes(); }
 
     virtual void update(double tau, double delta){
         derivs.reset(0.0);
@@ -210,6 +212,29 @@ public:
         return _term;
     }
 
+    /// The bytes allocated by this term, including the departure functions and their cached derivatives
+    std::size_t heap_bytes() const {
+        std::size_t bytes = CoolProp::heap_bytes(F) + CoolProp::heap_bytes(DepartureFunctionMatrix);
+        for (std::size_t i = 0; i < DepartureFunctionMatrix.size(); ++i){
+            for (std::size_t j = 0; j < DepartureFunctionMatrix[i].size(); ++j){
+                if (DepartureFunctionMatrix[i][j].get() != NULL){
+                    bytes += sizeof(DepartureFunction) + DepartureFunctionMatrix[i][j]->heap_bytes();
+                }
+            }
+        }
+        return bytes;
+    }
+    /// The bytes of the derivatives cached in the departure functions, which are part of heap_bytes()
+    std::size_t cached_bytes() const {
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < DepartureFunctionMatrix.size(); ++i){
+            for (std::size_t j = 0; j < DepartureFunctionMatrix[i].size(); ++j){
+                if (DepartureFunctionMatrix[i][j].get() != NULL){ bytes += sizeof(HelmholtzDerivatives); }
+            }
+        }
+        return bytes;
+    }
+
     /// Resize the parts of this term
     void resize(std::size_t N){
         this->N = N;
@@ -3,6 +3,7 @@
 #include "HelmholtzEOSMixtureBackend.h"
 #include "HelmholtzEOSBackend.h"
 #include "PhaseEnvelopeRoutines.h"
+#include "HSFlashGuessMap.h"
 #include "Configuration.h"
 
 #if defined(ENABLE_CATCH)
@@ -295,7 +296,7 @@ void FlashRoutines::HQ_flash(HelmholtzEOSMixtureBackend &HEOS, CoolPropDbl Tgues
     SaturationSolvers::saturation_PHSU_pure_options options;
     options.use_logdelta = false;
     HEOS.specify_phase(iphase_twophase);
-    if (Tguess < 0){
+    if (Tguess > 0){
         options.use_guesses = true;
         options.T = Tguess;
         CoolProp::SaturationAncillaryFunction &rhoL = HEOS.get_components()[0].ancillaries.rhoL;
@@ -462,7 +463,7 @@ void FlashRoutines::QT_flash(HelmholtzEOSMixtureBackend &HEOS)
             // Newton-Raphson
             // -----
             
-            SaturationSolvers::newton_raphson_saturation NR;
+            SaturationSolvers::newton_raphson_saturation &NR = HEOS.get_VLE_workspace().saturation;
             SaturationSolvers::newton_raphson_saturation_options IO;
             
             IO.bubble_point = (HEOS._Q < 0.5);
@@ -680,7 +681,7 @@ void FlashRoutines::PQ_flash(HelmholtzEOSMixtureBackend &HEOS)
             // Newton-Raphson
             // -----
             
-            SaturationSolvers::newton_raphson_saturation NR;
+            SaturationSolvers::newton_raphson_saturation &NR = HEOS.get_VLE_workspace().saturation;
             SaturationSolvers::newton_raphson_saturation_options IO;
             
             IO.bubble_point = (HEOS._Q < 0.5);
@@ -714,7 +715,7 @@ void FlashRoutines::PQ_flash(HelmholtzEOSMixtureBackend &HEOS)
 
 void FlashRoutines::PQ_flash_with_guesses(HelmholtzEOSMixtureBackend &HEOS, const GuessesStructure &guess)
 {
-	SaturationSolvers::newton_raphson_saturation NR;
+	SaturationSolvers::newton_raphson_saturation &NR = HEOS.get_VLE_workspace().saturation;
     SaturationSolvers::newton_raphson_saturation_options IO;
 	IO.rhomolar_liq = guess.rhomolar_liq;
 	IO.rhomolar_vap = guess.rhomolar_vap;
@@ -744,7 +745,7 @@ void FlashRoutines::PQ_flash_with_guesses(HelmholtzEOSMixtureBackend &HEOS, cons
 }
 void FlashRoutines::QT_flash_with_guesses(HelmholtzEOSMixtureBackend &HEOS, const GuessesStructure &guess)
 {
-    SaturationSolvers::newton_raphson_saturation NR;
+    SaturationSolvers::newton_raphson_saturation &NR = HEOS.get_VLE_workspace().saturation;
     SaturationSolvers::newton_raphson_saturation_options IO;
     IO.rhomolar_liq = guess.rhomolar_liq;
     IO.rhomolar_vap = guess.rhomolar_vap;
@@ -805,6 +806,228 @@ void FlashRoutines::PT_flash_with_guesses(HelmholtzEOSMixtureBackend &HEOS, cons
     HEOS._Q = -1;
 }
 
+/// The vapor quality of a two-phase state of a pure fluid with the given value of Q, rhomolar, hmolar, smolar or umolar, from the saturated states
+static CoolPropDbl twophase_quality(HelmholtzEOSMixtureBackend &HEOS, parameters key, CoolPropDbl value)
+{
+    if (key == iQ){ return value; }
+    if (key == iDmolar){ return (1/value - 1/HEOS.SatL->rhomolar())/(1/HEOS.SatV->rhomolar() - 1/HEOS.SatL->rhomolar()); }
+    CoolPropDbl yL = HEOS.SatL->keyed_output(key), yV = HEOS.SatV->keyed_output(key);
+    return (value - yL)/(yV - yL);
+}
+
+void FlashRoutines::singlephase_Newton_Trho(HelmholtzEOSMixtureBackend &HEOS, parameters key1, CoolPropDbl value1, parameters key2, CoolPropDbl value2, CoolPropDbl T0, CoolPropDbl rhomolar0)
+{
+    std::vector<parameters> keys(2);
+    keys[0] = key1; keys[1] = key2;
+    CoolPropDbl T = T0, rhomolar = rhomolar0;
+    for (int iter = 0; iter < 30; ++iter)
+    {
+        HEOS.update_DmolarT_direct(rhomolar, T);
+        // The properties are those of the homogeneous state at T and rho; the phase is determined by the caller
+        HEOS._phase = iphase_gas;
+        CoolPropDbl r1 = HEOS.keyed_output(key1) - value1, r2 = HEOS.keyed_output(key2) - value2;
+        
+        // Derivatives of the inputs with respect to T and rho, and the Newton step
+        StateDerivatives derivs = HEOS.state_derivatives(keys);
+        CoolPropDbl det = derivs.dX[0]*derivs.dY[1] - derivs.dY[0]*derivs.dX[1];
+        CoolPropDbl dT = (r1*derivs.dY[1] - r2*derivs.dY[0])/det;
+        CoolPropDbl drhomolar = (r2*derivs.dX[0] - r1*derivs.dX[1])/det;
+        if (!ValidNumber(dT) || !ValidNumber(drhomolar)){
+            throw SolutionError(format("Invalid step in singlephase_Newton_Trho for %s=%Lg and %s=%Lg", get_parameter_information(key1,"short").c_str(), value1, get_parameter_information(key2,"short").c_str(), value2));
+        }
+        T -= dT;
+        rhomolar -= drhomolar;
+        if (T <= 0 || rhomolar <= 0){
+            throw SolutionError(format("singlephase_Newton_Trho left the domain with T=%Lg and rhomolar=%Lg", T, rhomolar));
+        }
+        if (std::abs(dT) < 1e-12*T && std::abs(drhomolar) < 1e-12*rhomolar){
+            HEOS.update_DmolarT_direct(rhomolar, T);
+            HEOS._phase = iphase_gas;
+            return;
+        }
+    }
+    throw SolutionError(format("singlephase_Newton_Trho did not converge for %s=%Lg and %s=%Lg", get_parameter_information(key1,"short").c_str(), value1, get_parameter_information(key2,"short").c_str(), value2));
+}
+
+bool FlashRoutines::continuation_flash(HelmholtzEOSMixtureBackend &HEOS, input_pairs input_pair, CoolPropDbl value1, CoolPropDbl value2, const ContinuationState &previous)
+{
+    switch (input_pair)
+    {
+        case PT_INPUTS: case DmolarT_INPUTS: case SmolarT_INPUTS: case DmolarP_INPUTS:
+        case DmolarHmolar_INPUTS: case DmolarSmolar_INPUTS: case DmolarUmolar_INPUTS:
+        case HmolarP_INPUTS: case PSmolar_INPUTS: case PUmolar_INPUTS: case HmolarSmolar_INPUTS:
+        case QT_INPUTS: case PQ_INPUTS:
+            break;
+        default:
+            // The other pairs are left to the normal update, which reports whether they are supported
+            return false;
+    }
+    parameters key1, key2;
+    split_input_pair(input_pair, key1, key2);
+    
+    if (previous.phase != iphase_twophase){
+        if (key1 == iQ || key2 == iQ){ return false; }
+        return continuation_flash_singlephase(HEOS, key1, value1, key2, value2, previous);
+    }
+    else if (HEOS.is_pure_or_pseudopure){
+        // The ancillaries are the saturation curve of pseudo-pure fluids
+        if (HEOS.components[0].EOS().pseudo_pure){ return false; }
+        return continuation_flash_twophase_pure(HEOS, key1, value1, key2, value2, previous.guesses);
+    }
+    else{
+        // Bubble- and dew-points of mixtures, with the same quality as the previous solution
+        if (input_pair != PQ_INPUTS && input_pair != QT_INPUTS){ return false; }
+        CoolPropDbl Q = (input_pair == PQ_INPUTS) ? value2 : value1;
+        if (std::abs(Q - previous.Q) > 1e-10 || (std::abs(Q) > 1e-10 && std::abs(Q - 1) > 1e-10)){ return false; }
+        
+        // The incipient phase composition is obtained from the K-factors of the previous solution
+        const std::vector<CoolPropDbl> &z = HEOS.mole_fractions;
+        const std::vector<double> &x = previous.guesses.x, &y = previous.guesses.y;
+        if (x.size() != z.size() || y.size() != z.size()){ return false; }
+        GuessesStructure guesses = previous.guesses;
+        std::vector<double> &bulk = (Q < 0.5) ? guesses.x : guesses.y,
+                            &incipient = (Q < 0.5) ? guesses.y : guesses.x;
+        double summer = 0;
+        for (std::size_t j = 0; j < z.size(); ++j){
+            incipient[j] = (Q < 0.5) ? y[j]/x[j]*z[j] : z[j]*x[j]/y[j];
+            summer += incipient[j];
+        }
+        for (std::size_t j = 0; j < z.size(); ++j){ incipient[j] /= summer; }
+        bulk.assign(z.begin(), z.end());
+        
+        if (input_pair == PQ_INPUTS){
+            HEOS._p = value1; HEOS._Q = value2;
+            PQ_flash_with_guesses(HEOS, guesses);
+        }
+        else{
+            HEOS._Q = value1; HEOS._T = value2;
+            QT_flash_with_guesses(HEOS, guesses);
+        }
+        return true;
+    }
+}
+
+bool FlashRoutines::continuation_flash_singlephase(HelmholtzEOSMixtureBackend &HEOS, parameters key1, CoolPropDbl value1, parameters key2, CoolPropDbl value2, const ContinuationState &previous)
+{
+    singlephase_Newton_Trho(HEOS, key1, value1, key2, value2, previous.guesses.T, previous.guesses.rhomolar);
+    CoolPropDbl T = HEOS._T, rhomolar = HEOS._rhomolar, p = HEOS._p;
+    
+    if (HEOS.is_pure_or_pseudopure){
+        // States beyond the limits are left to the normal flash routines
+        if (T < HEOS.Tmin() || T > 1.5*HEOS.Tmax()){ return false; }
+        if (T < HEOS.calc_Tmax_sat()){
+            // Below the critical temperature, the state must be far enough from the saturation curve that the ancillaries 
+            // can tell it is stable, with the same pressure margins as in T_phase_determination_pure_or_pseudopure.
+            // This rejects the metastable states; the unstable states inside the saturation dome have dp/drho < 0.
+            CoolPropFluid &component = HEOS.components[0];
+            CoolPropDbl pL = component.ancillaries.pL.evaluate(T), pV = component.ancillaries.pV.evaluate(T);
+            if (!(HEOS.first_partial_deriv(iP, iDmolar, iT) > 0)){ return false; }
+            bool gas = (p < 0.98*pV && rhomolar < HEOS.rhomolar_critical());
+            bool liquid = (p > 1.02*pL && rhomolar > HEOS.rhomolar_critical());
+            if (!gas && !liquid){ return false; }
+        }
+        HEOS.recalculate_singlephase_phase();
+    }
+    else{
+        // The phase is found from the solution as in PT_flash_mixtures, not taken from the previous solution, since the path may have left its phase
+        if (HEOS.PhaseEnvelope.built){
+            SimpleState closest_state;
+            std::size_t iclosest;
+            if (PhaseEnvelopeRoutines::is_inside(HEOS.PhaseEnvelope, iP, p, iT, T, iclosest, closest_state)){ return false; }
+            HEOS._phase = (T > closest_state.T) ? iphase_gas : iphase_liquid;
+        }
+        else{
+            StabilityRoutines::StabilityEvaluationClass stability_tester(HEOS);
+            if (!stability_tester.is_stable()){ return false; }
+            // The stability analysis may have used this state
+            HEOS.update_DmolarT_direct(rhomolar, T);
+            HEOS._phase = iphase_liquid;
+        }
+    }
+    HEOS._Q = -1;
+    return true;
+}
+
+bool FlashRoutines::continuation_flash_twophase_pure(HelmholtzEOSMixtureBackend &HEOS, parameters key1, CoolPropDbl value1, parameters key2, CoolPropDbl value2, const GuessesStructure &guesses)
+{
+    // Near the critical point the normal flash routines use the critical region splines
+    const CriticalRegionSplines &splines = HEOS.components[0].EOS().critical_region_splines;
+    if (get_config_bool(CRITICAL_SPLINES_ENABLED) && splines.enabled && guesses.T > splines.T_min){ return false; }
+    
+    // The saturated states at T, from the saturated densities of the previous solution
+    class saturation_T_resid : public FuncWrapper1D
+    {
+    public:
+        HelmholtzEOSMixtureBackend &HEOS;
+        parameters key_Q, key_r;
+        CoolPropDbl value_Q, value_r, rhoL, rhoV, T, Q, r;
+        saturation_T_resid(HelmholtzEOSMixtureBackend &HEOS, parameters key_Q, CoolPropDbl value_Q, parameters key_r, CoolPropDbl value_r, CoolPropDbl rhoL, CoolPropDbl rhoV) 
+            : HEOS(HEOS), key_Q(key_Q), key_r(key_r), value_Q(value_Q), value_r(value_r), rhoL(rhoL), rhoV(rhoV), T(_HUGE), Q(_HUGE), r(_HUGE) {};
+        void saturate(CoolPropDbl T){
+            SaturationSolvers::saturation_T_pure_Akasaka_options options(true);
+            options.rhoL = rhoL; options.rhoV = rhoV;
+            SaturationSolvers::saturation_T_pure_Maxwell(HEOS, T, options);
+            rhoL = HEOS.SatL->rhomolar(); rhoV = HEOS.SatV->rhomolar();
+            this->T = T;
+            Q = twophase_quality(HEOS, key_Q, value_Q);
+        }
+        double call(double T){
+            saturate(T);
+            // The residual of the second input, relative to its change across the two-phase region
+            CoolPropDbl yL = HEOS.SatL->keyed_output(key_r), yV = HEOS.SatV->keyed_output(key_r);
+            r = ((1 - Q)*yL + Q*yV - value_r)/(yV - yL);
+            return r;
+        }
+    };
+    
+    CoolPropDbl Q;
+    if (key1 == iP || key2 == iP){
+        CoolPropDbl p = (key1 == iP) ? value1 : value2;
+        parameters other = (key1 == iP) ? key2 : key1;
+        CoolPropDbl other_value = (key1 == iP) ? value2 : value1;
+        SaturationSolvers::saturation_PHSU_pure_options options;
+        options.specified_variable = SaturationSolvers::saturation_PHSU_pure_options::IMPOSED_PL;
+        options.use_logdelta = false;
+        options.use_guesses = true;
+        options.T = guesses.T; options.rhoL = guesses.rhomolar_liq; options.rhoV = guesses.rhomolar_vap;
+        SaturationSolvers::saturation_PHSU_pure(HEOS, p, options);
+        Q = twophase_quality(HEOS, other, other_value);
+        if (!(Q >= 0 && Q <= 1)){ return false; }
+        // Load the outputs as in PQ_flash
+        HEOS._p = Q*HEOS.SatV->p() + (1 - Q)*HEOS.SatL->p();
+        HEOS._T = HEOS.SatL->T();
+    }
+    else{
+        CoolPropDbl T;
+        if (key1 == iT || key2 == iT){
+            T = (key1 == iT) ? value1 : value2;
+            parameters other = (key1 == iT) ? key2 : key1;
+            CoolPropDbl other_value = (key1 == iT) ? value2 : value1;
+            saturation_T_resid resid(HEOS, other, other_value, other, other_value, guesses.rhomolar_liq, guesses.rhomolar_vap);
+            resid.saturate(T);
+            Q = resid.Q;
+        }
+        else{
+            // The first of the inputs (D or H) gives the quality, and the temperature is found from the second one (H, S or U)
+            saturation_T_resid resid(HEOS, key1, value1, key2, value2, guesses.rhomolar_liq, guesses.rhomolar_vap);
+            Secant(resid, guesses.T, 1e-3, 1e-10, 30);
+            // The saturated states are those of the last temperature evaluated; Secant can stop on a small step
+            // without reaching the tolerance, so the residual at that temperature is checked here
+            T = resid.T;
+            Q = resid.Q;
+            if (!(std::abs(resid.r) <= 1e-10) || !ValidNumber(T)){ return false; }
+        }
+        if (!(Q >= 0 && Q <= 1)){ return false; }
+        // Load the outputs as in QT_flash
+        HEOS._T = T;
+        HEOS._p = 0.5*HEOS.SatV->p() + 0.5*HEOS.SatL->p();
+    }
+    HEOS._Q = Q;
+    HEOS._rhomolar = 1/(Q/HEOS.SatV->rhomolar() + (1 - Q)/HEOS.SatL->rhomolar());
+    HEOS._phase = iphase_twophase;
+    return true;
+}
+
 void FlashRoutines::PT_Q_flash_mixtures(HelmholtzEOSMixtureBackend &HEOS, parameters other, CoolPropDbl value)
 {
     
@@ -853,7 +1076,7 @@ void FlashRoutines::PT_Q_flash_mixtures(HelmholtzEOSMixtureBackend &HEOS, parame
             // 2. If imax initially is 0, and env.T.size() <= 2, then imax will become MAX_UINT.
             // 3. If imax+2 initially is more than env.T.size(), then single decrement will not bring it to range
             
-            SaturationSolvers::newton_raphson_saturation NR;
+            SaturationSolvers::newton_raphson_saturation &NR = HEOS.get_VLE_workspace().saturation;
             SaturationSolvers::newton_raphson_saturation_options IO;
             
             if (other == iP){
@@ -930,7 +1153,7 @@ void FlashRoutines::PT_Q_flash_mixtures(HelmholtzEOSMixtureBackend &HEOS, parame
         }
         std::size_t iliq = liquid_solutions[0], ivap = vapor_solutions[0];
         
-        SaturationSolvers::newton_raphson_twophase NR;
+        SaturationSolvers::newton_raphson_twophase &NR = HEOS.get_VLE_workspace().twophase;
         SaturationSolvers::newton_raphson_twophase_options IO;
         IO.beta = HEOS._Q;
         
@@ -1765,8 +1988,8 @@ void FlashRoutines::DHSU_T_flash(HelmholtzEOSMixtureBackend &HEOS, parameters ot
                 if (other != iDmolar)
                 {
                     // Update the states
-                    if (HEOS.SatL) HEOS.SatL->update(DmolarT_INPUTS, HEOS._rhoLanc, HEOS._T);
-                    if (HEOS.SatV) HEOS.SatV->update(DmolarT_INPUTS, HEOS._rhoVanc, HEOS._T);
+                    HEOS.SatL->update(DmolarT_INPUTS, HEOS._rhoLanc, HEOS._T);
+                    HEOS.SatV->update(DmolarT_INPUTS, HEOS._rhoVanc, HEOS._T);
                     // Update the two-Phase variables
                     HEOS._rhoLmolar = HEOS.SatL->rhomolar();
                     HEOS._rhoVmolar = HEOS.SatV->rhomolar();
@@ -1957,11 +2180,45 @@ void FlashRoutines::HS_flash_generate_TP_singlephase_guess(HelmholtzEOSMixtureBa
     T = ((double)rand()/(double)RAND_MAX)*(HEOS.Tmax()-HEOS.Ttriple())+HEOS.Ttriple();
     p = exp(logp);
 }
+bool FlashRoutines::HS_flash_guess_map(HelmholtzEOSMixtureBackend &HEOS, CoolPropDbl hmolar_spec, CoolPropDbl smolar_spec)
+{
+    shared_ptr<const HSFlashGuessMap> map_ptr = HSFlashGuessMap::get(HEOS);
+    const HSFlashGuessMap &map = *map_ptr;
+    // The map is relative to the critical point, which removes the reference state of this state
+    CoolPropDbl Tc = HEOS.T_critical(), rhoc = HEOS.rhomolar_critical();
+    CoolPropDbl hmolar = hmolar_spec - HEOS.calc_hmolar_nocache(Tc, rhoc), smolar = smolar_spec - HEOS.calc_smolar_nocache(Tc, rhoc);
+    
+    GuessesStructure guesses;
+    if (map.twophase_guess(hmolar, smolar, guesses)){
+        try{
+            if (continuation_flash_twophase_pure(HEOS, iHmolar, hmolar_spec, iSmolar, smolar_spec, guesses)){ return true; }
+        }
+        catch(...){}
+    }
+    // Single-phase, or two-phase but too close to the critical point for the map
+    const HSFlashGuessMap::Node &node = map.singlephase_guess(hmolar, smolar);
+    ContinuationState start;
+    start.phase = iphase_gas;
+    start.guesses.T = node.T;
+    start.guesses.rhomolar = node.rhomolar;
+    try{
+        return continuation_flash_singlephase(HEOS, iHmolar, hmolar_spec, iSmolar, smolar_spec, start);
+    }
+    catch(...){
+        return false;
+    }
+}
 void FlashRoutines::HS_flash(HelmholtzEOSMixtureBackend &HEOS)
 {
     // Use TS flash and iterate on T (known to be between Tmin and Tmax) 
     // in order to find H
     double hmolar = HEOS.hmolar(), smolar = HEOS.smolar();
+    // The map is built with the multiparameter equations of state and the ancillaries of the fluid
+    bool multiparameter = (HEOS.backend_name() == get_backend_string(HEOS_BACKEND_PURE) || HEOS.backend_name() == get_backend_string(HEOS_BACKEND_MIX));
+    if (get_config_bool(HS_FLASH_GUESS_MAP) && multiparameter && HEOS.is_pure_or_pseudopure && !HEOS.components[0].EOS().pseudo_pure
+        && HEOS.imposed_phase_index == iphase_not_imposed){
+        if (HS_flash_guess_map(HEOS, hmolar, smolar)){ return; }
+    }
     class Residual : public FuncWrapper1D
     {
     public:
@@ -157,6 +157,13 @@ public:
     /// @param HEOS The HelmholtzEOSMixtureBackend to be used
     static void HS_flash(HelmholtzEOSMixtureBackend &HEOS);
     
+    /// The H,S flash of a pure fluid, starting from the guesses of HSFlashGuessMap
+    /// @param HEOS The HelmholtzEOSMixtureBackend to be used
+    /// @param hmolar_spec The molar enthalpy in J/mol
+    /// @param smolar_spec The molar entropy in J/mol/K
+    /// @returns True if a solution was found; false if HS_flash must iterate on T,S flashes
+    static bool HS_flash_guess_map(HelmholtzEOSMixtureBackend &HEOS, CoolPropDbl hmolar_spec, CoolPropDbl smolar_spec);
+    
     /// Randomly generate a single phase set of inputs for T and p - searches entire single-phase region
     /// @param HEOS The HelmholtzEOSMixtureBackend to be used
     /// @param T The temperature in K
@@ -176,6 +183,31 @@ public:
         HS_flash_twophaseOptions(){omega = 1.0;}
     };
     static void HS_flash_twophase(HelmholtzEOSMixtureBackend &HEOS, CoolPropDbl hmolar_spec, CoolPropDbl smolar_spec, HS_flash_twophaseOptions &options);
+
+    /// A flash routine for the pairs of HelmholtzEOSMixtureBackend::update that starts from the solution of the previous update, see HelmholtzEOSMixtureBackend::set_continuation_mode
+    /// @param HEOS The HelmholtzEOSMixtureBackend to be used, on which pre_update has been called
+    /// @param input_pair The pair of molar inputs
+    /// @param value1 The first input value
+    /// @param value2 The second input value
+    /// @param previous The solution of the previous update
+    /// @returns True if a solution was found in the same region as the previous one; false if the normal flash routines must be used
+    static bool continuation_flash(HelmholtzEOSMixtureBackend &HEOS, input_pairs input_pair, CoolPropDbl value1, CoolPropDbl value2, const ContinuationState &previous);
+    
+    /// The single-phase part of continuation_flash; the solution is checked against the ancillary equations (pure fluids) or the phase envelope or a stability test (mixtures)
+    static bool continuation_flash_singlephase(HelmholtzEOSMixtureBackend &HEOS, parameters key1, CoolPropDbl value1, parameters key2, CoolPropDbl value2, const ContinuationState &previous);
+    
+    /// The two-phase part of continuation_flash for pure fluids; the saturated states start from the saturated densities of the previous solution
+    static bool continuation_flash_twophase_pure(HelmholtzEOSMixtureBackend &HEOS, parameters key1, CoolPropDbl value1, parameters key2, CoolPropDbl value2, const GuessesStructure &guesses);
+    
+    /// Solve for T and rho of a single-phase state given two of T, p, rhomolar, hmolar, smolar and umolar with Newton's method
+    /// @param HEOS The HelmholtzEOSMixtureBackend to be used
+    /// @param key1 The first input
+    /// @param value1 The first input value
+    /// @param key2 The second input
+    /// @param value2 The second input value
+    /// @param T0 The starting temperature in K
+    /// @param rhomolar0 The starting molar density in mol/m^3
+    static void singlephase_Newton_Trho(HelmholtzEOSMixtureBackend &HEOS, parameters key1, CoolPropDbl value1, parameters key2, CoolPropDbl value2, CoolPropDbl T0, CoolPropDbl rhomolar0);
 };
 
 
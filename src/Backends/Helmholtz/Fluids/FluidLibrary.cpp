@@ -313,6 +313,65 @@ void JSONFluidLibrary::add_one(rapidjson::Value &fluid_json)
 };
 
 
+std::size_t TransportPropertyData::heap_bytes() const
+{
+    std::size_t bytes = CoolProp::heap_bytes(BibTeX_viscosity) + CoolProp::heap_bytes(BibTeX_conductivity);
+    // Viscosity
+    const ViscosityDiluteVariables &vd = viscosity_dilute;
+    bytes += CoolProp::heap_bytes(vd.collision_integral.a) + CoolProp::heap_bytes(vd.collision_integral.t)
+           + CoolProp::heap_bytes(vd.collision_integral_powers_of_Tstar.a) + CoolProp::heap_bytes(vd.collision_integral_powers_of_Tstar.t)
+           + CoolProp::heap_bytes(vd.powers_of_T.a) + CoolProp::heap_bytes(vd.powers_of_T.t)
+           + CoolProp::heap_bytes(vd.powers_of_Tr.a) + CoolProp::heap_bytes(vd.powers_of_Tr.t);
+    const ViscosityInitialDensityVariables &vi = viscosity_initial;
+    bytes += CoolProp::heap_bytes(vi.rainwater_friend.b) + CoolProp::heap_bytes(vi.rainwater_friend.t)
+           + CoolProp::heap_bytes(vi.empirical.n) + CoolProp::heap_bytes(vi.empirical.d) + CoolProp::heap_bytes(vi.empirical.t);
+    const ViscosityModifiedBatschinskiHildebrandData &mbh = viscosity_higher_order.modified_Batschinski_Hildebrand;
+    const std::vector<CoolPropDbl> *mbh_vectors[] = {&mbh.a, &mbh.d1, &mbh.d2, &mbh.t1, &mbh.t2, &mbh.f, &mbh.g, &mbh.h, &mbh.p, &mbh.q, &mbh.gamma, &mbh.l};
+    for (std::size_t i = 0; i < sizeof(mbh_vectors)/sizeof(mbh_vectors[0]); ++i){ bytes += CoolProp::heap_bytes(*mbh_vectors[i]); }
+    const ViscosityFrictionTheoryData &ft = viscosity_higher_order.friction_theory;
+    const std::vector<CoolPropDbl> *ft_vectors[] = {&ft.Aa, &ft.Aaa, &ft.Aaaa, &ft.Ar, &ft.Arr, &ft.Adrdr, &ft.Arrr, &ft.Ai, &ft.Aii, &ft.AdrAdr};
+    for (std::size_t i = 0; i < sizeof(ft_vectors)/sizeof(ft_vectors[0]); ++i){ bytes += CoolProp::heap_bytes(*ft_vectors[i]); }
+    bytes += CoolProp::heap_bytes(viscosity_rhosr.c_liq) + CoolProp::heap_bytes(viscosity_rhosr.c_vap);
+    bytes += CoolProp::heap_bytes(viscosity_ecs.reference_fluid) + CoolProp::heap_bytes(viscosity_ecs.psi_a) + CoolProp::heap_bytes(viscosity_ecs.psi_t);
+    // Conductivity
+    bytes += CoolProp::heap_bytes(conductivity_dilute.ratio_polynomials.A) + CoolProp::heap_bytes(conductivity_dilute.ratio_polynomials.B)
+           + CoolProp::heap_bytes(conductivity_dilute.ratio_polynomials.n) + CoolProp::heap_bytes(conductivity_dilute.ratio_polynomials.m)
+           + CoolProp::heap_bytes(conductivity_dilute.eta0_and_poly.A) + CoolProp::heap_bytes(conductivity_dilute.eta0_and_poly.t);
+    const ConductivityResidualPolynomialAndExponentialData &pe = conductivity_residual.polynomial_and_exponential;
+    bytes += CoolProp::heap_bytes(conductivity_residual.polynomials.B) + CoolProp::heap_bytes(conductivity_residual.polynomials.t)
+           + CoolProp::heap_bytes(conductivity_residual.polynomials.d)
+           + CoolProp::heap_bytes(pe.A) + CoolProp::heap_bytes(pe.t) + CoolProp::heap_bytes(pe.d) + CoolProp::heap_bytes(pe.gamma) + CoolProp::heap_bytes(pe.l);
+    bytes += CoolProp::heap_bytes(conductivity_ecs.reference_fluid) + CoolProp::heap_bytes(conductivity_ecs.psi_a) + CoolProp::heap_bytes(conductivity_ecs.psi_t)
+           + CoolProp::heap_bytes(conductivity_ecs.f_int_a) + CoolProp::heap_bytes(conductivity_ecs.f_int_t);
+    return bytes;
+}
+
+std::size_t CoolPropFluid::heap_bytes() const
+{
+    std::size_t bytes = EOSVector.capacity()*sizeof(EquationOfState);
+    for (std::size_t i = 0; i < EOSVector.size(); ++i){ bytes += EOSVector[i].heap_bytes(); }
+    const std::string *strings[] = {&ECSReferenceFluid, &name, &REFPROPname, &CAS, &formula, &InChI, &InChIKey, &smiles, &TwoDPNG_URL,
+                                    &BibTeXKeys.EOS, &BibTeXKeys.CP0, &BibTeXKeys.VISCOSITY, &BibTeXKeys.CONDUCTIVITY,
+                                    &BibTeXKeys.ECS_LENNARD_JONES, &BibTeXKeys.ECS_FITS, &BibTeXKeys.SURFACE_TENSION, &environment.ASHRAE34};
+    for (std::size_t i = 0; i < sizeof(strings)/sizeof(strings[0]); ++i){ bytes += CoolProp::heap_bytes(*strings[i]); }
+    return bytes + CoolProp::heap_bytes(aliases) + ancillaries.heap_bytes() + transport.heap_bytes();
+}
+
+std::size_t JSONFluidLibrary::heap_bytes() const
+{
+    std::size_t bytes = map_node_bytes(fluid_map) + map_node_bytes(JSONstring_map) + map_node_bytes(string_to_index_map) + CoolProp::heap_bytes(name_vector);
+    for (std::map<std::size_t, CoolPropFluid>::const_iterator it = fluid_map.begin(); it != fluid_map.end(); ++it){
+        bytes += it->second.heap_bytes();
+    }
+    for (std::map<std::size_t, std::string>::const_iterator it = JSONstring_map.begin(); it != JSONstring_map.end(); ++it){
+        bytes += CoolProp::heap_bytes(it->second);
+    }
+    for (std::map<std::string, std::size_t>::const_iterator it = string_to_index_map.begin(); it != string_to_index_map.end(); ++it){
+        bytes += CoolProp::heap_bytes(it->first);
+    }
+    return bytes;
+}
+
 JSONFluidLibrary & get_library(void){
     if (library.is_empty()){ load(); }
     return library;
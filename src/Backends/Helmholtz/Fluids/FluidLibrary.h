@@ -1312,6 +1312,8 @@ public:
     {
         return strjoin(name_vector, ",");
     };
+    /// The bytes used by the fluids of the library and by the JSON strings they were loaded from
+    std::size_t heap_bytes() const;
 };
 
 /// Get a reference to the library instance
@@ -0,0 +1,205 @@
+#include "HSFlashGuessMap.h"
+#include <map>
+#include <mutex>
+
+namespace CoolProp{
+
+void HSFlashGuessMap::build(HelmholtzEOSMixtureBackend &HEOS_fluid)
+{
+    // A new state, so that the state of the caller is not changed
+    HelmholtzEOSMixtureBackend HEOS(HEOS_fluid.get_components());
+    CoolPropFluid &component = HEOS.get_components()[0];
+    const double Tc = HEOS.T_critical(), rhoc = HEOS.rhomolar_critical(), R = HEOS.gas_constant();
+    // The reducing state is needed by the calc_*_nocache functions
+    HEOS.calc_reducing_state();
+    const double hmolar_c = HEOS.calc_hmolar_nocache(Tc, rhoc), smolar_c = HEOS.calc_smolar_nocache(Tc, rhoc);
+    hmolar_scale = R*Tc;
+    smolar_scale = R;
+
+    // The saturated states, up to just below the critical point, where the saturated states merge
+    CoolPropDbl Tmin_satL, Tmin_satV;
+    HEOS.calc_Tmin_sat(Tmin_satL, Tmin_satV);
+    const double Tmin_sat = std::max(Tmin_satL, Tmin_satV), Tmax_sat = HEOS.calc_Tmax_sat();
+    const std::size_t Nsat = 100;
+    saturation.clear();
+    for (std::size_t i = 0; i < Nsat; ++i){
+        double T = Tmin_sat + (0.999*Tmax_sat - Tmin_sat)*i/(Nsat - 1);
+        try{
+            HEOS.update(QT_INPUTS, 0, T);
+            HelmholtzEOSMixtureBackend &SatL = HEOS.get_SatL(), &SatV = HEOS.get_SatV();
+            SaturationNode node;
+            node.T = T;
+            node.rhomolarL = SatL.rhomolar(); node.rhomolarV = SatV.rhomolar();
+            node.hmolarL = SatL.hmolar() - hmolar_c; node.hmolarV = SatV.hmolar() - hmolar_c;
+            node.smolarL = SatL.smolar() - smolar_c; node.smolarV = SatV.smolar() - smolar_c;
+            saturation.push_back(node);
+        }
+        catch(const CoolPropBaseError &){
+            // Skip the temperatures where the saturation solver fails
+        }
+    }
+
+    // The single-phase states, on a grid which is linear in temperature, and logarithmic in density up to the critical 
+    // density and linear above it, where the density of the liquid changes little
+    const double Tmin = HEOS.Tmin(), Tmax = HEOS.Tmax(), pmax = HEOS.pmax();
+    double rhomolar_min = HEOS.p_triple()/(R*Tmax), rhomolar_max = component.triple_liquid.rhomolar;
+    try{
+        HEOS.update(PT_INPUTS, pmax, Tmin);
+        rhomolar_max = std::max(rhomolar_max, static_cast<double>(HEOS.rhomolar()));
+    }
+    catch(const CoolPropBaseError &){}
+    if (!ValidNumber(rhomolar_min) || rhomolar_min <= 0){ rhomolar_min = 1e-6*rhoc; }
+    // The flash may fail below the melting line; the states above twice the maximum pressure are skipped anyway
+    rhomolar_max *= 1.5;
+    const std::size_t NT = 60, Nrho_gas = 40, Nrho_liquid = 40;
+    std::vector<double> rhomolars;
+    for (std::size_t j = 0; j < Nrho_gas; ++j){
+        rhomolars.push_back(exp(log(rhomolar_min) + (log(rhoc) - log(rhomolar_min))*j/Nrho_gas));
+    }
+    for (std::size_t j = 0; j < Nrho_liquid; ++j){
+        rhomolars.push_back(rhoc + (rhomolar_max - rhoc)*j/(Nrho_liquid - 1));
+    }
+    nodes.clear();
+    for (std::size_t i = 0; i < NT; ++i){
+        double T = Tmin + (Tmax - Tmin)*i/(NT - 1);
+        // States between the saturated densities are metastable or unstable
+        double rhoV = -1, rhoL = -1;
+        if (T < Tmax_sat){
+            rhoV = component.ancillaries.rhoV.evaluate(T);
+            rhoL = component.ancillaries.rhoL.evaluate(T);
+        }
+        for (std::size_t j = 0; j < rhomolars.size(); ++j){
+            double rhomolar = rhomolars[j];
+            if (rhomolar >= rhoV && rhomolar <= rhoL){ continue; }
+            try{
+                Node node;
+                node.T = T;
+                node.rhomolar = rhomolar;
+                double p = HEOS.calc_pressure_nocache(T, rhomolar);
+                node.hmolar = HEOS.calc_hmolar_nocache(T, rhomolar) - hmolar_c;
+                node.smolar = HEOS.calc_smolar_nocache(T, rhomolar) - smolar_c;
+                if (!(p > 0 && p < 2*pmax) || !ValidNumber(node.hmolar) || !ValidNumber(node.smolar)){ continue; }
+                nodes.push_back(node);
+            }
+            catch(const CoolPropBaseError &){
+                // Skip the states outside the range of the equation of state
+            }
+        }
+    }
+    if (nodes.empty()){
+        throw ValueError(format("No single-phase states could be evaluated for the H,S flash guess map of %s", HEOS.name().c_str()));
+    }
+    build_index();
+}
+
+void HSFlashGuessMap::build_index()
+{
+    double h_max = -_HUGE, s_max = -_HUGE;
+    h_min = _HUGE; s_min = _HUGE;
+    for (std::size_t i = 0; i < nodes.size(); ++i){
+        h_min = std::min(h_min, nodes[i].hmolar/hmolar_scale); h_max = std::max(h_max, nodes[i].hmolar/hmolar_scale);
+        s_min = std::min(s_min, nodes[i].smolar/smolar_scale); s_max = std::max(s_max, nodes[i].smolar/smolar_scale);
+    }
+    // About two states per cell
+    Nh = std::max(static_cast<std::size_t>(1), static_cast<std::size_t>(sqrt(0.5*nodes.size())));
+    Ns = Nh;
+    cell_h = (h_max > h_min) ? (h_max - h_min)/Nh : 1;
+    cell_s = (s_max > s_min) ? (s_max - s_min)/Ns : 1;
+    
+    // Count the states of each cell, and then fill the cells
+    std::vector<std::size_t> cell_of_node(nodes.size());
+    cell_first.assign(Nh*Ns + 1, 0);
+    for (std::size_t i = 0; i < nodes.size(); ++i){
+        std::size_t ih = std::min(Nh - 1, static_cast<std::size_t>((nodes[i].hmolar/hmolar_scale - h_min)/cell_h));
+        std::size_t is = std::min(Ns - 1, static_cast<std::size_t>((nodes[i].smolar/smolar_scale - s_min)/cell_s));
+        cell_of_node[i] = ih*Ns + is;
+        cell_first[cell_of_node[i] + 1]++;
+    }
+    for (std::size_t c = 0; c < Nh*Ns; ++c){ cell_first[c + 1] += cell_first[c]; }
+    std::vector<std::size_t> filled(cell_first.begin(), cell_first.end() - 1);
+    cell_nodes.resize(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i){
+        cell_nodes[filled[cell_of_node[i]]++] = i;
+    }
+}
+
+shared_ptr<const HSFlashGuessMap> HSFlashGuessMap::get(HelmholtzEOSMixtureBackend &HEOS)
+{
+    static std::map<std::string, shared_ptr<const HSFlashGuessMap> > maps;
+    static std::mutex maps_mutex;
+    const std::string name = HEOS.name();
+    {
+        std::lock_guard<std::mutex> lock(maps_mutex);
+        std::map<std::string, shared_ptr<const HSFlashGuessMap> >::const_iterator it = maps.find(name);
+        if (it != maps.end()){ return it->second; }
+    }
+    // The map is built without the lock, so that the flashes of the other fluids are not held up; if two threads build 
+    // the map of the same fluid at once, the one that is published first is kept
+    shared_ptr<HSFlashGuessMap> map(new HSFlashGuessMap());
+    map->build(HEOS);
+    std::lock_guard<std::mutex> lock(maps_mutex);
+    return maps.insert(std::pair<std::string, shared_ptr<const HSFlashGuessMap> >(name, map)).first->second;
+}
+
+bool HSFlashGuessMap::twophase_guess(double hmolar, double smolar, GuessesStructure &guesses) const
+{
+    // Along the saturation curve, the difference between the qualities from the enthalpy and from the entropy
+    // changes sign at the saturation temperature of the state
+    double f_old = _HUGE, Qh_old = _HUGE;
+    for (std::size_t i = 0; i < saturation.size(); ++i){
+        const SaturationNode &node = saturation[i];
+        double Qh = (hmolar - node.hmolarL)/(node.hmolarV - node.hmolarL);
+        double Qs = (smolar - node.smolarL)/(node.smolarV - node.smolarL);
+        double f = Qh - Qs;
+        if (i > 0 && f*f_old <= 0 && f != f_old){
+            double w = f_old/(f_old - f);
+            double Q = Qh_old + w*(Qh - Qh_old);
+            if (Q > -0.05 && Q < 1.05){
+                const SaturationNode &prev = saturation[i-1];
+                guesses.T = prev.T + w*(node.T - prev.T);
+                guesses.rhomolar_liq = prev.rhomolarL + w*(node.rhomolarL - prev.rhomolarL);
+                guesses.rhomolar_vap = prev.rhomolarV + w*(node.rhomolarV - prev.rhomolarV);
+                return true;
+            }
+        }
+        f_old = f; Qh_old = Qh;
+    }
+    return false;
+}
+
+const HSFlashGuessMap::Node &HSFlashGuessMap::singlephase_guess(double hmolar, double smolar) const
+{
+    // The cell of the state, or the closest cell if the state is outside the grid
+    const double h = hmolar/hmolar_scale, s = smolar/smolar_scale;
+    const long ih = std::min(static_cast<long>(Nh) - 1, std::max(0L, static_cast<long>(floor((h - h_min)/cell_h))));
+    const long is = std::min(static_cast<long>(Ns) - 1, std::max(0L, static_cast<long>(floor((s - s_min)/cell_s))));
+    
+    // Search the rings of cells around it until the closest state found so far is closer than any cell not yet searched
+    std::size_t iclosest = 0;
+    double dist_min = _HUGE;
+    for (long r = 0; ; ++r){
+        const long ih_lo = ih - r, ih_hi = ih + r, is_lo = is - r, is_hi = is + r;
+        for (long i = std::max(0L, ih_lo); i <= std::min(static_cast<long>(Nh) - 1, ih_hi); ++i){
+            for (long j = std::max(0L, is_lo); j <= std::min(static_cast<long>(Ns) - 1, is_hi); ++j){
+                // Only the cells on the ring; the inner ones have been searched already
+                if (i != ih_lo && i != ih_hi && j != is_lo && j != is_hi){ continue; }
+                const std::size_t c = i*Ns + j;
+                for (std::size_t k = cell_first[c]; k < cell_first[c + 1]; ++k){
+                    const Node &node = nodes[cell_nodes[k]];
+                    double dist = POW2(node.hmolar/hmolar_scale - h) + POW2(node.smolar/smolar_scale - s);
+                    if (dist < dist_min){ dist_min = dist; iclosest = cell_nodes[k]; }
+                }
+            }
+        }
+        // The distance from the state to the cells outside the ones searched so far; there are no states beyond the grid
+        double margin = _HUGE;
+        if (ih_lo > 0){ margin = std::min(margin, h - (h_min + ih_lo*cell_h)); }
+        if (ih_hi < static_cast<long>(Nh) - 1){ margin = std::min(margin, h_min + (ih_hi + 1)*cell_h - h); }
+        if (is_lo > 0){ margin = std::min(margin, s - (s_min + is_lo*cell_s)); }
+        if (is_hi < static_cast<long>(Ns) - 1){ margin = std::min(margin, s_min + (is_hi + 1)*cell_s - s); }
+        if (margin == _HUGE || dist_min <= margin*margin){ break; }
+    }
+    return nodes[iclosest];
+}
+
+} /* namespace CoolProp */
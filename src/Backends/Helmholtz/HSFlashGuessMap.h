@@ -0,0 +1,67 @@
+#ifndef HSFLASHGUESSMAP_H
+#define HSFLASHGUESSMAP_H
+
+#include "HelmholtzEOSMixtureBackend.h"
+#include <vector>
+
+namespace CoolProp{
+
+/**
+A coarse map of a pure fluid over the enthalpy-entropy plane, which gives the starting values of the H,S flash.
+
+The map holds the enthalpy and entropy of a grid of single-phase states in (T, rho), and those of the saturated states
+along the saturation curve.  The enthalpies and entropies are relative to their values at the critical point, so that
+the map does not depend on the reference state.  There is one map per fluid, which is built the first time it is needed
+and is not changed afterwards, so that it can be read by several threads at once.
+*/
+class HSFlashGuessMap
+{
+public:
+    /// A single-phase state of the grid
+    struct Node{
+        double T, rhomolar, hmolar, smolar;
+    };
+    /// The saturated states at one temperature
+    struct SaturationNode{
+        double T, rhomolarL, rhomolarV, hmolarL, hmolarV, smolarL, smolarV;
+    };
+    std::vector<Node> nodes; ///< The single-phase states
+    std::vector<SaturationNode> saturation; ///< The saturated states, by increasing temperature
+    double hmolar_scale, smolar_scale; ///< The scales of the distance between states in the h-s plane
+
+    /// The single-phase states are indexed by a uniform grid of cells over the h-s plane divided by the scales, so that the
+    /// closest state is found by searching the cells around a state rather than all the states
+    std::size_t Nh, Ns; ///< The number of cells along the enthalpy and along the entropy
+    double h_min, s_min, cell_h, cell_s; ///< The lower corner of the grid and the size of the cells, divided by the scales
+    std::vector<std::size_t> cell_first; ///< The index in cell_nodes of the first state of each cell, and the number of states at the end
+    std::vector<std::size_t> cell_nodes; ///< The indices of the single-phase states, cell by cell
+
+    /// Build the map of the fluid of HEOS, which must be a pure fluid
+    void build(HelmholtzEOSMixtureBackend &HEOS);
+
+    /// Build the grid of cells over the single-phase states
+    void build_index();
+
+    /// Get the map of the fluid of HEOS, building it on the first call for this fluid
+    static shared_ptr<const HSFlashGuessMap> get(HelmholtzEOSMixtureBackend &HEOS);
+
+    /** \brief Find the saturation temperature of a possibly two-phase state by interpolation along the saturation curve
+     *
+     * @param hmolar The molar enthalpy relative to the critical point in J/mol
+     * @param smolar The molar entropy relative to the critical point in J/mol/K
+     * @param guesses The interpolated temperature and saturated densities
+     * @returns True if the interpolated vapor quality is close to [0, 1]
+     */
+    bool twophase_guess(double hmolar, double smolar, GuessesStructure &guesses) const;
+
+    /** \brief Find the single-phase state of the map which is the closest to the given enthalpy and entropy
+     *
+     * @param hmolar The molar enthalpy relative to the critical point in J/mol
+     * @param smolar The molar entropy relative to the critical point in J/mol/K
+     * @returns The closest state
+     */
+    const Node &singlephase_guess(double hmolar, double smolar) const;
+};
+
+} /* namespace CoolProp */
+#endif
@@ -36,8 +36,8 @@
 #include "IdealCurves.h"
 #include "MixtureParameters.h"
 #include <stdlib.h>
-
-static int deriv_counter = 0;
+#include <thread>
+#include <functional>
 
 namespace CoolProp {
     
@@ -112,12 +112,8 @@ void HelmholtzEOSMixtureBackend::set_components(const std::vector<CoolPropFluid>
     // saturation classes cannot hold copies of the saturation classes
     if (generate_SatL_and_SatV)
     {
-        SatL.reset(get_copy(false));
-        SatL->specify_phase(iphase_liquid);
-        linked_states.push_back(SatL);
-        SatV.reset(get_copy(false));
-        SatV->specify_phase(iphase_gas);
-        linked_states.push_back(SatV);
+        SatL.defer(this, iphase_liquid);
+        SatV.defer(this, iphase_gas);
     }
 }
 void HelmholtzEOSMixtureBackend::set_mole_fractions(const std::vector<CoolPropDbl> &mole_fractions)
@@ -129,8 +125,8 @@ void HelmholtzEOSMixtureBackend::set_mole_fractions(const std::vector<CoolPropDb
     // Copy values without reallocating memory
     this->mole_fractions = mole_fractions; // Most effective copy
     this->resize(N); // No reallocation of this->mole_fractions happens
-    // Also store the mole fractions as doubles
-    this->mole_fractions_double = std::vector<double>(mole_fractions.begin(), mole_fractions.end());
+    // Also store the mole fractions as doubles, reusing the memory
+    this->mole_fractions_double.assign(mole_fractions.begin(), mole_fractions.end());
     _reducing.fill(_HUGE);
     
 };
@@ -144,14 +140,65 @@ void HelmholtzEOSMixtureBackend::sync_linked_states(const HelmholtzEOSMixtureBac
         it->get()->sync_linked_states(source);
     }
 }
+void HelmholtzEOSMixtureBackend::sync_linked_components(){
+    for (std::vector<shared_ptr<HelmholtzEOSMixtureBackend> >::iterator it = linked_states.begin(); it != linked_states.end(); ++it) {
+        it->get()->components = components;
+        it->get()->sync_linked_components();
+    }
+}
+void HelmholtzEOSMixtureBackend::copy_model(const HelmholtzEOSMixtureBackend &source, bool generate_SatL_and_SatV){
+    // The equations of state of the components cache the derivatives of their last evaluation, so each state needs its own copy
+    components = source.components;
+    N = source.N;
+    is_pure_or_pseudopure = source.is_pure_or_pseudopure;
+    mole_fractions = source.mole_fractions;
+    mole_fractions_double = source.mole_fractions_double;
+    K = source.K;
+    lnK = source.lnK;
+    // The reducing function is not changed by the evaluation of the state, so it is shared; set_binary_interaction_double 
+    // copies it before changing it if it is shared
+    Reducing = source.Reducing;
+    // The departure functions cache the derivatives of their last evaluation as well
+    residual_helmholtz.reset(source.residual_helmholtz->copy_ptr());
+    imposed_phase_index = iphase_not_imposed;
+    _phase = iphase_unknown;
+
+    if (generate_SatL_and_SatV)
+    {
+        SatL.defer(this, iphase_liquid);
+        SatV.defer(this, iphase_gas);
+    }
+}
+void LazyChildState::create(){
+    // Saturation classes cannot hold copies of the saturation classes
+    state.reset(parent->get_copy(false));
+    state->specify_phase(phase);
+    parent->linked_states.push_back(state);
+}
 HelmholtzEOSMixtureBackend * HelmholtzEOSMixtureBackend::get_copy(bool generate_SatL_and_SatV){
-    // Set up the class with these components
-    HelmholtzEOSMixtureBackend * ptr = new HelmholtzEOSMixtureBackend(components, generate_SatL_and_SatV);
-    // Recursively walk into linked states, setting the departure and reducing terms
-    // to be equal to the parent (this instance)
-    ptr->sync_linked_states(this);
+    // Set up the class with the model of this instance, without looking up the components and the mixture parameters again
+    HelmholtzEOSMixtureBackend * ptr = new HelmholtzEOSMixtureBackend();
+    ptr->copy_model(*this, generate_SatL_and_SatV);
     return ptr;
 };
+HelmholtzEOSMixtureBackend * HelmholtzEOSMixtureBackend::clone(){
+    // get_copy is overloaded by the cubic backends, which copy their own model
+    HelmholtzEOSMixtureBackend * ptr = get_copy(true);
+    if (!mole_fractions.empty()){
+        ptr->set_mole_fractions(mole_fractions);
+    }
+    if (imposed_phase_index != iphase_not_imposed){
+        ptr->specify_phase(imposed_phase_index);
+    }
+    return ptr;
+};
+VLEWorkspace &HelmholtzEOSMixtureBackend::get_VLE_workspace(){
+    // Not copied by get_copy, so that each state has its own
+    if (VLE_workspace.get() == NULL){
+        VLE_workspace.reset(new VLEWorkspace());
+    }
+    return *VLE_workspace;
+};
 void HelmholtzEOSMixtureBackend::set_mass_fractions(const std::vector<CoolPropDbl> &mass_fractions)
 {
     if (mass_fractions.size() != N)
@@ -301,11 +348,17 @@ void HelmholtzEOSMixtureBackend::apply_simple_mixing_rule(std::size_t i, std::si
 }
 /// Set binary mixture floating point parameter for this instance
 void HelmholtzEOSMixtureBackend::set_binary_interaction_double(const std::size_t i, const std::size_t j, const std::string &parameter, const double value){
+    clear_critical_points_cache();
+    clear_saturation_cache();
     if (parameter == "Fij"){
         residual_helmholtz->Excess.F[i][j] = value;
         residual_helmholtz->Excess.F[j][i] = value;
     }
     else{
+        // The reducing function may be shared with copies of this state (see get_copy), which keep their parameters
+        if (Reducing.use_count() > 1){
+            Reducing.reset(Reducing->copy());
+        }
         Reducing->set_binary_interaction_double(i,j,parameter,value);
     }
     /// Also set the parameters in the managed pointers for other states
@@ -328,6 +381,8 @@ double HelmholtzEOSMixtureBackend::get_binary_interaction_double(const std::size
 //}
 /// Set binary mixture floating point parameter for this instance
 void HelmholtzEOSMixtureBackend::set_binary_interaction_string(const std::size_t i, const std::size_t j, const std::string &parameter, const std::string & value){
+    clear_critical_points_cache();
+    clear_saturation_cache();
     if (parameter == "function"){
         residual_helmholtz->Excess.DepartureFunctionMatrix[i][j].reset(get_departure_function(value));
         residual_helmholtz->Excess.DepartureFunctionMatrix[j][i].reset(get_departure_function(value));
@@ -342,6 +397,9 @@ void HelmholtzEOSMixtureBackend::set_binary_interaction_string(const std::size_t
 };
     
 void HelmholtzEOSMixtureBackend::calc_change_EOS(const std::size_t i, const std::string &EOS_name){
+    clear_critical_points_cache();
+    clear_saturation_cache();
+    clear_transport_states();
 
     if (i < components.size()){
         CoolPropFluid &fluid = components[i];
@@ -388,9 +446,66 @@ void HelmholtzEOSMixtureBackend::calc_change_EOS(const std::size_t i, const std:
     else{
         throw ValueError(format("Index [%d] is invalid", i));
     }
-    // Now do the same thing to the saturated liquid and vapor instances if possible
-    if (this->SatL) SatL->change_EOS(i, EOS_name);
-	if (this->SatV) SatV->change_EOS(i, EOS_name);
+    // Now do the same thing to the linked states; the states that are created later copy the components of this state
+    for (std::vector<shared_ptr<HelmholtzEOSMixtureBackend> >::iterator it = linked_states.begin(); it != linked_states.end(); ++it){
+        it->get()->change_EOS(i, EOS_name);
+    }
+}
+
+MemoryFootprint HelmholtzEOSMixtureBackend::calc_memory_footprint(){
+    MemoryFootprint footprint = AbstractState::calc_memory_footprint();
+    // The instance, without the parts of it that are counted separately below
+    footprint.owned_model = sizeof(HelmholtzEOSMixtureBackend) - footprint.cached_derivatives - sizeof(PhaseEnvelopeData) - sizeof(SpinodalData);
+
+    // The copies of the fluids and the residual Helmholtz energy, with the derivatives cached in them
+    footprint.owned_model += components.capacity()*sizeof(CoolPropFluid);
+    for (std::size_t i = 0; i < components.size(); ++i){
+        footprint.owned_model += components[i].heap_bytes() - components[i].cached_bytes();
+        footprint.cached_derivatives += components[i].cached_bytes();
+    }
+    footprint.owned_model += heap_bytes(mole_fractions) + heap_bytes(mole_fractions_double) + heap_bytes(K) + heap_bytes(lnK)
+                           + heap_bytes(linked_states) + heap_bytes(transport_component_states);
+    if (residual_helmholtz.get() != NULL){
+        const std::size_t excess_cached = residual_helmholtz->Excess.cached_bytes();
+        footprint.owned_model += sizeof(ResidualHelmholtz) + residual_helmholtz->Excess.heap_bytes() - excess_cached;
+        footprint.cached_derivatives += excess_cached;
+    }
+    // The scratch memory of the VLE and stability routines
+    if (VLE_workspace.get() != NULL){
+        footprint.owned_model += sizeof(VLEWorkspace) + VLE_workspace->heap_bytes();
+    }
+    // The reducing function is shared with the copies of this state, see get_copy
+    if (Reducing.get() != NULL){
+        footprint.shared_model += Reducing->bytes();
+    }
+
+    // The saturated states and the solution of the previous update in continuation mode
+    footprint.cached_derivatives += saturation_cache.size()*(sizeof(SaturationCacheEntry) + 2*sizeof(void*));
+    footprint.cached_derivatives += heap_bytes(continuation.guesses.x) + heap_bytes(continuation.guesses.y);
+
+    // The child states; the model data they share with this state has already been counted
+    for (std::size_t i = 0; i < linked_states.size(); ++i){
+        MemoryFootprint child = linked_states[i]->memory_footprint();
+        footprint.child_states += child.total();
+        if (Reducing.get() != NULL && linked_states[i]->Reducing.get() == Reducing.get()){
+            footprint.child_states -= child.shared_model;
+        }
+    }
+    for (std::size_t i = 0; i < transport_component_states.size(); ++i){
+        if (transport_component_states[i].get() != NULL){ footprint.child_states += transport_component_states[i]->memory_footprint().total(); }
+    }
+    ECSReferenceState *references[] = {&viscosity_ECS_reference, &conductivity_ECS_reference, &conformal_reference};
+    for (std::size_t i = 0; i < sizeof(references)/sizeof(references[0]); ++i){
+        if (references[i]->state.get() != NULL){ footprint.child_states += references[i]->state->memory_footprint().total(); }
+    }
+
+    footprint.phase_envelope = sizeof(PhaseEnvelopeData) + PhaseEnvelope.heap_bytes();
+
+    footprint.spinodal = sizeof(SpinodalData) + spinodal_values.heap_bytes();
+    for (std::list<CriticalPointsCacheEntry>::const_iterator it = critical_points_cache.begin(); it != critical_points_cache.end(); ++it){
+        footprint.spinodal += sizeof(CriticalPointsCacheEntry) + 2*sizeof(void*) + heap_bytes(it->z) + heap_bytes(it->critical_points) + it->spinodal_values.heap_bytes();
+    }
+    return footprint;
 }
 void HelmholtzEOSMixtureBackend::calc_phase_envelope(const std::string &type)
 {
@@ -687,9 +802,9 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity(void)
         set_warning_string("Mixture model for viscosity is highly approximate");
         CoolPropDbl summer = 0;
         for (std::size_t i = 0; i < mole_fractions.size(); ++i){
-            shared_ptr<HelmholtzEOSBackend> HEOS(new HelmholtzEOSBackend(components[i]));
-            HEOS->update(DmolarT_INPUTS, _rhomolar, _T);
-            summer += mole_fractions[i]*log(HEOS->viscosity());
+            HelmholtzEOSMixtureBackend &HEOS = get_transport_component_state(i);
+            HEOS.update(DmolarT_INPUTS, _rhomolar, _T);
+            summer += mole_fractions[i]*log(HEOS.viscosity());
         }
         return exp(summer);
     }
@@ -710,13 +825,10 @@ void HelmholtzEOSMixtureBackend::calc_viscosity_contributions(CoolPropDbl &dilut
         // Check if using ECS
         if (component.transport.viscosity_using_ECS)
         {
-            // Get reference fluid name
-            std::string fluid_name  = component.transport.viscosity_ecs.reference_fluid;
-            std::vector<std::string> names(1, fluid_name);
-            // Get a managed pointer to the reference fluid for ECS
-            shared_ptr<HelmholtzEOSMixtureBackend> ref_fluid(new HelmholtzEOSMixtureBackend(names));
+            // Make sure the reference fluid for ECS exists
+            get_ECS_reference_state(viscosity_ECS_reference, component.transport.viscosity_ecs.reference_fluid);
             // Get the viscosity using ECS and stick in the critical value
-            critical = TransportRoutines::viscosity_ECS(*this, *ref_fluid);
+            critical = TransportRoutines::viscosity_ECS(*this, viscosity_ECS_reference);
             return;
         }
 
@@ -797,13 +909,10 @@ void HelmholtzEOSMixtureBackend::calc_conductivity_contributions(CoolPropDbl &di
         // Check if using ECS
         if (component.transport.conductivity_using_ECS)
         {
-            // Get reference fluid name
-            std::string fluid_name  = component.transport.conductivity_ecs.reference_fluid;
-            std::vector<std::string> name(1, fluid_name);
-            // Get a managed pointer to the reference fluid for ECS
-            shared_ptr<HelmholtzEOSMixtureBackend> ref_fluid(new HelmholtzEOSMixtureBackend(name));
+            // Make sure the reference fluid for ECS exists
+            get_ECS_reference_state(conductivity_ECS_reference, component.transport.conductivity_ecs.reference_fluid);
             // Get the viscosity using ECS and store in initial_density (not normally used);
-            initial_density = TransportRoutines::conductivity_ECS(*this, *ref_fluid); // Warning: not actually initial_density
+            initial_density = TransportRoutines::conductivity_ECS(*this, conductivity_ECS_reference); // Warning: not actually initial_density
             return;
         }
         
@@ -903,15 +1012,32 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_conductivity(void)
         set_warning_string("Mixture model for conductivity is highly approximate");
         CoolPropDbl summer = 0;
         for (std::size_t i = 0; i < mole_fractions.size(); ++i){
-            shared_ptr<HelmholtzEOSBackend> HEOS(new HelmholtzEOSBackend(components[i]));
-            HEOS->update(DmolarT_INPUTS, _rhomolar, _T);
-            summer += mole_fractions[i]*HEOS->conductivity();
+            HelmholtzEOSMixtureBackend &HEOS = get_transport_component_state(i);
+            HEOS.update(DmolarT_INPUTS, _rhomolar, _T);
+            summer += mole_fractions[i]*HEOS.conductivity();
         }
         return summer;
     }
 }
+HelmholtzEOSMixtureBackend &HelmholtzEOSMixtureBackend::get_ECS_reference_state(ECSReferenceState &reference, const std::string &fluid_name){
+    if (reference.state.get() == NULL || reference.fluid_name != fluid_name){
+        reference = ECSReferenceState();
+        reference.fluid_name = fluid_name;
+        reference.state.reset(new HelmholtzEOSMixtureBackend(std::vector<std::string>(1, fluid_name)));
+    }
+    return *reference.state;
+}
+HelmholtzEOSMixtureBackend &HelmholtzEOSMixtureBackend::get_transport_component_state(std::size_t i){
+    if (transport_component_states.size() != components.size()){
+        transport_component_states.assign(components.size(), shared_ptr<HelmholtzEOSMixtureBackend>());
+    }
+    if (transport_component_states[i].get() == NULL){
+        transport_component_states[i].reset(new HelmholtzEOSBackend(components[i]));
+    }
+    return *transport_component_states[i];
+}
 void HelmholtzEOSMixtureBackend::calc_conformal_state(const std::string &reference_fluid, CoolPropDbl &T, CoolPropDbl &rhomolar){
-    shared_ptr<CoolProp::HelmholtzEOSMixtureBackend> REF(new CoolProp::HelmholtzEOSBackend(reference_fluid));
+    HelmholtzEOSMixtureBackend *REF = &get_ECS_reference_state(conformal_reference, reference_fluid);
     
     if (T < 0 && rhomolar < 0){
         // Collect some parameters
@@ -1282,6 +1408,11 @@ void HelmholtzEOSMixtureBackend::update(CoolProp::input_pairs input_pair, double
 {
     if (get_debug_level() > 10){std::cout << format("%s (%d): update called with (%d: (%s), %g, %g)",__FILE__,__LINE__, input_pair, get_input_pair_short_desc(input_pair).c_str(), value1, value2) << std::endl;}
 
+    if (continuation.enabled && !continuation.updating){
+        update_with_continuation(input_pair, value1, value2);
+        return;
+    }
+
     CoolPropDbl ld_value1 = value1, ld_value2 = value2;
     pre_update(input_pair, ld_value1, ld_value2);
     value1 = ld_value1; value2 = ld_value2;
@@ -1381,6 +1512,150 @@ void HelmholtzEOSMixtureBackend::update_with_guesses(CoolProp::input_pairs input
     post_update();
 }
 
+void HelmholtzEOSMixtureBackend::update_with_continuation(CoolProp::input_pairs input_pair, double value1, double value2)
+{
+    // The flash routines may update this state themselves, which must then use the normal update
+    continuation.updating = true;
+    bool converged = false;
+    if (continuation.valid && imposed_phase_index == iphase_not_imposed){
+        try{
+            CoolProp::input_pairs molar_pair = input_pair;
+            CoolPropDbl ld_value1 = value1, ld_value2 = value2;
+            pre_update(molar_pair, ld_value1, ld_value2);
+            converged = FlashRoutines::continuation_flash(*this, molar_pair, ld_value1, ld_value2, continuation);
+            if (converged){
+                post_update();
+            }
+        }
+        catch(const CoolPropBaseError &){
+            // Any failure of the flash from the previous solution is left to the normal update
+            converged = false;
+        }
+    }
+    if (converged){
+        continuation.Ncontinued++;
+    }
+    else{
+        continuation.Nfallback++;
+        try{
+            update(input_pair, value1, value2);
+        }
+        catch(...){
+            continuation.updating = false;
+            continuation.valid = false;
+            throw;
+        }
+    }
+    continuation.updating = false;
+    store_continuation_state();
+}
+
+void HelmholtzEOSMixtureBackend::store_continuation_state()
+{
+    continuation.valid = (isHomogeneousPhase() || isTwoPhase()) && ValidNumber(_T) && ValidNumber(_p) && ValidNumber(_rhomolar);
+    if (!continuation.valid){ return; }
+    continuation.phase = _phase;
+    continuation.Q = _Q;
+    GuessesStructure &guesses = continuation.guesses;
+    guesses.T = _T;
+    guesses.p = _p;
+    guesses.rhomolar = _rhomolar;
+    if (isTwoPhase()){
+        guesses.rhomolar_liq = SatL->rhomolar();
+        guesses.rhomolar_vap = SatV->rhomolar();
+        const std::vector<CoolPropDbl> &x = SatL->get_mole_fractions_ref(), &y = SatV->get_mole_fractions_ref();
+        guesses.x.assign(x.begin(), x.end());
+        guesses.y.assign(y.begin(), y.end());
+    }
+}
+
+std::vector<std::vector<double> > HelmholtzEOSMixtureBackend::update_composition_sweep(const std::vector<CompositionSweepPoint> &points, const std::vector<parameters> &outputs, std::size_t Nthreads)
+{
+    std::vector<std::vector<double> > results(points.size(), std::vector<double>(outputs.size(), _HUGE));
+    Nthreads = std::max(static_cast<std::size_t>(1), std::min(Nthreads, points.size()));
+    
+    // Each block is evaluated on a copy of this state, except for the last one which uses this 
+    // state, so that this state ends up at the last point, as for a serial sweep
+    std::vector<shared_ptr<HelmholtzEOSMixtureBackend> > copies;
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i + 1 < Nthreads; ++i){
+        copies.push_back(shared_ptr<HelmholtzEOSMixtureBackend>(get_copy()));
+        threads.push_back(std::thread(&HelmholtzEOSMixtureBackend::evaluate_composition_sweep, copies.back().get(), std::cref(points), i*points.size()/Nthreads, (i+1)*points.size()/Nthreads, std::cref(outputs), std::ref(results)));
+    }
+    evaluate_composition_sweep(points, (Nthreads-1)*points.size()/Nthreads, points.size(), outputs, results);
+    for (std::size_t i = 0; i < threads.size(); ++i){
+        threads[i].join();
+    }
+    return results;
+}
+
+void HelmholtzEOSMixtureBackend::evaluate_composition_sweep(const std::vector<CompositionSweepPoint> &points, std::size_t ifirst, std::size_t ilast, const std::vector<parameters> &outputs, std::vector<std::vector<double> > &results)
+{
+    // The values of the previous bubble- or dew-point, used as guesses for the next one
+    GuessesStructure guesses;
+    std::vector<CoolPropDbl> Kprev(N);
+    double Qprev = -1; // Negative if the previous point is not a bubble- or dew-point
+    
+    for (std::size_t i = ifirst; i < ilast; ++i){
+        const CompositionSweepPoint &point = points[i];
+        try{
+            set_mole_fractions(point.z);
+            
+            bool saturation = (point.input_pair == PQ_INPUTS || point.input_pair == QT_INPUTS);
+            double Q = (point.input_pair == PQ_INPUTS) ? point.value2 : point.value1;
+            bool updated = false;
+            if (saturation && Qprev >= 0 && std::abs(Q - Qprev) < 1e-10){
+                // The incipient phase composition is obtained from the K-factors of the previous point
+                std::vector<double> &bulk = (Q < 0.5) ? guesses.x : guesses.y,
+                                    &incipient = (Q < 0.5) ? guesses.y : guesses.x;
+                bulk.assign(point.z.begin(), point.z.end());
+                incipient.resize(N);
+                double summer = 0;
+                for (std::size_t j = 0; j < N; ++j){
+                    incipient[j] = (Q < 0.5) ? Kprev[j]*point.z[j] : point.z[j]/Kprev[j];
+                    summer += incipient[j];
+                }
+                for (std::size_t j = 0; j < N; ++j){ incipient[j] /= summer; }
+                try{
+                    update_with_guesses(point.input_pair, point.value1, point.value2, guesses);
+                    updated = true;
+                }
+                catch(...){
+                    // Fall back to the normal update
+                }
+            }
+            if (!updated){
+                update(point.input_pair, point.value1, point.value2);
+            }
+            
+            // Keep the K-factors and densities of bubble- and dew-points of mixtures for the next point
+            Qprev = -1;
+            if (saturation && !is_pure_or_pseudopure && (std::abs(Q) < 1e-10 || std::abs(Q-1) < 1e-10)){
+                const std::vector<CoolPropDbl> &x = SatL->get_mole_fractions_ref(), &y = SatV->get_mole_fractions_ref();
+                for (std::size_t j = 0; j < N; ++j){ Kprev[j] = y[j]/x[j]; }
+                guesses.T = _T;
+                guesses.p = _p;
+                guesses.rhomolar_liq = SatL->rhomolar();
+                guesses.rhomolar_vap = SatV->rhomolar();
+                Qprev = Q;
+            }
+        }
+        catch(...){
+            // All the outputs of this point stay _HUGE
+            Qprev = -1;
+            continue;
+        }
+        for (std::size_t j = 0; j < outputs.size(); ++j){
+            try{
+                results[i][j] = keyed_output(outputs[j]);
+            }
+            catch(...){
+                results[i][j] = _HUGE;
+            }
+        }
+    }
+}
+
 void HelmholtzEOSMixtureBackend::post_update(bool optional_checks)
 {
     // Check the values that must always be set
@@ -1652,13 +1927,11 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
 
         // Actually have to use saturation information sadly
         // For the given pressure, find the saturation state
-        // Run the saturation routines to determine the saturation densities and pressures
-        HelmholtzEOSMixtureBackend HEOS(components);
-        HEOS._p = this->_p;
-        HEOS._Q = 0; // ?? What is the best to do here? Doesn't matter for our purposes since pure fluid
-        FlashRoutines::PQ_flash(HEOS);
+        // Run the saturation routines (or reuse their cached solution) to determine the saturation densities and pressures
+        shared_ptr<HelmholtzEOSMixtureBackend> HEOS;
+        HelmholtzEOSMixtureBackend &sat = update_saturation_states(iP, _p, HEOS);
 
-        // We called the saturation routines, so HEOS.SatL and HEOS.SatV are now updated
+        // We called the saturation routines, so sat.SatL and sat.SatV are now updated
         // with the saturated liquid and vapor values, which can therefore be used in
         // the other solvers
         saturation_called = true;
@@ -1666,10 +1939,10 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
         CoolPropDbl Q;
 
         if (other == iT){
-            if (value < HEOS.SatL->T()-100*DBL_EPSILON){
+            if (value < sat.SatL->T()-100*DBL_EPSILON){
                 this->_phase = iphase_liquid; _Q = -1000;  return;
             }
-            else if (value > HEOS.SatV->T()+100*DBL_EPSILON){
+            else if (value > sat.SatV->T()+100*DBL_EPSILON){
                 this->_phase = iphase_gas; _Q = 1000; return;
             }
             else{
@@ -1679,23 +1952,19 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
         switch (other)
         {
             case iDmolar:
-                Q = (1/value-1/HEOS.SatL->rhomolar())/(1/HEOS.SatV->rhomolar()-1/HEOS.SatL->rhomolar()); break;
+                Q = (1/value-1/sat.SatL->rhomolar())/(1/sat.SatV->rhomolar()-1/sat.SatL->rhomolar()); break;
             case iSmolar:
-                Q = (value - HEOS.SatL->smolar())/(HEOS.SatV->smolar() - HEOS.SatL->smolar()); break;
+                Q = (value - sat.SatL->smolar())/(sat.SatV->smolar() - sat.SatL->smolar()); break;
             case iHmolar:
-                Q = (value - HEOS.SatL->hmolar())/(HEOS.SatV->hmolar() - HEOS.SatL->hmolar()); break;
+                Q = (value - sat.SatL->hmolar())/(sat.SatV->hmolar() - sat.SatL->hmolar()); break;
             case iUmolar:
-                Q = (value - HEOS.SatL->umolar())/(HEOS.SatV->umolar() - HEOS.SatL->umolar()); break;
+                Q = (value - sat.SatL->umolar())/(sat.SatV->umolar() - sat.SatL->umolar()); break;
             default:
                 throw ValueError(format("bad input for other"));
         }
-		// TODO: Check the speed penalty of these calls
-        // Update the states
-		if (this->SatL) this->SatL->update(DmolarT_INPUTS, HEOS.SatL->rhomolar(), HEOS.SatL->T()) ;
-		if (this->SatV) this->SatV->update(DmolarT_INPUTS, HEOS.SatV->rhomolar(), HEOS.SatV->T()) ;
 		// Update the two-Phase variables
-		_rhoLmolar = HEOS.SatL->rhomolar();
-		_rhoVmolar = HEOS.SatV->rhomolar();
+		_rhoLmolar = sat.SatL->rhomolar();
+		_rhoVmolar = sat.SatV->rhomolar();
 
 		//
         if (Q < -1e-9){
@@ -1710,8 +1979,8 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
         
         _Q = Q;
         // Load the outputs
-        _T = _Q*HEOS.SatV->T() + (1-_Q)*HEOS.SatL->T();
-        _rhomolar = 1/(_Q/HEOS.SatV->rhomolar() + (1-_Q)/HEOS.SatL->rhomolar());
+        _T = _Q*sat.SatV->T() + (1-_Q)*sat.SatL->T();
+        _rhomolar = 1/(_Q/sat.SatV->rhomolar() + (1-_Q)/sat.SatL->rhomolar());
         return;
     }
     else if (_p < components[0].EOS().ptriple*0.9999)
@@ -1737,6 +2006,59 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
         throw ValueError(format("The pressure [%g Pa] cannot be used in p_phase_determination",_p));
     }
 }
+HelmholtzEOSMixtureBackend &HelmholtzEOSMixtureBackend::update_saturation_states(parameters imposed, CoolPropDbl value, shared_ptr<HelmholtzEOSMixtureBackend> &HEOS)
+{
+    // A state without saturated child states (generate_SatL_and_SatV=false) solves on a local state instead
+    if (!SatL || !SatV){
+        HEOS.reset(new HelmholtzEOSMixtureBackend(components));
+    }
+    HelmholtzEOSMixtureBackend &sat = (HEOS) ? *HEOS : *this;
+    // Within this relative difference the saturation solvers would converge to the same saturated states
+    const CoolPropDbl tolerance = 1e-12;
+    const std::size_t cache_size = static_cast<std::size_t>(std::max(get_config_double(SATURATION_CACHE_SIZE), 0.0));
+    for (std::list<SaturationCacheEntry>::iterator it = saturation_cache.begin(); it != saturation_cache.end(); ++it){
+        if (it->imposed == imposed && std::abs(value - it->value) <= tolerance*std::abs(it->value)){
+            // Move the entry to the front since it is the most recently used
+            saturation_cache.splice(saturation_cache.begin(), saturation_cache, it);
+            SaturationCacheEntry &entry = saturation_cache.front();
+            sat.SatL->update(DmolarT_INPUTS, entry.rhomolarL, entry.TL);
+            sat.SatV->update(DmolarT_INPUTS, entry.rhomolarV, entry.TV);
+            return sat;
+        }
+    }
+    
+    // The saturation routines run on a state of their own, so that the child states of this state are only updated at the solution
+    shared_ptr<HelmholtzEOSMixtureBackend> solver = (HEOS) ? HEOS : shared_ptr<HelmholtzEOSMixtureBackend>(new HelmholtzEOSMixtureBackend(components));
+    if (imposed == iP){
+        solver->_p = value;
+        solver->_Q = 0; // ?? What is the best to do here? Doesn't matter for our purposes since pure fluid
+        FlashRoutines::PQ_flash(*solver);
+    }
+    else if (imposed == iT){
+        SaturationSolvers::saturation_T_pure_options options;
+        SaturationSolvers::saturation_T_pure(*solver, value, options);
+    }
+    else{
+        throw ValueError(format("imposed variable [%s] to update_saturation_states is invalid", get_parameter_information(imposed, "short").c_str()));
+    }
+    if (solver.get() != &sat){
+        SatL->update(DmolarT_INPUTS, solver->SatL->rhomolar(), solver->SatL->T());
+        SatV->update(DmolarT_INPUTS, solver->SatV->rhomolar(), solver->SatV->T());
+    }
+    
+    if (cache_size > 0){
+        SaturationCacheEntry entry;
+        entry.imposed = imposed;
+        entry.value = value;
+        entry.TL = solver->SatL->T(); entry.rhomolarL = solver->SatL->rhomolar();
+        entry.TV = solver->SatV->T(); entry.rhomolarV = solver->SatV->rhomolar();
+        saturation_cache.push_front(entry);
+    }
+    while (saturation_cache.size() > cache_size){
+        saturation_cache.pop_back();
+    }
+    return sat;
+}
 void HelmholtzEOSMixtureBackend::calc_ssat_max(void)
 {
     class Residual : public FuncWrapper1D
@@ -1973,46 +2295,42 @@ void HelmholtzEOSMixtureBackend::T_phase_determination_pure_or_pseudopure(int ot
 
         // Actually have to use saturation information sadly
         // For the given temperature, find the saturation state
-        // Run the saturation routines to determine the saturation densities and pressures
-        HelmholtzEOSMixtureBackend HEOS(components);
-        SaturationSolvers::saturation_T_pure_options options;
-        SaturationSolvers::saturation_T_pure(HEOS, _T, options);
+        // Run the saturation routines (or reuse their cached solution) to determine the saturation densities and pressures
+        shared_ptr<HelmholtzEOSMixtureBackend> HEOS;
+        HelmholtzEOSMixtureBackend &sat = update_saturation_states(iT, _T, HEOS);
 
         CoolPropDbl Q;
 
         if (other == iP)
         {
-            if (value > HEOS.SatL->p()*(1e-6 + 1)){
+            if (value > sat.SatL->p()*(1e-6 + 1)){
                 this->_phase = iphase_liquid; _Q = -1000; return;
             }
-            else if (value < HEOS.SatV->p()*(1 - 1e-6)){
+            else if (value < sat.SatV->p()*(1 - 1e-6)){
                 this->_phase = iphase_gas; _Q = 1000; return;
             }
             else{
-                throw ValueError(format("Saturation pressure [%g Pa] corresponding to T [%g K] is within 1e-4 %% of given p [%Lg Pa]", HEOS.SatL->p(), _T, value));
+                throw ValueError(format("Saturation pressure [%g Pa] corresponding to T [%g K] is within 1e-4 %% of given p [%Lg Pa]", sat.SatL->p(), _T, value));
             }
         }
 
         switch (other)
         {
             case iDmolar:
-                Q = (1/value-1/HEOS.SatL->rhomolar())/(1/HEOS.SatV->rhomolar()-1/HEOS.SatL->rhomolar()); break;
+                Q = (1/value-1/sat.SatL->rhomolar())/(1/sat.SatV->rhomolar()-1/sat.SatL->rhomolar()); break;
             case iSmolar:
-                Q = (value - HEOS.SatL->smolar())/(HEOS.SatV->smolar() - HEOS.SatL->smolar()); break;
+                Q = (value - sat.SatL->smolar())/(sat.SatV->smolar() - sat.SatL->smolar()); break;
             case iHmolar:
-                Q = (value - HEOS.SatL->hmolar())/(HEOS.SatV->hmolar() - HEOS.SatL->hmolar()); break;
+                Q = (value - sat.SatL->hmolar())/(sat.SatV->hmolar() - sat.SatL->hmolar()); break;
             case iUmolar:
-                Q = (value - HEOS.SatL->umolar())/(HEOS.SatV->umolar() - HEOS.SatL->umolar()); break;
+                Q = (value - sat.SatL->umolar())/(sat.SatV->umolar() - sat.SatL->umolar()); break;
             default:
                 throw ValueError(format("bad input for other"));
         }
         
-        // Update the states
-		if (this->SatL) this->SatL->update(DmolarT_INPUTS, HEOS.SatL->rhomolar(), HEOS.SatL->T());
-		if (this->SatV) this->SatV->update(DmolarT_INPUTS, HEOS.SatV->rhomolar(), HEOS.SatV->T());
 		// Update the two-Phase variables
-		_rhoLmolar = HEOS.SatL->rhomolar();
-		_rhoVmolar = HEOS.SatV->rhomolar();
+		_rhoLmolar = sat.SatL->rhomolar();
+		_rhoVmolar = sat.SatV->rhomolar();
 
         if (Q < 0){
             this->_phase = iphase_liquid; _Q = -1; return;
@@ -2025,8 +2343,8 @@ void HelmholtzEOSMixtureBackend::T_phase_determination_pure_or_pseudopure(int ot
         }
         _Q = Q;
         // Load the outputs
-        _p = _Q*HEOS.SatV->p() + (1-_Q)*HEOS.SatL->p();
-        _rhomolar = 1/(_Q/HEOS.SatV->rhomolar() + (1-_Q)/HEOS.SatL->rhomolar());
+        _p = _Q*sat.SatV->p() + (1-_Q)*sat.SatL->p();
+        _rhomolar = 1/(_Q/sat.SatV->rhomolar() + (1-_Q)/sat.SatL->rhomolar());
         return;
     }
     else if (_T > _crit.T && _T > components[0].EOS().Ttriple)  // Supercritical or Supercritical Gas Region
@@ -2964,7 +3282,6 @@ void HelmholtzEOSMixtureBackend::calc_reducing_state(void)
 }
 void HelmholtzEOSMixtureBackend::calc_all_alphar_deriv_cache(const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta)
 {
-    deriv_counter++;
     bool cache_values = true;
     HelmholtzDerivatives derivs = residual_helmholtz->all(*this, get_mole_fractions_ref(), tau, delta, cache_values);
     _alphar = derivs.alphar;
@@ -2984,6 +3301,74 @@ void HelmholtzEOSMixtureBackend::calc_all_alphar_deriv_cache(const std::vector<C
     _d4alphar_dTau4 = derivs.d4alphar_dtau4;
 }
 
+/// Scale a derivative of the ideal-gas Helmholtz energy of a pure fluid as in calc_alpha0_deriv_nocache, and cache it if it is valid
+static void cache_pure_alpha0_deriv(CachedElement &el, CoolPropDbl val, const int nTau, const int nDelta, CoolPropDbl rhor_rhomolarc, CoolPropDbl Tr_Tc)
+{
+    val *= pow(rhor_rhomolarc, nDelta);
+    val /= pow(Tr_Tc, nTau);
+    if (ValidNumber(val)){ el = val; }
+}
+void HelmholtzEOSMixtureBackend::calc_all_alpha0_deriv_cache(const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta)
+{
+    if (components.size() == 0){
+        throw ValueError("No alpha0 derivatives are available");
+    }
+    const CoolPropDbl &Tr = _reducing.T, &rhor = _reducing.rhomolar;
+    if (is_pure_or_pseudopure)
+    {
+        double Tc = get_fluid_constant(0, iT_reducing), rhomolarc = get_fluid_constant(0, irhomolar_reducing);
+        double taustar = Tc/Tr*tau, deltastar = rhor/rhomolarc*delta;
+        HelmholtzDerivatives derivs = components[0].EOS().alpha0.all(taustar, deltastar, false);
+        CoolPropDbl fd = rhor/rhomolarc, ft = Tr/Tc;
+        cache_pure_alpha0_deriv(_alpha0, derivs.alphar, 0, 0, fd, ft);
+        cache_pure_alpha0_deriv(_dalpha0_dDelta, derivs.dalphar_ddelta, 0, 1, fd, ft);
+        cache_pure_alpha0_deriv(_dalpha0_dTau, derivs.dalphar_dtau, 1, 0, fd, ft);
+        cache_pure_alpha0_deriv(_d2alpha0_dDelta2, derivs.d2alphar_ddelta2, 0, 2, fd, ft);
+        cache_pure_alpha0_deriv(_d2alpha0_dDelta_dTau, derivs.d2alphar_ddelta_dtau, 1, 1, fd, ft);
+        cache_pure_alpha0_deriv(_d2alpha0_dTau2, derivs.d2alphar_dtau2, 2, 0, fd, ft);
+        cache_pure_alpha0_deriv(_d3alpha0_dDelta3, derivs.d3alphar_ddelta3, 0, 3, fd, ft);
+        cache_pure_alpha0_deriv(_d3alpha0_dDelta2_dTau, derivs.d3alphar_ddelta2_dtau, 1, 2, fd, ft);
+        cache_pure_alpha0_deriv(_d3alpha0_dDelta_dTau2, derivs.d3alphar_ddelta_dtau2, 2, 1, fd, ft);
+        cache_pure_alpha0_deriv(_d3alpha0_dTau3, derivs.d3alphar_dtau3, 3, 0, fd, ft);
+    }
+    else{
+        // The same sums as in calc_alpha0_deriv_nocache, with one evaluation of the terms of each component
+        CoolPropDbl a0 = 0, da0_dDelta = 0, da0_dTau = 0, d2a0_dDelta2 = 0, d2a0_dDelta_dTau = 0, d2a0_dTau2 = 0;
+        for (std::size_t i = 0; i < mole_fractions.size(); ++i){
+            CoolPropDbl rho_ci = get_fluid_constant(i, irhomolar_critical);
+            CoolPropDbl T_ci = get_fluid_constant(i, iT_critical);
+            CoolPropDbl tau_i = T_ci*tau/Tr;
+            CoolPropDbl delta_i = delta*rhor/rho_ci;
+            HelmholtzDerivatives derivs = components[i].EOS().alpha0.all(tau_i, delta_i, false);
+
+            double logxi = (std::abs(mole_fractions[i]) > DBL_EPSILON) ? log(mole_fractions[i]) : 0;
+            a0 += mole_fractions[i]*(derivs.alphar + logxi);
+            da0_dDelta += mole_fractions[i]*rhor/rho_ci*derivs.dalphar_ddelta;
+            da0_dTau += mole_fractions[i]*T_ci/Tr*derivs.dalphar_dtau;
+            d2a0_dDelta2 += mole_fractions[i]*pow(rhor/rho_ci,2)*derivs.d2alphar_ddelta2;
+            d2a0_dDelta_dTau += mole_fractions[i]*rhor/rho_ci*T_ci/Tr*derivs.d2alphar_ddelta_dtau;
+            d2a0_dTau2 += mole_fractions[i]*pow(T_ci/Tr,2)*derivs.d2alphar_dtau2;
+        }
+        _alpha0 = a0;
+        _dalpha0_dDelta = da0_dDelta;
+        _dalpha0_dTau = da0_dTau;
+        _d2alpha0_dDelta2 = d2a0_dDelta2;
+        _d2alpha0_dDelta_dTau = d2a0_dDelta_dTau;
+        _d2alpha0_dTau2 = d2a0_dTau2;
+    }
+}
+void HelmholtzEOSMixtureBackend::calc_output_intermediates(int intermediates)
+{
+    // The outputs of two-phase states come from the saturated states
+    if (!isHomogeneousPhase() || !_tau || !_delta){ return; }
+    if ((intermediates & OutputPlan::INTERMEDIATE_ALPHAR) && !_alphar){
+        calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    }
+    if ((intermediates & OutputPlan::INTERMEDIATE_ALPHA0) && !_alpha0){
+        calc_all_alpha0_deriv_cache(mole_fractions, _tau, _delta);
+    }
+}
+
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_alphar_deriv_nocache(const int nTau, const int nDelta, const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta)
 {
     bool cache_values = false;
@@ -3369,6 +3754,52 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_first_two_phase_deriv(parameters Of
         throw ValueError("These inputs are not supported to calc_first_two_phase_deriv");
     }
 }
+void HelmholtzEOSMixtureBackend::calc_state_derivatives(const std::vector<parameters> &keys, bool second_derivatives, StateDerivatives &derivs)
+{
+    if (!isTwoPhase()){
+        AbstractState::calc_state_derivatives(keys, second_derivatives, derivs);
+        return;
+    }
+	if (!this->SatL || !this->SatV) throw ValueError(format("The saturation properties are needed for calc_state_derivatives"));
+    if (second_derivatives){
+        throw ValueError("The second derivatives of two-phase states are not available in calc_state_derivatives");
+    }
+    std::size_t N = keys.size();
+    derivs.keys = keys;
+    derivs.dX.resize(N); derivs.dY.resize(N);
+    derivs.dX2.clear(); derivs.dXdY.clear(); derivs.dY2.clear();
+    CoolPropDbl Q = _Q;
+    for (std::size_t i = 0; i < N; ++i){
+        parameters key = keys[i];
+        switch (key){
+            case iP:
+                derivs.dX[i] = 1; derivs.dY[i] = 0; break;
+            case iQ:
+                derivs.dX[i] = 0; derivs.dY[i] = 1; break;
+            case iT:
+                derivs.dX[i] = SatL->calc_first_saturation_deriv(iT, iP, *SatL, *SatV); derivs.dY[i] = 0; break;
+            case iDmolar:
+            case iDmass:
+            {
+                // The specific volume is linear in the quality; v = 1/rho; dvdrho = -1/rho^2
+                CoolPropDbl rho = keyed_output(key), rhoL = SatL->keyed_output(key), rhoV = SatV->keyed_output(key);
+                CoolPropDbl dvL_dp = -1/POW2(rhoL)*SatL->calc_first_saturation_deriv(key, iP, *SatL, *SatV);
+                CoolPropDbl dvV_dp = -1/POW2(rhoV)*SatV->calc_first_saturation_deriv(key, iP, *SatL, *SatV);
+                derivs.dX[i] = -POW2(rho)*((1 - Q)*dvL_dp + Q*dvV_dp);
+                derivs.dY[i] = -POW2(rho)*(1/rhoV - 1/rhoL);
+                break;
+            }
+            case iHmolar: case iHmass:
+            case iSmolar: case iSmass:
+            case iUmolar: case iUmass:
+                derivs.dX[i] = (1 - Q)*SatL->calc_first_saturation_deriv(key, iP, *SatL, *SatV) + Q*SatV->calc_first_saturation_deriv(key, iP, *SatL, *SatV);
+                derivs.dY[i] = SatV->keyed_output(key) - SatL->keyed_output(key);
+                break;
+            default:
+                throw ValueError(format("The parameter [%s] is not supported for two-phase states in calc_state_derivatives", get_parameter_information(key,"short").c_str()));
+        }
+    }
+}
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_first_two_phase_deriv_splined(parameters Of, parameters Wrt, parameters Constant, CoolPropDbl x_end)
 {
 	// Note: If you need all three values (drho_dh__p, drho_dp__h and rho_spline), 
@@ -3769,6 +4200,73 @@ void HelmholtzEOSMixtureBackend::calc_criticality_contour_values(double &L1star,
 void HelmholtzEOSMixtureBackend::get_critical_point_search_radii(double &R_delta, double &R_tau){
     R_delta = 0.025; R_tau = 0.1;
 }
+std::vector<CoolProp::CriticalState> HelmholtzEOSMixtureBackend::calc_all_critical_points()
+{
+    const std::size_t cache_size = static_cast<std::size_t>(std::max(get_config_double(CRITICAL_POINTS_CACHE_SIZE), 0.0));
+    for (std::list<CriticalPointsCacheEntry>::iterator it = critical_points_cache.begin(); it != critical_points_cache.end(); ++it){
+        if (it->z == mole_fractions){
+            // Move the entry to the front since it is the most recently used
+            critical_points_cache.splice(critical_points_cache.begin(), critical_points_cache, it);
+            spinodal_values = critical_points_cache.front().spinodal_values;
+            return critical_points_cache.front().critical_points;
+        }
+    }
+    bool find_critical_points = true;
+    std::vector<CoolProp::CriticalState> critical_points = _calc_all_critical_points(find_critical_points);
+    if (cache_size > 0){
+        CriticalPointsCacheEntry entry;
+        entry.z = mole_fractions;
+        entry.critical_points = critical_points;
+        entry.spinodal_values = spinodal_values;
+        critical_points_cache.push_front(entry);
+    }
+    while (critical_points_cache.size() > cache_size){
+        critical_points_cache.pop_back();
+    }
+    return critical_points;
+}
+
+std::vector<std::vector<CoolProp::CriticalState> > HelmholtzEOSMixtureBackend::calc_critical_locus(const std::vector<std::vector<CoolPropDbl> > &compositions)
+{
+    std::vector<std::vector<CoolProp::CriticalState> > locus(compositions.size());
+    const std::vector<CoolPropDbl> z_initial = mole_fractions;
+    for (std::size_t i = 0; i < compositions.size(); ++i){
+        set_mole_fractions(compositions[i]);
+        bool continued = false;
+        if (i > 0 && !locus[i-1].empty()){
+            // Continuation from the critical points of the previous composition
+            try{
+                add_critical_state();
+                critical_state->set_mole_fractions(mole_fractions);
+                critical_state->specify_phase(iphase_gas);
+                for (std::size_t j = 0; j < locus[i-1].size(); ++j){
+                    CoolProp::CriticalState crit = critical_state->calc_critical_point(locus[i-1][j].rhomolar, locus[i-1][j].T);
+                    if (!ValidNumber(crit.p) || !ValidNumber(crit.T) || crit.T < 0 || crit.rhomolar < 0){
+                        throw ValueError("invalid critical point");
+                    }
+                    locus[i].push_back(crit);
+                }
+                continued = true;
+            }
+            catch(...){
+                locus[i].clear();
+            }
+        }
+        if (!continued){
+            try{
+                locus[i] = calc_all_critical_points();
+            }
+            catch(...){
+                locus[i].clear();
+            }
+        }
+    }
+    if (!z_initial.empty()){
+        set_mole_fractions(z_initial);
+    }
+    return locus;
+}
+
 std::vector<CoolProp::CriticalState> HelmholtzEOSMixtureBackend::_calc_all_critical_points(bool find_critical_points)
 {
     // Populate the temporary class used to calculate the critical point(s)
@@ -3917,6 +4415,8 @@ void HelmholtzEOSMixtureBackend::set_reference_stateS(const std::string &referen
             throw ValueError(format("reference state string is invalid: [%s]", reference_state.c_str()));
         }
     }
+    // The linked states that have already been created use the same reference state
+    sync_linked_components();
 }
 
 /// Set the reference state based on a thermodynamic state point specified by temperature and molar density
@@ -3938,6 +4438,7 @@ void HelmholtzEOSMixtureBackend::set_reference_stateD(double T, double rhomolar,
         double delta_a2 = -deltah / (HEOS.gas_constant()*HEOS.get_reducing_state().T);
         set_fluid_enthalpy_entropy_offset(components[i], delta_a1, delta_a2, "custom");
     }
+    sync_linked_components();
 }
 
 void HelmholtzEOSMixtureBackend::set_fluid_enthalpy_entropy_offset(CoolPropFluid& component, double delta_a1, double delta_a2, const std::string &ref)
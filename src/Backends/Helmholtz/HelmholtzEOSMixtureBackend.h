@@ -12,6 +12,7 @@
 #include "Configuration.h"
 
 #include <vector>
+#include <list>
 
 namespace CoolProp {
 
@@ -19,6 +20,69 @@ class FlashRoutines;
 
 class ResidualHelmholtz;
 
+class HelmholtzEOSMixtureBackend;
+
+struct VLEWorkspace;
+
+/// The state of the reference fluid of an extended corresponding states (ECS) transport model, which is kept between calls
+struct ECSReferenceState{
+    std::string fluid_name; ///< The name of the reference fluid
+    shared_ptr<HelmholtzEOSMixtureBackend> state; ///< The reference fluid, created on first use
+    CoolPropDbl f, ///< The equivalent substance reducing ratio T/T0 of the last conformal state; negative if there is none
+                h; ///< The equivalent substance reducing ratio rhomolar0/rhomolar of the last conformal state; negative if there is none
+    ECSReferenceState() : f(-1), h(-1) {};
+};
+
+/// A state point of a composition sweep, see HelmholtzEOSMixtureBackend::update_composition_sweep
+struct CompositionSweepPoint{
+    std::vector<CoolPropDbl> z; ///< The bulk mole fractions
+    CoolProp::input_pairs input_pair; ///< The pair of inputs
+    double value1, ///< The first input value
+           value2; ///< The second input value
+};
+
+/// The solution of the previous update of a state, which is the starting point of the next update in continuation mode
+struct ContinuationState{
+    bool enabled, ///< True if continuation mode is enabled, see HelmholtzEOSMixtureBackend::set_continuation_mode
+         valid, ///< True if the previous update converged
+         updating; ///< True during an update, so that the flash routines can update the state themselves without continuation
+    phases phase; ///< The phase of the previous solution
+    CoolPropDbl Q; ///< The vapor quality of the previous solution
+    GuessesStructure guesses; ///< T, p and rhomolar of the previous solution, and for two-phase solutions the densities and compositions of the saturated phases
+    std::size_t Ncontinued, ///< The number of updates that started from the previous solution
+                Nfallback; ///< The number of updates that used the normal flash routines
+    ContinuationState() : enabled(false), valid(false), updating(false), phase(iphase_unknown), Q(_HUGE), Ncontinued(0), Nfallback(0) {};
+};
+
+/** \brief The saturated liquid or vapor child state of a HelmholtzEOSMixtureBackend, which is only created when it is first used
+ *
+ * Most states are only used for single-phase updates, which do not need the saturated states.  The child state is created
+ * from the model of its parent when it is first dereferenced, so it has the binary interaction parameters and reference state 
+ * that were set on the parent before; it is then one of the linked states of the parent, which are kept in sync with it.
+ */
+class LazyChildState{
+    HelmholtzEOSMixtureBackend *parent; ///< The state that creates the child; NULL if no child is created on first use
+    phases phase; ///< The phase imposed on the child
+    shared_ptr<HelmholtzEOSMixtureBackend> state; ///< The child, NULL until it is created
+    /// Create the child from the model of the parent, and add it to the linked states of the parent
+    void create();
+public:
+    LazyChildState() : parent(NULL), phase(iphase_not_imposed) {};
+    /// Let the parent create the child on first use, with the given imposed phase
+    void defer(HelmholtzEOSMixtureBackend *parent, phases phase){ this->parent = parent; this->phase = phase; state.reset(); };
+    /// Set the child directly; it must be added to the linked states of the parent by the caller
+    void reset(HelmholtzEOSMixtureBackend *ptr = NULL){ parent = NULL; state.reset(ptr); };
+    /// True if the child has been created
+    bool created() const { return state.get() != NULL; };
+    /// True if there is no child, and none will be created
+    bool operator!() const { return state.get() == NULL && parent == NULL; };
+    /// Get the child, creating it if needed
+    HelmholtzEOSMixtureBackend *get(){ if (state.get() == NULL && parent != NULL){ create(); } return state.get(); };
+    HelmholtzEOSMixtureBackend *operator->(){ return get(); };
+    HelmholtzEOSMixtureBackend &operator*(){ return *get(); };
+    operator shared_ptr<HelmholtzEOSMixtureBackend>(){ get(); return state; };
+};
+
 class HelmholtzEOSMixtureBackend : public AbstractState {
     
 protected:
@@ -28,6 +92,7 @@ protected:
     shared_ptr<HelmholtzEOSMixtureBackend> transient_pure_state; ///< A temporary state used for calculations of pure fluid properties
     shared_ptr<HelmholtzEOSMixtureBackend> TPD_state; ///< A temporary state used for calculations of the tangent-plane-distance
     shared_ptr<HelmholtzEOSMixtureBackend> critical_state; ///< A temporary state used for calculations of the critical point(s)
+    shared_ptr<VLEWorkspace> VLE_workspace; ///< The scratch memory of the VLE and stability routines, created on first use
     /// Update the state class used to calculate the tangent-plane-distance
     virtual void add_TPD_state(){
         if (TPD_state.get() == NULL){ bool sat_states = false; TPD_state.reset(get_copy(sat_states)); linked_states.push_back(TPD_state);
@@ -59,14 +124,86 @@ protected:
 
     static void set_fluid_enthalpy_entropy_offset(CoolPropFluid& component, double delta_a1, double delta_a2, const std::string &ref);
 
+    /// The critical points, and the spinodal traced to find them, for one composition
+    struct CriticalPointsCacheEntry{
+        std::vector<CoolPropDbl> z;
+        std::vector<CoolProp::CriticalState> critical_points;
+        SpinodalData spinodal_values;
+    };
+    std::list<CriticalPointsCacheEntry> critical_points_cache; ///< The most recently used compositions first, at most CRITICAL_POINTS_CACHE_SIZE entries
+    /// Clear the cached critical points; must be called whenever the parameters of the model are changed
+    void clear_critical_points_cache(){ critical_points_cache.clear(); };
+    
+    /// The saturated states of a pure fluid at one imposed pressure or temperature
+    struct SaturationCacheEntry{
+        parameters imposed; ///< iP or iT
+        CoolPropDbl value, TL, TV, rhomolarL, rhomolarV;
+    };
+    std::list<SaturationCacheEntry> saturation_cache; ///< The most recently used saturated states first, at most SATURATION_CACHE_SIZE entries
+    /// Clear the cached saturated states; must be called whenever the parameters of the model are changed
+    void clear_saturation_cache(){ saturation_cache.clear(); };
+    /** \brief Update SatL and SatV to the saturated states of a pure fluid at the given pressure or temperature
+     * 
+     * The saturated states found by the saturation solvers are cached, and a pressure or temperature within a relative 
+     * difference of 1e-12 of a cached one reuses its saturated densities instead of solving for them again.  A state
+     * without SatL and SatV (generate_SatL_and_SatV=false) creates a local state in \a HEOS and updates its SatL and SatV instead.
+     * 
+     * @param imposed iP to impose the pressure (with PQ_flash) or iT to impose the temperature (with saturation_T_pure)
+     * @param value The pressure in Pa or the temperature in K
+     * @param HEOS Holds the local state, if one is needed
+     * @returns The state whose SatL and SatV have been updated, either this state or the local state
+     */
+    HelmholtzEOSMixtureBackend &update_saturation_states(parameters imposed, CoolPropDbl value, shared_ptr<HelmholtzEOSMixtureBackend> &HEOS);
+    
+    ECSReferenceState viscosity_ECS_reference, ///< The reference fluid of the ECS viscosity model
+                      conductivity_ECS_reference, ///< The reference fluid of the ECS conductivity model
+                      conformal_reference; ///< The reference fluid of the last call to calc_conformal_state
+    std::vector<shared_ptr<HelmholtzEOSMixtureBackend> > transport_component_states; ///< The pure components for the approximate mixture transport models, created on first use
+    /// Get the reference fluid of an ECS model, which is only constructed if it does not exist yet or is another fluid
+    HelmholtzEOSMixtureBackend &get_ECS_reference_state(ECSReferenceState &reference, const std::string &fluid_name);
+    /// Get the state of the i-th component for the approximate mixture transport models, which is only constructed on first use
+    HelmholtzEOSMixtureBackend &get_transport_component_state(std::size_t i);
+    /// Discard the transport auxiliary states; must be called whenever the components are changed
+    void clear_transport_states(){
+        viscosity_ECS_reference = ECSReferenceState();
+        conductivity_ECS_reference = ECSReferenceState();
+        conformal_reference = ECSReferenceState();
+        transport_component_states.clear();
+    };
+
+    ContinuationState continuation; ///< The state of continuation mode, see set_continuation_mode
+    /// Update the state in continuation mode, falling back to the normal update if the flash from the previous solution fails
+    void update_with_continuation(CoolProp::input_pairs input_pair, double value1, double value2);
+    /// Keep the solution of the last update as the starting point of the next one
+    void store_continuation_state();
+
+    /// Set up this state, which must have been constructed with the default constructor, with the model of another state, see get_copy
+    void copy_model(const HelmholtzEOSMixtureBackend &source, bool generate_SatL_and_SatV);
+
+    /// Evaluate the points [ifirst, ilast) of a composition sweep with this state, see update_composition_sweep
+    void evaluate_composition_sweep(const std::vector<CompositionSweepPoint> &points, std::size_t ifirst, std::size_t ilast, const std::vector<parameters> &outputs, std::vector<std::vector<double> > &results);
+
 public:
     HelmholtzEOSMixtureBackend();
     HelmholtzEOSMixtureBackend(const std::vector<CoolPropFluid> &components, bool generate_SatL_and_SatV = true);
     HelmholtzEOSMixtureBackend(const std::vector<std::string> &component_names, bool generate_SatL_and_SatV = true);
+    /** \brief Get a new state with the model of this one
+     * 
+     * The components and the departure functions are copied, since they cache the derivatives of their last evaluation, 
+     * but the reducing function is shared with this state until the binary interaction parameters of one of them are changed
+     */
     virtual HelmholtzEOSMixtureBackend * get_copy(bool generate_SatL_and_SatV = true);
+    /** \brief Get a new state for another thread, with the model, the composition and the imposed phase of this one
+     * 
+     * This is cheaper than constructing the state again, because the components are not looked up and the mixture 
+     * parameters are not set again (see get_copy).  The state point of this state is not copied.
+     */
+    HelmholtzEOSMixtureBackend * clone();
     
     // Copy over the reducing and departure terms to all linked states (recursively)
     void sync_linked_states(const HelmholtzEOSMixtureBackend * const);
+    /// Copy the components of this state, with their reference states, to all linked states (recursively)
+    void sync_linked_components();
     
     virtual ~HelmholtzEOSMixtureBackend(){};
     std::string backend_name(void) { return get_backend_string(HEOS_BACKEND_MIX); }
@@ -92,6 +229,7 @@ public:
     friend class MixtureDerivatives; // Allows the static methods in the MixtureDerivatives class to have access to all the protected members and methods of this class
     friend class PhaseEnvelopeRoutines; // Allows the static methods in the PhaseEnvelopeRoutines class to have access to all the protected members and methods of this class
     friend class MixtureParameters; // Allows the static methods in the MixtureParameters class to have access to all the protected members and methods of this class
+    friend class LazyChildState; // Allows the child states to add themselves to the linked states of their parent
     friend class CorrespondingStatesTerm; // // Allows the methods in the CorrespondingStatesTerm class to have access to all the protected members and methods of this class
 
     // Helmholtz EOS backend uses mole fractions
@@ -151,10 +289,28 @@ public:
     CoolPropDbl calc_first_two_phase_deriv(parameters Of, parameters Wrt, parameters Constant);
     CoolPropDbl calc_second_two_phase_deriv(parameters Of, parameters Wrt1, parameters Constant1, parameters Wrt2, parameters Constant2);
     CoolPropDbl calc_first_two_phase_deriv_splined(parameters Of, parameters Wrt, parameters Constant, CoolPropDbl x_end);
+    /// For two-phase states, the derivatives are taken with respect to X = p and Y = Q and follow from those of the saturated states
+    void calc_state_derivatives(const std::vector<parameters> &keys, bool second_derivatives, StateDerivatives &derivs);
     
     CriticalState calc_critical_point(double rho0, double T0);
-    /// An overload to make the compiler (clang in this case) happy
-    std::vector<CoolProp::CriticalState> calc_all_critical_points(){ bool find_critical_points = true; return _calc_all_critical_points(find_critical_points); };
+    /** \brief Calculate all the critical points of the mixture
+     * 
+     * The results are cached by composition (see CRITICAL_POINTS_CACHE_SIZE), so that returning to a composition that
+     * has already been visited does not search the tau-delta plane again
+     */
+    std::vector<CoolProp::CriticalState> calc_all_critical_points();
+    
+    /** \brief Calculate the critical points along a path of compositions
+     * 
+     * The critical points of the first composition are found with calc_all_critical_points().  For each following composition, 
+     * the critical points of the previous composition are the starting values of the Newton-Raphson solver of calc_critical_point(), 
+     * so the compositions should be close to each other.  If that fails, or if no critical points were found for the previous 
+     * composition, calc_all_critical_points() is used.  The composition of this state is restored at the end.
+     * 
+     * @param compositions The mole fractions along the path
+     * @returns The critical points for each composition; empty if none could be found
+     */
+    std::vector<std::vector<CoolProp::CriticalState> > calc_critical_locus(const std::vector<std::vector<CoolPropDbl> > &compositions);
 
     virtual void get_critical_point_starting_values(double &delta0, double &tau0){
         delta0 = get_config_double(SPINODAL_MINIMUM_DELTA); // The value of delta where we start searching for crossing with Lstar=0 contour
@@ -183,6 +339,9 @@ public:
     /// Change the equation of state for one component
     void calc_change_EOS(const std::size_t i, const std::string &EOS_name);
 
+    /// Calculate the memory used by this state, see AbstractState::memory_footprint
+    MemoryFootprint calc_memory_footprint(void);
+
     const CoolProp::SimpleState &calc_state(const std::string &state);
 
     virtual const double get_fluid_constant(std::size_t i, parameters param)  const{
@@ -208,6 +367,8 @@ public:
     std::vector<CoolPropDbl> &get_lnK(){return lnK;};
     HelmholtzEOSMixtureBackend &get_SatL(){return *SatL;};
     HelmholtzEOSMixtureBackend &get_SatV(){return *SatV;};
+    /// Get the scratch memory of the VLE and stability routines for this state, which is created on the first call
+    VLEWorkspace &get_VLE_workspace();
     
     std::vector<CoolPropDbl> calc_mole_fractions_liquid(void){return SatL->get_mole_fractions();};
     std::vector<CoolPropDbl> calc_mole_fractions_vapor(void){return SatV->get_mole_fractions();};
@@ -220,7 +381,7 @@ public:
     void calc_conformal_state(const std::string &reference_fluid, CoolPropDbl &T, CoolPropDbl &rhomolar);
     
     void resize(std::size_t N);
-    shared_ptr<HelmholtzEOSMixtureBackend> SatL, SatV; ///<
+    LazyChildState SatL, SatV; ///< The saturated liquid and vapor states, created on first use
 
     /** \brief The standard update function
      * @param input_pair The pair of inputs that will be provided
@@ -233,6 +394,34 @@ public:
 	 * 
 	 */
 	void update_with_guesses(CoolProp::input_pairs input_pair, double Value1, double Value2, const GuessesStructure &guesses);
+
+    /** \brief Enable or disable continuation mode
+     * 
+     * In continuation mode, each update starts from the solution of the previous one: for single-phase solutions, 
+     * T and rho are found with Newton's method from the previous T and rho; for two-phase solutions the saturated states 
+     * are found from the previous saturated densities (pure fluids) or K-factors (bubble- and dew-points of mixtures).  The 
+     * solution is accepted only if it is in the same region as the previous one, as checked with the ancillary equations 
+     * (pure fluids) or the phase envelope or a stability test (mixtures); otherwise, or if there is no previous solution, 
+     * the normal flash routines are used.  The phase must not be imposed.
+     */
+    void set_continuation_mode(bool enabled){ continuation = ContinuationState(); continuation.enabled = enabled; };
+    /// Get the state of continuation mode, including the number of updates that started from the previous solution
+    const ContinuationState &get_continuation_state() const { return continuation; };
+    
+    /** \brief Evaluate a sweep of state points that each have their own composition
+     * 
+     * This is intended for ternary diagrams and optimizers that loop over composition.  The points are evaluated in order 
+     * on this state without reallocating it.  For bubble- and dew-point inputs (PQ or QT with a quality of 0 or 1), the 
+     * K-factors, saturation temperature or pressure and phase densities of the previous point are used as the starting point 
+     * of the Newton-Raphson solver, so neighbouring points should have similar compositions; if that fails, the normal 
+     * update is used.
+     * 
+     * @param points The state points to be evaluated
+     * @param outputs The keys of the outputs to be calculated at each point
+     * @param Nthreads The number of threads; if greater than one, the points are split into contiguous blocks that are evaluated concurrently, each with its own copy of this state
+     * @returns One row of outputs per point; outputs that could not be calculated are _HUGE
+     */
+    std::vector<std::vector<double> > update_composition_sweep(const std::vector<CompositionSweepPoint> &points, const std::vector<parameters> &outputs, std::size_t Nthreads = 1);
     
     /** \brief Update all the internal variables for a state by copying from another state
      */
@@ -416,6 +605,12 @@ public:
 	std::vector<std::string> calc_fluid_names(void);
 
     void calc_all_alphar_deriv_cache(const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta);
+    /// Cache the derivatives of the ideal-gas Helmholtz energy from one evaluation of the ideal-gas terms of each component
+    /**
+     * The values are those of \ref calc_alpha0_deriv_nocache; for mixtures, only the derivatives up to second order are cached.
+     */
+    void calc_all_alpha0_deriv_cache(const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta);
+    void calc_output_intermediates(int intermediates);
     virtual CoolPropDbl calc_alphar_deriv_nocache(const int nTau, const int nDelta, const std::vector<CoolPropDbl> & mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta);
 
     /**
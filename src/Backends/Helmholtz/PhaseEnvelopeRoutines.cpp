@@ -8,9 +8,81 @@
 #include "CoolPropTools.h"
 #include "Configuration.h"
 #include "CPnumerics.h"
+#include <thread>
+#include <mutex>
 
 namespace CoolProp{
 
+namespace {
+
+/// The work shared between the worker threads of PhaseEnvelopeRoutines::build_many
+struct PhaseEnvelopeBatch{
+    const std::vector<std::vector<CoolPropDbl> > *compositions;
+    std::vector<PhaseEnvelopeData> *envelopes;
+    std::string level;
+    std::size_t inext; ///< The index of the next composition to be built
+    std::mutex mutex;
+    
+    /// Take the index of the next composition to be built; return false if there are none left
+    bool take(std::size_t &i){
+        std::lock_guard<std::mutex> lock(mutex);
+        if (inext >= compositions->size()){ return false; }
+        i = inext++;
+        return true;
+    }
+};
+
+/// Build phase envelopes with the worker's own copy of the backend until no compositions are left
+void build_phase_envelopes(HelmholtzEOSMixtureBackend *HEOS, PhaseEnvelopeBatch *batch)
+{
+    std::size_t i;
+    while (batch->take(i)){
+        try{
+            HEOS->set_mole_fractions((*batch->compositions)[i]);
+            HEOS->build_phase_envelope(batch->level);
+            (*batch->envelopes)[i] = HEOS->get_phase_envelope_data();
+        }
+        catch(...){
+            (*batch->envelopes)[i] = PhaseEnvelopeData();
+        }
+    }
+}
+
+} /* namespace */
+
+std::vector<PhaseEnvelopeData> PhaseEnvelopeRoutines::build_many(HelmholtzEOSMixtureBackend &HEOS, const std::vector<std::vector<CoolPropDbl> > &compositions, const std::string &level, std::size_t Nthreads)
+{
+    std::vector<PhaseEnvelopeData> envelopes(compositions.size());
+    if (compositions.empty()){ return envelopes; }
+    if (Nthreads == 0){
+        Nthreads = std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()), static_cast<std::size_t>(1));
+    }
+    Nthreads = std::min(Nthreads, compositions.size());
+    
+    PhaseEnvelopeBatch batch;
+    batch.compositions = &compositions;
+    batch.envelopes = &envelopes;
+    batch.level = level;
+    batch.inext = 0;
+    
+    // The copies are all made here so that the workers never touch HEOS
+    std::vector<shared_ptr<HelmholtzEOSMixtureBackend> > copies;
+    for (std::size_t i = 0; i < Nthreads; ++i){
+        copies.push_back(shared_ptr<HelmholtzEOSMixtureBackend>(HEOS.get_copy()));
+    }
+    
+    // The calling thread is the last of the workers
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i + 1 < Nthreads; ++i){
+        threads.push_back(std::thread(build_phase_envelopes, copies[i].get(), &batch));
+    }
+    build_phase_envelopes(copies.back().get(), &batch);
+    for (std::size_t i = 0; i < threads.size(); ++i){
+        threads[i].join();
+    }
+    return envelopes;
+}
+
 void PhaseEnvelopeRoutines::build(HelmholtzEOSMixtureBackend &HEOS, const std::string &level)
 {
 	if (HEOS.get_mole_fractions_ref().empty()){
@@ -169,6 +241,13 @@ void PhaseEnvelopeRoutines::build(HelmholtzEOSMixtureBackend &HEOS, const std::s
         std::size_t iter = 0, //< The iteration counter
                     iter0 = 0; //< A reference point for the counter, can be increased to go back to linear interpolation
         CoolPropDbl factor = 1.05;
+        
+        // The extrapolated guesses for T and x are kept so that the error of the extrapolation can
+        // be used to control the step size; a negative tolerance switches back to the heuristic based 
+        // on the number of Newton-Raphson steps
+        const double extrapolation_tolerance = get_config_double(PHASE_ENVELOPE_EXTRAPOLATION_TOLERANCE);
+        CoolPropDbl T_extrapolated = _HUGE;
+        std::vector<CoolPropDbl> x_extrapolated;
 
         for (;;)
         {
@@ -240,6 +319,13 @@ void PhaseEnvelopeRoutines::build(HelmholtzEOSMixtureBackend &HEOS, const std::s
             // The last mole fraction is sum of N-1 first elements
             IO.x[IO.x.size()-1] = 1 - std::accumulate(IO.x.begin(), IO.x.end()-1, 0.0);
             
+            // Keep the extrapolated values to compare with the converged solution
+            bool extrapolated = (!dont_extrapolate && iter - iter0 >= 2);
+            if (extrapolated){
+                T_extrapolated = IO.T;
+                x_extrapolated = IO.x;
+            }
+            
             // Uncomment to check guess values for Newton-Raphson
             //std::cout << "\t\tdv " << IO.rhomolar_vap << " dl " << IO.rhomolar_liq << " T " << IO.T << " x " << vec_to_string(IO.x, "%0.10Lg") << std::endl;
             
@@ -320,10 +406,28 @@ void PhaseEnvelopeRoutines::build(HelmholtzEOSMixtureBackend &HEOS, const std::s
             
             dont_extrapolate = false;
             if (iter < 5){continue;}
+            
+            // The error of the extrapolated guess relative to the converged solution
+            CoolPropDbl extrapolation_error = -1;
+            if (extrapolated){
+                extrapolation_error = std::abs(T_extrapolated/IO.T - 1);
+                for (std::size_t i = 0; i < IO.x.size(); ++i){
+                    extrapolation_error = std::max(extrapolation_error, std::abs(x_extrapolated[i] - IO.x[i]));
+                }
+            }
+            
             if (IO.Nsteps > 10)
             {
                 factor = 1 + (factor-1)/10;
             }
+            else if (extrapolation_tolerance > 0 && extrapolation_error >= 0 && std::abs(IO.rhomolar_liq/IO.rhomolar_vap-1) >= 4)
+            {
+                // Error-controlled step away from the critical point; the error of the polynomial extrapolation 
+                // goes at least like the cube of the step, so scale the step to bring the error to the tolerance,
+                // without changing the step by more than a factor of two at a time
+                CoolPropDbl ratio = pow(extrapolation_tolerance/std::max(extrapolation_error, static_cast<CoolPropDbl>(1e-14)), 1.0/3.0);
+                factor = 1 + (factor-1)*std::min(static_cast<CoolPropDbl>(2.0), std::max(static_cast<CoolPropDbl>(0.5), ratio));
+            }
             else if (IO.Nsteps > 5)
             {
                 factor = 1 + (factor-1)/3;
@@ -481,8 +585,11 @@ double PhaseEnvelopeRoutines::evaluate(const PhaseEnvelopeData &env, parameters
 }
 void PhaseEnvelopeRoutines::finalize(HelmholtzEOSMixtureBackend &HEOS)
 {
-    // No finalization for pure or pseudo-pure fluids
-    if (HEOS.get_mole_fractions_ref().size() == 1){return;}
+    // No finalization for pure or pseudo-pure fluids other than indexing the curves
+    if (HEOS.get_mole_fractions_ref().size() == 1){
+        HEOS.PhaseEnvelope.build_index();
+        return;
+    }
     
     enum maxima_points {PMAX_SAT = 0, TMAX_SAT = 1};
     std::size_t imax; // Index of the maximal temperature or pressure
@@ -616,28 +723,36 @@ void PhaseEnvelopeRoutines::finalize(HelmholtzEOSMixtureBackend &HEOS)
     
     // Find the index of the point with the highest pressure
     env.ipsat_max = std::distance(env.p.begin(), std::max_element(env.p.begin(), env.p.end()));
+    
+    // Index the monotone pieces of the curves so that find_intersections and is_inside are O(log n)
+    env.build_index();
 }
 
 std::vector<std::pair<std::size_t, std::size_t> > PhaseEnvelopeRoutines::find_intersections(const PhaseEnvelopeData &env, parameters iInput, double value)
 {
     std::vector<std::pair<std::size_t, std::size_t> > intersections;
     
-    for (std::size_t i = 0; i < env.p.size()-1; ++i){
-        bool matched = false;
-        switch(iInput){
-            case iP:
-                if (is_in_closed_range(env.p[i], env.p[i+1], value)){ matched = true; } break;
-            case iT:
-                if (is_in_closed_range(env.T[i], env.T[i+1], value)){ matched = true; } break;
-            case iHmolar:
-                if (is_in_closed_range(env.hmolar_vap[i], env.hmolar_vap[i+1], value)){ matched = true; } break;
-            case iSmolar:
-                if (is_in_closed_range(env.smolar_vap[i], env.smolar_vap[i+1], value)){ matched = true; } break;
-            default:
-                throw ValueError(format("bad index to find_intersections"));
-        }
-        
-        if (matched){
+    std::vector<double> const *x;
+    PhaseEnvelopeMonotoneIndex const *index;
+    switch(iInput){
+        case iP: x = &(env.p); index = &(env.p_index); break;
+        case iT: x = &(env.T); index = &(env.T_index); break;
+        case iHmolar: x = &(env.hmolar_vap); index = &(env.hmolar_vap_index); break;
+        case iSmolar: x = &(env.smolar_vap); index = &(env.smolar_vap_index); break;
+        case iDmolar: x = &(env.rhomolar_vap); index = &(env.rhomolar_vap_index); break;
+        default:
+            throw ValueError(format("bad index to find_intersections"));
+    }
+    
+    // If the index is available and up to date, bisect each of the monotone pieces
+    if (!index->empty() && index->pieces.back().ilast + 1 == x->size()){
+        index->find_segments(*x, value, intersections);
+        return intersections;
+    }
+    
+    // Otherwise, fall back to checking each segment
+    for (std::size_t i = 0; i + 1 < x->size(); ++i){
+        if (is_in_closed_range((*x)[i], (*x)[i+1], value)){
             intersections.push_back(std::pair<std::size_t, std::size_t>(i, i+1)); 
         }
     }
@@ -752,6 +867,22 @@ bool PhaseEnvelopeRoutines::is_inside(const PhaseEnvelopeData &env, parameters i
 		throw ValueError("You have a funny number of intersections in is_inside");
 	}
 }
+std::vector<bool> PhaseEnvelopeRoutines::is_inside(const PhaseEnvelopeData &env, parameters iInput1, const std::vector<double> &values1, parameters iInput2, const std::vector<double> &values2)
+{
+    if (values1.size() != values2.size()){
+        throw ValueError(format("Sizes of values1 [%d] and values2 [%d] to is_inside do not match", values1.size(), values2.size()));
+    }
+    std::vector<bool> inside(values1.size(), false);
+    std::size_t iclosest;
+    SimpleState closest_state;
+    for (std::size_t i = 0; i < values1.size(); ++i){
+        // No intersections at all means that the primary value is outside the range of the phase envelope,
+        // which is an error for a single point, but just means "outside" when classifying a grid of points
+        if (find_intersections(env, iInput1, values1[i]).empty()){ continue; }
+        inside[i] = is_inside(env, iInput1, values1[i], iInput2, values2[i], iclosest, closest_state);
+    }
+    return inside;
+}
 
 } /* namespace CoolProp */
 
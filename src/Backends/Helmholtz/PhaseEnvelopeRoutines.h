@@ -13,6 +13,21 @@ class PhaseEnvelopeRoutines{
      */
     static void build(HelmholtzEOSMixtureBackend &HEOS, const std::string &level = "");
     
+    /** \brief Build the phase envelopes for a set of compositions concurrently
+     *
+     * The compositions are distributed over a pool of worker threads, each of which has its own copy of
+     * the HelmholtzEOSMixtureBackend instance.  Each phase envelope is built and finalized in the same way 
+     * as in HelmholtzEOSMixtureBackend::calc_phase_envelope, so the results are identical to those of a 
+     * serial build.  If the phase envelope cannot be built for a composition, the corresponding entry is 
+     * an empty PhaseEnvelopeData with built = false.
+     *
+     * @param HEOS The HelmholtzEOSMixtureBackend instance that is copied for each of the workers; it is not modified
+     * @param compositions The mole fractions for each of the phase envelopes
+     * @param level The refinement level, as in build()
+     * @param Nthreads The number of worker threads; if zero, the number of hardware threads is used
+     */
+    static std::vector<PhaseEnvelopeData> build_many(HelmholtzEOSMixtureBackend &HEOS, const std::vector<std::vector<CoolPropDbl> > &compositions, const std::string &level = "", std::size_t Nthreads = 0);
+    
     /** \brief Refine the phase envelope, adding points in places that are sparse
      *
      * @param HEOS The HelmholtzEOSMixtureBackend instance to be used
@@ -32,6 +47,9 @@ class PhaseEnvelopeRoutines{
      * can be used to determine whether another input is "inside" or "outside" the phase
      * boundary.
      * 
+     * Once the phase envelope has been finalized, the curves are indexed by monotone pieces, 
+     * and the lookup is O(log n) in the number of points in the phase envelope.
+     * 
      * @param env The PhaseEnvelopeData instance to be used
      * @param iInput The key for the variable type that is to be checked
      * @param value The value associated with iInput
@@ -49,6 +67,19 @@ class PhaseEnvelopeRoutines{
      * @param closest_state A SimpleState corresponding to the closest point found on the phase envelope
      */
     static bool is_inside(const PhaseEnvelopeData &env, parameters iInput1, CoolPropDbl value1, parameters iInput2, CoolPropDbl value2, std::size_t &iclosest, SimpleState &closest_state);
+    
+    /** \brief Determine whether each of an array of pairs of inputs is inside or outside the phase envelope
+     * 
+     * This can be used to pre-classify a whole grid of points, for instance (p, T) points before a flash.  Points for 
+     * which the first input is outside the range of the phase envelope are considered to be outside.
+     * 
+     * @param env The PhaseEnvelopeData instance to be used
+     * @param iInput1 The key for the first input
+     * @param values1 The values of the first input
+     * @param iInput2 The key for the second input
+     * @param values2 The values of the second input, the same length as values1
+     */
+    static std::vector<bool> is_inside(const PhaseEnvelopeData &env, parameters iInput1, const std::vector<double> &values1, parameters iInput2, const std::vector<double> &values2);
 
     static double evaluate(const PhaseEnvelopeData &env, parameters output, parameters iInput1, double value1, std::size_t &i);
 };
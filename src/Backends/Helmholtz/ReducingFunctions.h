@@ -36,6 +36,9 @@ public:
     
     virtual ReducingFunction *copy() = 0;
 
+    /// The bytes used by the reducing function, including the instance itself
+    virtual std::size_t bytes() const = 0;
+
     virtual void set_binary_interaction_double(const std::size_t i, const std::size_t j, const std::string &parameter, double value) = 0;
     
     virtual double get_binary_interaction_double(const std::size_t i, const std::size_t j, const std::string &parameter) const = 0;
@@ -160,6 +163,13 @@ public:
         return new GERG2008ReducingFunction(pFluids, beta_v, gamma_v, beta_T, gamma_T);
     };
 
+    std::size_t bytes() const{
+        std::size_t b = sizeof(*this) + heap_bytes(v_c) + heap_bytes(T_c) + heap_bytes(beta_v) + heap_bytes(gamma_v) + heap_bytes(beta_T) + heap_bytes(gamma_T)
+                      + heap_bytes(Yc_T) + heap_bytes(Yc_v) + pFluids.capacity()*sizeof(CoolPropFluid);
+        for (std::size_t i = 0; i < pFluids.size(); ++i){ b += pFluids[i].heap_bytes(); }
+        return b;
+    };
+
     /// Default destructor
     ~GERG2008ReducingFunction(){};
 
@@ -503,6 +513,7 @@ public:
     ReducingFunction * copy(){
         return new ConstantReducingFunction(T_c, rhomolar_c);
     };
+    std::size_t bytes() const{ return sizeof(*this); };
 
     void set_binary_interaction_double(const std::size_t i, const std::size_t j, const std::string &parameter, double value){return;}
     double get_binary_interaction_double(const std::size_t i, const std::size_t j, const std::string &parameter) const{return _HUGE; }
@@ -1230,15 +1230,53 @@ void TransportRoutines::conformal_state_solver(HelmholtzEOSMixtureBackend &HEOS,
     while(std::abs(resid) > 1e-9);
 }
 
-CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference)
+void TransportRoutines::conformal_state_solver_warm_start(HelmholtzEOSMixtureBackend &HEOS, ECSReferenceState &Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0)
 {
+    HelmholtzEOSMixtureBackend &HEOS_Reference = *Reference.state;
+    
+    // The equivalent substance reducing ratios only vary slowly with the state, so those
+    // of the last conformal state are a good starting point
+    if (Reference.f > 0 && Reference.h > 0){
+        T0 = HEOS.T()/Reference.f;
+        rhomolar0 = HEOS.rhomolar()*Reference.h;
+        try{
+            conformal_state_solver(HEOS, HEOS_Reference, T0, rhomolar0);
+            Reference.f = HEOS.T()/T0;
+            Reference.h = rhomolar0/HEOS.rhomolar();
+            return;
+        }
+        catch(std::exception &){
+            // Start again from the critical parameters
+        }
+    }
+    
+    // ************************************
+    // Start with a guess for theta and phi
+    // ************************************
+    CoolPropDbl theta = 1;
+    CoolPropDbl phi = 1;
+
+    // The equivalent substance reducing ratios
+    CoolPropDbl f = HEOS.T_critical()/HEOS_Reference.T_critical()*theta;
+    CoolPropDbl h = HEOS_Reference.rhomolar_critical()/HEOS.rhomolar_critical()*phi; // Must be the ratio of MOLAR densities!!
+
+    // Initial values for the conformal state
+    T0 = HEOS.T()/f;
+    rhomolar0 = HEOS.rhomolar()*h;
+    
+    Reference.f = -1; Reference.h = -1;
+    conformal_state_solver(HEOS, HEOS_Reference, T0, rhomolar0);
+    Reference.f = HEOS.T()/T0;
+    Reference.h = rhomolar0/HEOS.rhomolar();
+}
+
+CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, ECSReferenceState &Reference)
+{
+    HelmholtzEOSMixtureBackend &HEOS_Reference = *Reference.state;
+    
     // Collect some parameters
     CoolPropDbl M = HEOS.molar_mass(),
-                M0 = HEOS_Reference.molar_mass(),
-                Tc = HEOS.T_critical(),
-                Tc0 = HEOS_Reference.T_critical(),
-                rhocmolar = HEOS.rhomolar_critical(),
-                rhocmolar0 = HEOS_Reference.rhomolar_critical();
+                M0 = HEOS_Reference.molar_mass();
 
     // Get a reference to the ECS data
     CoolProp::ViscosityECSVariables &ECS = HEOS.components[0].transport.viscosity_ecs;
@@ -1252,19 +1290,8 @@ CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, H
     // The dilute gas portion for the fluid of interest [Pa-s]
     CoolPropDbl eta_dilute = viscosity_dilute_kinetic_theory(HEOS);
 
-    // ************************************
-    // Start with a guess for theta and phi
-    // ************************************
-    CoolPropDbl theta = 1;
-    CoolPropDbl phi = 1;
-
-    // The equivalent substance reducing ratios
-    CoolPropDbl f = Tc/Tc0*theta;
-    CoolPropDbl h = rhocmolar0/rhocmolar*phi; // Must be the ratio of MOLAR densities!!
-
     // To be solved for
-    CoolPropDbl T0 = HEOS.T()/f;
-    CoolPropDbl rhomolar0 = HEOS.rhomolar()*h;
+    CoolPropDbl T0, rhomolar0;
     
     // **************************
     // Solver for conformal state
@@ -1273,14 +1300,14 @@ CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, H
 	// 
 	HEOS_Reference.specify_phase(iphase_gas); // something homogeneous
 	
-    conformal_state_solver(HEOS, HEOS_Reference, T0, rhomolar0);
+    conformal_state_solver_warm_start(HEOS, Reference, T0, rhomolar0);
 	
     // Update the reference fluid with the updated conformal state
     HEOS_Reference.update_DmolarT_direct(rhomolar0*psi, T0);
 	
 	// Recalculate ESRR
-	f = HEOS.T()/T0;
-    h = rhomolar0/HEOS.rhomolar(); // Must be the ratio of MOLAR densities!!
+	CoolPropDbl f = HEOS.T()/T0;
+    CoolPropDbl h = rhomolar0/HEOS.rhomolar(); // Must be the ratio of MOLAR densities!!
     
     // **********************
     // Remaining calculations
@@ -1327,16 +1354,14 @@ CoolPropDbl TransportRoutines::viscosity_rhosr(HelmholtzEOSMixtureBackend &HEOS)
     return etastar_fluid*eta_dilute;
 }
 
-CoolPropDbl TransportRoutines::conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference)
+CoolPropDbl TransportRoutines::conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS, ECSReferenceState &Reference)
 {
+    HelmholtzEOSMixtureBackend &HEOS_Reference = *Reference.state;
+    
     // Collect some parameters
     CoolPropDbl M = HEOS.molar_mass(),
                 M_kmol = M*1000,
                 M0 = HEOS_Reference.molar_mass(),
-                Tc = HEOS.T_critical(),
-                Tc0 = HEOS_Reference.T_critical(),
-                rhocmolar = HEOS.rhomolar_critical(),
-                rhocmolar0 = HEOS_Reference.rhomolar_critical(),
                 R_u = HEOS.gas_constant(),
                 R = HEOS.gas_constant()/HEOS.molar_mass(), //[J/kg/K]
                 R_kJkgK = R_u/M_kmol;
@@ -1368,27 +1393,15 @@ CoolPropDbl TransportRoutines::conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS
     // The dilute gas contribution to the thermal conductivity [W/m/K]
     CoolPropDbl lambda_dilute = 15.0e-3/4.0*R_kJkgK*eta_dilute;
 
-    // ************************************
-    // Start with a guess for theta and phi
-    // ************************************
-    
-    CoolPropDbl theta = 1;
-    CoolPropDbl phi = 1;
-
-    // The equivalent substance reducing ratios
-    CoolPropDbl f = Tc/Tc0*theta;
-    CoolPropDbl h = rhocmolar0/rhocmolar*phi; // Must be the ratio of MOLAR densities!!
-
-    // Initial values for the conformal state
-    CoolPropDbl T0 = HEOS.T()/f;
-    CoolPropDbl rhomolar0 = HEOS.rhomolar()*h;
+    // The conformal state
+    CoolPropDbl T0, rhomolar0;
     
     // **************************
     // Solver for conformal state
     // **************************
 
     try{
-        conformal_state_solver(HEOS, HEOS_Reference, T0, rhomolar0);
+        conformal_state_solver_warm_start(HEOS, Reference, T0, rhomolar0);
     }
     catch(std::exception &e){
         throw ValueError(format("Conformal state solver failed; error was %s",e.what()));
@@ -1398,8 +1411,8 @@ CoolPropDbl TransportRoutines::conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS
     HEOS_Reference.update(DmolarT_INPUTS, rhomolar0*psi, T0);
 	
 	// Recalculate ESRR
-	f = HEOS.T()/T0;
-    h = rhomolar0/HEOS.rhomolar(); // Must be the ratio of MOLAR densities!!
+	CoolPropDbl f = HEOS.T()/T0;
+    CoolPropDbl h = rhomolar0/HEOS.rhomolar(); // Must be the ratio of MOLAR densities!!
 
     // The reference fluid's contribution to the conductivity [W/m/K]
     CoolPropDbl lambda_resid = HEOS_Reference.calc_conductivity_background();
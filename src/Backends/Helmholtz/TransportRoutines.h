@@ -267,17 +267,22 @@ public:
 
 
     */
-    static CoolPropDbl viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference);
+    static CoolPropDbl viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, ECSReferenceState &Reference);
 
     static CoolPropDbl viscosity_rhosr(HelmholtzEOSMixtureBackend &HEOS);
     
-    static CoolPropDbl conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference);
+    static CoolPropDbl conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS, ECSReferenceState &Reference);
 
     /* \brief Solver for the conformal state for ECS model
      * 
      */
     static void conformal_state_solver(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0);
 
+    /* \brief Solve for the conformal state of the ECS model, starting from the equivalent substance reducing ratios of the
+     * previous conformal state if there is one (and from the ratios of the critical parameters otherwise), and store the new ratios
+     */
+    static void conformal_state_solver_warm_start(HelmholtzEOSMixtureBackend &HEOS, ECSReferenceState &Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0);
+
 }; /* class TransportRoutines */
 
 }; /* namespace CoolProp */
@@ -5,6 +5,7 @@
 #include "MixtureDerivatives.h"
 #include "Configuration.h"
 #include "FlashRoutines.h"
+#include "MemoryFootprint.h"
 
 namespace CoolProp {
     
@@ -176,10 +177,17 @@ void SaturationSolvers::saturation_PHSU_pure(HelmholtzEOSMixtureBackend &HEOS, C
     CoolPropDbl deltaL=0, deltaV=0, tau=0, error;
     int iter=0, specified_parameter;
 
-    // Use the density ancillary function as the starting point for the solver
+    // Use the guesses if they are given, otherwise the density ancillary function as the starting point for the solver
+    bool use_guesses = options.use_guesses;
     try
     {
-        if (options.specified_variable == saturation_PHSU_pure_options::IMPOSED_PL || options.specified_variable == saturation_PHSU_pure_options::IMPOSED_PV)
+        if (use_guesses)
+        {
+            T = options.T;
+            rhoL = options.rhoL;
+            rhoV = options.rhoV;
+        }
+        else if (options.specified_variable == saturation_PHSU_pure_options::IMPOSED_PL || options.specified_variable == saturation_PHSU_pure_options::IMPOSED_PV)
         {
             // Invert liquid density ancillary to get temperature
             // TODO: fit inverse ancillaries too
@@ -315,28 +323,36 @@ void SaturationSolvers::saturation_PHSU_pure(HelmholtzEOSMixtureBackend &HEOS, C
         {
             throw ValueError(format("options.specified_variable to saturation_PHSU_pure [%d] is invalid",options.specified_variable));
         }
-        // If T from the ancillaries is above the critical temp, this will cause failure 
-        // in ancillaries for rhoV and rhoL, decrease if needed
-        T = std::min(T, static_cast<CoolPropDbl>(HEOS.T_critical()-0.1));
+        if (!use_guesses)
+        {
+            // If T from the ancillaries is above the critical temp, this will cause failure 
+            // in ancillaries for rhoV and rhoL, decrease if needed
+            T = std::min(T, static_cast<CoolPropDbl>(HEOS.T_critical()-0.1));
 
-        // Evaluate densities from the ancillary equations
-        rhoV = HEOS.get_components()[0].ancillaries.rhoV.evaluate(T);
-        rhoL = HEOS.get_components()[0].ancillaries.rhoL.evaluate(T);
+            // Evaluate densities from the ancillary equations
+            rhoV = HEOS.get_components()[0].ancillaries.rhoV.evaluate(T);
+            rhoL = HEOS.get_components()[0].ancillaries.rhoL.evaluate(T);
 
-        // Apply a single step of Newton's method to improve guess value for liquid
-        // based on the error between the gas pressure (which is usually very close already)
-        // and the liquid pressure, which can sometimes (especially at low pressure),
-        // be way off, and often times negative
-        SatL->update(DmolarT_INPUTS, rhoL, T);
-        SatV->update(DmolarT_INPUTS, rhoV, T);
-        double rhoL_updated = rhoL -(SatL->p()-SatV->p())/SatL->first_partial_deriv(iP, iDmolar, iT);
+            // Apply a single step of Newton's method to improve guess value for liquid
+            // based on the error between the gas pressure (which is usually very close already)
+            // and the liquid pressure, which can sometimes (especially at low pressure),
+            // be way off, and often times negative
+            SatL->update(DmolarT_INPUTS, rhoL, T);
+            SatV->update(DmolarT_INPUTS, rhoV, T);
+            double rhoL_updated = rhoL -(SatL->p()-SatV->p())/SatL->first_partial_deriv(iP, iDmolar, iT);
         
-        // Accept the update if the liquid density is greater than the vapor density
-        if (rhoL_updated > rhoV){ rhoL = rhoL_updated; }
+            // Accept the update if the liquid density is greater than the vapor density
+            if (rhoL_updated > rhoV){ rhoL = rhoL_updated; }
         
-        // Update the state again with the better guess for the liquid density
-        SatL->update(DmolarT_INPUTS, rhoL, T);
-        SatV->update(DmolarT_INPUTS, rhoV, T);
+            // Update the state again with the better guess for the liquid density
+            SatL->update(DmolarT_INPUTS, rhoL, T);
+            SatV->update(DmolarT_INPUTS, rhoV, T);
+        }
+        else
+        {
+            SatL->update(DmolarT_INPUTS, rhoL, T);
+            SatV->update(DmolarT_INPUTS, rhoV, T);
+        }
 
         deltaL = rhoL/reduce.rhomolar;
         deltaV = rhoV/reduce.rhomolar;
@@ -1101,7 +1117,8 @@ void SaturationSolvers::successive_substitution(HelmholtzEOSMixtureBackend &HEOS
     int iter = 1;
     CoolPropDbl change, f, df, deriv_liq, deriv_vap;
     std::size_t N = z.size();
-    std::vector<CoolPropDbl> ln_phi_liq, ln_phi_vap;
+    VLEWorkspace &workspace = HEOS.get_VLE_workspace();
+    std::vector<CoolPropDbl> &ln_phi_liq = workspace.ln_phi_liq, &ln_phi_vap = workspace.ln_phi_vap;
     ln_phi_liq.resize(N); ln_phi_vap.resize(N);
 
     std::vector<CoolPropDbl> &x = HEOS.SatL->get_mole_fractions_ref(), &y = HEOS.SatV->get_mole_fractions_ref();
@@ -1359,7 +1376,10 @@ void SaturationSolvers::newton_raphson_saturation::call(HelmholtzEOSMixtureBacke
 
         // Solve for the step; v is the step with the contents
         // [delta(x_0), delta(x_1), ..., delta(x_{N-2}), delta(spec)]
-        Eigen::VectorXd v = J.colPivHouseholderQr().solve(-r);
+        // The decomposition and the step reuse their storage from the previous iterations and calls
+        QR.compute(J);
+        step = QR.solve(-r);
+        const Eigen::VectorXd &v = step;
         
         if (bubble_point){
             for (unsigned int i = 0; i < N-1; ++i){
@@ -1594,7 +1614,9 @@ void SaturationSolvers::newton_raphson_twophase::call(HelmholtzEOSMixtureBackend
         // std::cout << vec_to_string(J, "%0.12Lg") << std::endl;
         // std::cout << vec_to_string(negative_r, "%0.12Lg") << std::endl;
         
-        Eigen::VectorXd v = J.colPivHouseholderQr().solve(-r);
+        QR.compute(J);
+        step = QR.solve(-r);
+        const Eigen::VectorXd &v = step;
 
         for (unsigned int i = 0; i < N-1; ++i){
             err_rel[i] = v[i]/x[i];
@@ -1710,6 +1732,25 @@ void SaturationSolvers::newton_raphson_twophase::build_arrays()
     error_rms = r.norm(); // Square-root (The R in RMS)
 }
     
+/// The bytes allocated by the storage of the decomposition of a square matrix
+static std::size_t QR_heap_bytes(const Eigen::ColPivHouseholderQR<Eigen::MatrixXd> &QR){
+    const std::size_t n = static_cast<std::size_t>(QR.cols());
+    // The factors; the Householder coefficients, the column norms and the temporary row; the permutation and the transpositions
+    return static_cast<std::size_t>(QR.rows())*n*sizeof(double) + 4*n*sizeof(double) + 2*n*sizeof(int);
+}
+std::size_t VLEWorkspace::heap_bytes() const{
+    std::size_t bytes = (saturation.J.size() + saturation.r.size() + saturation.err_rel.size() + saturation.step.size())*sizeof(double)
+                      + QR_heap_bytes(saturation.QR) + CoolProp::heap_bytes(saturation.K) + CoolProp::heap_bytes(saturation.x) + CoolProp::heap_bytes(saturation.y)
+                      + CoolProp::heap_bytes(saturation.step_logger);
+    bytes += (twophase.J.size() + twophase.r.size() + twophase.err_rel.size() + twophase.step.size())*sizeof(double)
+           + QR_heap_bytes(twophase.QR) + CoolProp::heap_bytes(twophase.K) + CoolProp::heap_bytes(twophase.x) + CoolProp::heap_bytes(twophase.y)
+           + CoolProp::heap_bytes(twophase.z) + CoolProp::heap_bytes(twophase.step_logger);
+    bytes += CoolProp::heap_bytes(ln_phi_liq) + CoolProp::heap_bytes(ln_phi_vap);
+    const std::vector<double> *vectors[] = {&lnK, &K, &K0, &x, &y, &xL, &xH, &fugacity_coefficient0, &fugacity0, &tpdL, &tpdH};
+    for (std::size_t i = 0; i < sizeof(vectors)/sizeof(vectors[0]); ++i){ bytes += CoolProp::heap_bytes(*vectors[i]); }
+    return bytes;
+}
+
 class RachfordRiceResidual: public FuncWrapper1DWithDeriv{
     private:
         const std::vector<double> &z, &lnK;
@@ -1804,7 +1845,9 @@ void StabilityRoutines::StabilityEvaluationClass::successive_substitution(int nu
     }
 }
 void StabilityRoutines::StabilityEvaluationClass::check_stability(){
-    std::vector<double> tpdL, tpdH;
+    VLEWorkspace &workspace = HEOS.get_VLE_workspace();
+    std::vector<double> &tpdL = workspace.tpdL, &tpdH = workspace.tpdH;
+    tpdL.clear(); tpdH.clear();
     
     // Calculate the temperature and pressure to be used
     double the_T = (m_T > 0 && m_p > 0) ? m_T : HEOS.T();
@@ -1845,7 +1888,8 @@ void StabilityRoutines::StabilityEvaluationClass::check_stability(){
     HEOS.update_DmolarT_direct(rho_bulk, the_T);
     
     // Calculate the fugacity coefficient at initial composition of the bulk phase
-    std::vector<double> fugacity_coefficient0(z.size()), fugacity0(z.size());
+    std::vector<double> &fugacity_coefficient0 = workspace.fugacity_coefficient0, &fugacity0 = workspace.fugacity0;
+    fugacity_coefficient0.resize(z.size()); fugacity0.resize(z.size());
     for (std::size_t i = 0; i < z.size(); ++i){
         fugacity_coefficient0[i] = HEOS.fugacity_coefficient(i);
         fugacity0[i] = HEOS.fugacity(i);
@@ -1988,7 +2032,9 @@ void StabilityRoutines::StabilityEvaluationClass::rho_TP_SRK_translated(){
             //std::cout << vec_to_string(J, "%0.12Lg") << std::endl;
             //std::cout << vec_to_string(-r, "%0.12Lg") << std::endl;
             
-            Eigen::VectorXd v = J.colPivHouseholderQr().solve(-r);
+            QR.compute(J);
+            step = QR.solve(-r);
+            const Eigen::VectorXd &v = step;
             
             for (unsigned int i = 0; i < N-1; ++i){
                 err_rel[i] = v[i]/IO.x[i];
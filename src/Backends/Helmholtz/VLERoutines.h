@@ -3,6 +3,7 @@
 #define VLEROUTINES_H
 
 #include "HelmholtzEOSMixtureBackend.h"
+#include "Eigen/QR"
 
 namespace CoolProp{
 
@@ -67,7 +68,7 @@ namespace SaturationSolvers
         specified_variable_options specified_variable;
         CoolPropDbl omega, rhoL, rhoV, pL, pV, T, p;
         saturation_PHSU_pure_options() : use_logdelta(true), rhoL(_HUGE), rhoV(_HUGE), pL(_HUGE), pV(_HUGE), T(_HUGE), p(_HUGE)
-            { specified_variable = IMPOSED_INVALID_INPUT; use_guesses = true; omega = 1.0; }
+            { specified_variable = IMPOSED_INVALID_INPUT; use_guesses = false; omega = 1.0; }
     };
     /**
 
@@ -314,7 +315,9 @@ namespace SaturationSolvers
         bool logging;
         int Nsteps;
         Eigen::MatrixXd J;
-        Eigen::Vector2d r, err_rel;
+        Eigen::VectorXd r, err_rel;
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> QR; ///< The decomposition of the Jacobian, which keeps its storage between steps
+        Eigen::VectorXd step; ///< The step of the last iteration
         std::vector<CoolPropDbl> K, x, y, z;
         std::vector<SuccessiveSubstitutionStep> step_logger;
 
@@ -401,6 +404,8 @@ namespace SaturationSolvers
         CoolPropDbl dTsat_dPsat, dPsat_dTsat;
         std::vector<CoolPropDbl> K, x, y;
         Eigen::VectorXd r, err_rel;
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> QR; ///< The decomposition of the Jacobian, which keeps its storage between steps
+        Eigen::VectorXd step; ///< The step of the last iteration
         std::vector<SuccessiveSubstitutionStep> step_logger;
 
         newton_raphson_saturation(){};
@@ -459,6 +464,8 @@ namespace SaturationSolvers
         int Nsteps;
         Eigen::MatrixXd J;
         Eigen::VectorXd r, err_rel;
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> QR; ///< The decomposition of the Jacobian, which keeps its storage between steps
+        Eigen::VectorXd step; ///< The step of the last iteration
         HelmholtzEOSMixtureBackend &HEOS;
         PTflash_twophase_options &IO;
         std::vector<SuccessiveSubstitutionStep> step_logger;
@@ -482,16 +489,38 @@ namespace SaturationSolvers
         void build_arrays();
     };
 };
+
+/** \brief The scratch memory of the VLE and stability routines of a state, see HelmholtzEOSMixtureBackend::get_VLE_workspace
+ *
+ * The solvers and vectors are sized to the number of components by their first use, and keep their storage between the
+ * flash calls of the state, so that the routines do not allocate memory at every call.  Each state has its own workspace,
+ * which is not copied with the state, so the states used by different threads do not share it.  The routines that use a 
+ * part of the workspace must not be nested for the same state.
+ */
+struct VLEWorkspace{
+    SaturationSolvers::newton_raphson_saturation saturation; ///< The Newton-Raphson saturation solver of the flash routines
+    SaturationSolvers::newton_raphson_twophase twophase; ///< The Newton-Raphson two-phase solver of the flash routines
+    std::vector<CoolPropDbl> ln_phi_liq, ///< The logarithms of the fugacity coefficients of the liquid in SaturationSolvers::successive_substitution
+                             ln_phi_vap; ///< The logarithms of the fugacity coefficients of the vapor in SaturationSolvers::successive_substitution
+    std::vector<double> lnK, K, K0, x, y, xL, xH, ///< The K-factors and the trial compositions of StabilityRoutines::StabilityEvaluationClass
+                        fugacity_coefficient0, fugacity0, ///< The fugacity coefficients and fugacities of the bulk phase in the stability analysis
+                        tpdL, tpdH; ///< The tangent plane distances of the steps of the stability analysis
+    /// The bytes allocated by the workspace, see HelmholtzEOSMixtureBackend::calc_memory_footprint
+    std::size_t heap_bytes() const;
+};
     
 namespace StabilityRoutines{
     
     /** \brief Evaluate phase stability
      * Based on the work of Gernert et al., J. Chem. Thermodyn., 2014 http://dx.doi.org/10.1016/j.fluid.2014.05.012
+     *
+     * The K-factors and trial compositions are kept in the VLEWorkspace of the state, so only one instance may be in use
+     * for a state at a time
      */
     class StabilityEvaluationClass{
     protected:
         HelmholtzEOSMixtureBackend &HEOS;
-        std::vector<double> lnK, K, K0, x, y, xL, xH;
+        std::vector<double> &lnK, &K, &K0, &x, &y, &xL, &xH;
         const std::vector<double> &z;
         double rhomolar_liq, rhomolar_vap, beta, tpd_liq, tpd_vap, DELTAG_nRT;
         double m_T, ///< The temperature to be used (if specified, otherwise that from HEOS)
@@ -501,7 +530,8 @@ namespace StabilityRoutines{
         bool debug;
     public:
         StabilityEvaluationClass(HelmholtzEOSMixtureBackend &HEOS)
-           : HEOS(HEOS), z(HEOS.get_mole_fractions_doubleref()), rhomolar_liq(-1), rhomolar_vap(-1), beta(-1), tpd_liq(10000), tpd_vap(100000), DELTAG_nRT(10000), m_T(-1), m_p(-1), _stable(false),debug(false) {};
+           : HEOS(HEOS), lnK(HEOS.get_VLE_workspace().lnK), K(HEOS.get_VLE_workspace().K), K0(HEOS.get_VLE_workspace().K0),
+             x(HEOS.get_VLE_workspace().x), y(HEOS.get_VLE_workspace().y), xL(HEOS.get_VLE_workspace().xL), xH(HEOS.get_VLE_workspace().xH), z(HEOS.get_mole_fractions_doubleref()), rhomolar_liq(-1), rhomolar_vap(-1), beta(-1), tpd_liq(10000), tpd_vap(100000), DELTAG_nRT(10000), m_T(-1), m_p(-1), _stable(false),debug(false) {};
         /** \brief Specify T&P, otherwise they are loaded the HEOS instance
          */
         void set_TP(double T, double p){m_T = T; m_p = p;};
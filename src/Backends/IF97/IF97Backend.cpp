@@ -2,4 +2,207 @@
 
 #include "IF97Backend.h"
 #include "AbstractState.h"
-#include "DataStructures.h"
\ No newline at end of file
+#include "DataStructures.h"
+
+namespace CoolProp {
+
+std::vector<std::vector<double> > IF97Backend::update_multi(CoolProp::input_pairs input_pair, const std::vector<double> &Value1, const std::vector<double> &Value2, const std::vector<parameters> &outputs)
+{
+    if (Value1.size() != Value2.size()){
+        throw ValueError(format("Sizes of Value1 [%d] and Value2 [%d] are not the same", Value1.size(), Value2.size()));
+    }
+    std::size_t N = Value1.size(), Nout = outputs.size();
+    std::vector<std::vector<double> > out(N, std::vector<double>(Nout, _HUGE));
+
+    bool blocked = (input_pair == PT_INPUTS || input_pair == HmassP_INPUTS || input_pair == PSmass_INPUTS);
+    for (std::size_t j = 0; j < Nout; ++j){
+        blocked = blocked && IF97GibbsDerivatives::is_supported(outputs[j]);
+    }
+
+    // Find the temperature and pressure of each single-phase state and sort the states by region;
+    // the states that cannot be evaluated in blocks are evaluated one at a time
+    std::vector<double> T(N, _HUGE), p(N, _HUGE);
+    std::vector<std::size_t> by_region[6], one_at_a_time;
+    for (std::size_t i = 0; i < N; ++i){
+        int region = 0;
+        if (blocked){
+            try{
+                switch (input_pair){
+                    case PT_INPUTS:
+                        p[i] = Value1[i]; T[i] = Value2[i]; break;
+                    case HmassP_INPUTS:
+                        p[i] = Value2[i];
+                        if (IF97::BackwardRegion(p[i], Value1[i], IF97_HMASS) != 4){ T[i] = IF97::T_phmass(p[i], Value1[i]); }
+                        break;
+                    case PSmass_INPUTS:
+                        p[i] = Value1[i];
+                        if (IF97::BackwardRegion(p[i], Value2[i], IF97_SMASS) != 4){ T[i] = IF97::T_psmass(p[i], Value2[i]); }
+                        break;
+                    default:
+                        break;
+                }
+                region = IF97_region_Tp(T[i], p[i]);
+            }
+            catch (...){
+                region = 0;
+            }
+        }
+        if (region == 1 || region == 2 || region == 5){
+            by_region[region].push_back(i);
+        }
+        else{
+            one_at_a_time.push_back(i);
+        }
+    }
+
+    // One evaluation of the series per state, for all the states of a region together
+    std::vector<double> T_region, p_region;
+    std::vector<IF97GibbsDerivatives> derivs;
+    for (int region = 1; region <= 5; ++region){
+        const std::vector<std::size_t> &indices = by_region[region];
+        std::size_t Nregion = indices.size();
+        if (Nregion == 0){ continue; }
+        T_region.resize(Nregion); p_region.resize(Nregion); derivs.resize(Nregion);
+        for (std::size_t k = 0; k < Nregion; ++k){
+            T_region[k] = T[indices[k]]; p_region[k] = p[indices[k]];
+        }
+        IF97_gibbs_derivatives(region, &(T_region[0]), &(p_region[0]), Nregion, &(derivs[0]));
+        for (std::size_t k = 0; k < Nregion; ++k){
+            std::vector<double> &row = out[indices[k]];
+            for (std::size_t j = 0; j < Nout; ++j){
+                row[j] = derivs[k].keyed_output(outputs[j]);
+            }
+        }
+    }
+
+    for (std::size_t k = 0; k < one_at_a_time.size(); ++k){
+        std::vector<double> &row = out[one_at_a_time[k]];
+        try{
+            update(input_pair, Value1[one_at_a_time[k]], Value2[one_at_a_time[k]]);
+            for (std::size_t j = 0; j < Nout; ++j){
+                row[j] = keyed_output(outputs[j]);
+            }
+        }
+        catch (...){
+            row.assign(Nout, _HUGE);
+        }
+    }
+    return out;
+}
+
+} /* namespace CoolProp */
+
+#ifdef ENABLE_CATCH
+#include "catch.hpp"
+
+TEST_CASE("Gibbs derivatives of the IF97 regions against the verification values of IAPWS R7-97", "[IF97]")
+{
+    // T [K], p [Pa], region, v [m^3/kg], h [J/kg], s [J/kg/K], cp [J/kg/K], w [m/s]
+    const double data[][8] = {{300, 3e6, 1, 0.100215168e-2, 0.115331273e6, 0.392294792e3, 0.417301218e4, 0.150773921e4},
+                              {300, 80e6, 1, 0.971180894e-3, 0.184142828e6, 0.368563852e3, 0.401008987e4, 0.163469054e4},
+                              {500, 3e6, 1, 0.120241800e-2, 0.975542239e6, 0.258041912e4, 0.465580682e4, 0.124071337e4},
+                              {300, 3.5e3, 2, 0.394913866e2, 0.254991145e7, 0.852238967e4, 0.191300162e4, 0.427920172e3},
+                              {700, 3.5e3, 2, 0.923015898e2, 0.333568375e7, 0.101749996e5, 0.208141274e4, 0.644289068e3},
+                              {700, 30e6, 2, 0.542946619e-2, 0.263149474e7, 0.517540298e4, 0.103505092e5, 0.480386523e3},
+                              {1500, 0.5e6, 5, 0.138455090e1, 0.521976855e7, 0.965408875e4, 0.261609445e4, 0.917068690e3},
+                              {1500, 30e6, 5, 0.230761299e-1, 0.516723514e7, 0.772970133e4, 0.272724317e4, 0.928548002e3},
+                              {2000, 30e6, 5, 0.311385219e-1, 0.657122604e7, 0.853640523e4, 0.288569882e4, 0.106736948e4}};
+    for (std::size_t i = 0; i < sizeof(data)/sizeof(data[0]); ++i){
+        CAPTURE(data[i][0]);
+        CAPTURE(data[i][1]);
+        CHECK(CoolProp::IF97_region_Tp(data[i][0], data[i][1]) == static_cast<int>(data[i][2]));
+        CoolProp::IF97GibbsDerivatives d;
+        CoolProp::IF97_gibbs_derivatives(static_cast<int>(data[i][2]), &(data[i][0]), &(data[i][1]), 1, &d);
+        CHECK(std::abs(1/d.keyed_output(CoolProp::iDmass)/data[i][3] - 1) < 1e-8);
+        CHECK(std::abs(d.keyed_output(CoolProp::iHmass)/data[i][4] - 1) < 1e-8);
+        CHECK(std::abs(d.keyed_output(CoolProp::iSmass)/data[i][5] - 1) < 1e-8);
+        CHECK(std::abs(d.keyed_output(CoolProp::iCpmass)/data[i][6] - 1) < 1e-8);
+        CHECK(std::abs(d.keyed_output(CoolProp::ispeed_sound)/data[i][7] - 1) < 1e-8);
+    }
+}
+
+TEST_CASE("Blocked evaluation of many IF97 states matches the scalar evaluation", "[IF97]")
+{
+    CoolProp::IF97Backend IF97;
+    std::vector<CoolProp::parameters> outputs;
+    outputs.push_back(CoolProp::iT); outputs.push_back(CoolProp::iDmass); outputs.push_back(CoolProp::iHmass); outputs.push_back(CoolProp::iSmass);
+    outputs.push_back(CoolProp::iUmass); outputs.push_back(CoolProp::iCpmass); outputs.push_back(CoolProp::iCvmass); outputs.push_back(CoolProp::ispeed_sound);
+
+    SECTION("PT inputs in regions 1, 2, 3 and 5"){
+        std::vector<double> p, T;
+        for (double pp = 1e4; pp < 45e6; pp *= 1.7){
+            for (double TT = 280; TT < 2000; TT += 37){
+                p.push_back(pp); T.push_back(TT);
+            }
+        }
+        std::vector<std::vector<double> > out = IF97.update_multi(CoolProp::PT_INPUTS, p, T, outputs);
+        REQUIRE(out.size() == p.size());
+        for (std::size_t i = 0; i < p.size(); ++i){
+            CAPTURE(p[i]);
+            CAPTURE(T[i]);
+            CHECK(out[i][0] == T[i]);
+            CHECK(std::abs(out[i][1]/IF97::rhomass_Tp(T[i], p[i]) - 1) < 1e-10);
+            CHECK(std::abs(out[i][2]/IF97::hmass_Tp(T[i], p[i]) - 1) < 1e-10);
+            CHECK(std::abs(out[i][3]/IF97::smass_Tp(T[i], p[i]) - 1) < 1e-10);
+            CHECK(std::abs(out[i][4]/IF97::umass_Tp(T[i], p[i]) - 1) < 1e-10);
+            CHECK(std::abs(out[i][5]/IF97::cpmass_Tp(T[i], p[i]) - 1) < 1e-10);
+            CHECK(std::abs(out[i][6]/IF97::cvmass_Tp(T[i], p[i]) - 1) < 1e-10);
+            CHECK(std::abs(out[i][7]/IF97::speed_sound_Tp(T[i], p[i]) - 1) < 1e-10);
+        }
+    }
+    SECTION("Hmass,P inputs, including two-phase states"){
+        std::vector<double> h, p;
+        for (double pp = 1e5; pp < 40e6; pp *= 2.3){
+            for (double hh = 2e5; hh < 4e6; hh += 1.9e5){
+                h.push_back(hh); p.push_back(pp);
+            }
+        }
+        std::vector<std::vector<double> > out = IF97.update_multi(CoolProp::HmassP_INPUTS, h, p, outputs);
+        CoolProp::IF97Backend scalar;
+        for (std::size_t i = 0; i < p.size(); ++i){
+            CAPTURE(h[i]);
+            CAPTURE(p[i]);
+            scalar.update(CoolProp::HmassP_INPUTS, h[i], p[i]);
+            for (std::size_t j = 0; j < outputs.size(); ++j){
+                CAPTURE(j);
+                double expected = _HUGE;
+                try{ expected = scalar.keyed_output(outputs[j]); } catch (...){ }
+                // In the two-phase region some outputs are not defined and are _HUGE in both
+                if (!ValidNumber(expected)){ continue; }
+                CHECK(std::abs(out[i][j]/expected - 1) < 1e-10);
+            }
+        }
+    }
+}
+
+TEST_CASE("Outputs of the IF97 backend from one evaluation of the Gibbs energy per update", "[IF97]")
+{
+    CoolProp::IF97Backend IF97;
+    SECTION("Single-phase states against the verification values of IAPWS R7-97"){
+        IF97.update(CoolProp::PT_INPUTS, 3e6, 300);
+        CHECK(std::abs(IF97.hmass()/0.115331273e6 - 1) < 1e-8);
+        CHECK(std::abs(IF97.cpmass()/0.417301218e4 - 1) < 1e-8);
+        CHECK(std::abs(IF97.speed_sound()/0.150773921e4 - 1) < 1e-8);
+        IF97.update(CoolProp::PT_INPUTS, 30e6, 700);
+        CHECK(std::abs(IF97.rhomass()*0.542946619e-2 - 1) < 1e-8);
+        CHECK(std::abs(IF97.smass()/0.517540298e4 - 1) < 1e-8);
+        IF97.update(CoolProp::PT_INPUTS, 0.5e6, 1500);
+        CHECK(std::abs(IF97.umass()/0.452749310e7 - 1) < 1e-8);
+    }
+    SECTION("Saturated and two-phase states against the scalar IF97 functions"){
+        for (double p = 1e4; p < 22e6; p *= 1.9){
+            CAPTURE(p);
+            IF97.update(CoolProp::PQ_INPUTS, p, 0);
+            CHECK(std::abs(IF97.hmass()/IF97::hliq_p(p) - 1) < 1e-10);
+            CHECK(std::abs(IF97.rhomass()/IF97::rholiq_p(p) - 1) < 1e-10);
+            CHECK(std::abs(IF97.cvmass()/IF97::cvliq_p(p) - 1) < 1e-10);
+            IF97.update(CoolProp::PQ_INPUTS, p, 1);
+            CHECK(std::abs(IF97.smass()/IF97::svap_p(p) - 1) < 1e-10);
+            CHECK(std::abs(IF97.speed_sound()/IF97::speed_soundvap_p(p) - 1) < 1e-10);
+            IF97.update(CoolProp::PQ_INPUTS, p, 0.3);
+            CHECK(std::abs(IF97.hmass()/(0.3*IF97::hvap_p(p) + 0.7*IF97::hliq_p(p)) - 1) < 1e-10);
+        }
+    }
+}
+
+#endif /* ENABLE_CATCH */
@@ -4,6 +4,7 @@
 
 #include "DataStructures.h"
 #include "externals/IF97/IF97.h"
+#include "IF97Series.h"
 #include "AbstractState.h"
 #include "Exceptions.h"
 #include <vector>
@@ -19,6 +20,33 @@ protected:
     CachedElement  _hmass, _rhomass, _smass;
     /// CachedElement  _hVmass, _hLmass, _sVmass, sLmass;
 
+    /// The derivatives of the Gibbs energy at the state and at the saturated liquid and vapor at _p, each evaluated at most
+    /// once per update.  Their region is 0 until they are evaluated, and -1 for states outside regions 1, 2 and 5.
+    IF97GibbsDerivatives _gibbs, _gibbsL, _gibbsV;
+
+    /// Evaluate the Gibbs derivatives at (T,p) into cache, or mark it with -1 if the region has no Gibbs form
+    static void evaluate_gibbs(IF97GibbsDerivatives &cache, double T, double p, int region){
+        if (region == 1 || region == 2 || region == 5){
+            IF97_gibbs_derivatives(region, &T, &p, 1, &cache);
+        }
+        else{
+            cache.region = -1;
+        }
+    }
+    /// Return the Gibbs derivatives at (_T,_p), or NULL if IF97 has to evaluate the state itself
+    const IF97GibbsDerivatives * gibbs(void){
+        if (_gibbs.region == 0){ evaluate_gibbs(_gibbs, _T, _p, IF97_region_Tp(_T, _p)); }
+        return (_gibbs.region > 0) ? &_gibbs : NULL;
+    }
+    /// Return the Gibbs derivatives of the saturated liquid (region 1) or vapor (region 2) at _p, or NULL above 623.15 K, in region 3
+    const IF97GibbsDerivatives * gibbs_sat(IF97GibbsDerivatives &cache, int region){
+        if (cache.region == 0){
+            double Tsat = IF97::Tsat97(_p);
+            evaluate_gibbs(cache, Tsat, _p, (Tsat <= 623.15) ? region : 3);
+        }
+        return (cache.region > 0) ? &cache : NULL;
+    }
+
 public:
     /// The name of the backend being used
     std::string backend_name(void) { return get_backend_string(IF97_BACKEND); }
@@ -44,6 +72,9 @@ public:
         this->_rhomass.clear();
         this->_hmass.clear();
         this->_smass.clear();
+        this->_gibbs = IF97GibbsDerivatives();
+        this->_gibbsL = IF97GibbsDerivatives();
+        this->_gibbsV = IF97GibbsDerivatives();
         this->_phase = iphase_not_imposed; 
         return true;
     };
@@ -140,6 +171,20 @@ public:
         }
     };
 
+    /// Evaluate a list of outputs at many states at once
+    /**
+    The states are first classified by region. The states in the Gibbs-form regions 1, 2 and 5 are then evaluated
+    in blocks, region by region, and all the outputs of a state are obtained from one evaluation of the series of its region.
+    The other states (region 3, the two-phase region, other input pairs or outputs) are evaluated one at a time with \ref update.
+
+    @param input_pair Integer key from CoolProp::input_pairs; PT_INPUTS, HmassP_INPUTS and PSmass_INPUTS use the blocked evaluation
+    @param Value1 The first input, one per state
+    @param Value2 The second input, one per state
+    @param outputs The outputs at each state; iT, iP, iDmass, iHmass, iSmass, iUmass, iCpmass, iCvmass and ispeed_sound use the blocked evaluation
+    @returns out[i][j] is output j at state i, or _HUGE for the states that fail; the state of this instance is not defined afterwards
+    */
+    std::vector<std::vector<double> > update_multi(CoolProp::input_pairs input_pair, const std::vector<double> &Value1, const std::vector<double> &Value2, const std::vector<parameters> &outputs);
+
     /*  We have to override some of the functions from the AbstractState.
      *  IF97 is only mass-based and does not support conversion
      *  from mass- to molar-specific quantities.
@@ -149,6 +194,10 @@ public:
     // ************************************************************************* //
     //
     double calc_SatLiquid(parameters iCalc) {
+        if (IF97GibbsDerivatives::is_supported(iCalc)){
+            const IF97GibbsDerivatives *d = gibbs_sat(_gibbsL, 1);
+            if (d != NULL){ return d->keyed_output(iCalc); }
+        }
         switch(iCalc){
         case iDmass:  return IF97::rholiq_p(_p); break; ///< Mass-based density
         case iHmass:  return IF97::hliq_p(_p); break;   ///< Mass-based enthalpy
@@ -165,6 +214,10 @@ public:
         };
     }
     double calc_SatVapor(parameters iCalc) {
+        if (IF97GibbsDerivatives::is_supported(iCalc)){
+            const IF97GibbsDerivatives *d = gibbs_sat(_gibbsV, 2);
+            if (d != NULL){ return d->keyed_output(iCalc); }
+        }
         switch(iCalc){
         case iDmass:  return IF97::rhovap_p(_p); break; ///< Mass-based density
         case iHmass:  return IF97::hvap_p(_p); break;   ///< Mass-based enthalpy
@@ -214,6 +267,11 @@ public:
                 }
                 break;
             default:    // Outside saturation envelope (iphase_not_imposed), let IF97 determine phase/region
+                // All the thermodynamic outputs in regions 1, 2 and 5 come from one evaluation of the Gibbs energy per update
+                if (IF97GibbsDerivatives::is_supported(iCalc)){
+                    const IF97GibbsDerivatives *d = gibbs();
+                    if (d != NULL){ return d->keyed_output(iCalc); }
+                }
                 switch(iCalc){
                 case iDmass:  return IF97::rhomass_Tp(_T, _p); break; ///< Mass-based density
                 case iHmass:  return IF97::hmass_Tp(_T, _p); break;   ///< Mass-based enthalpy
@@ -0,0 +1,200 @@
+#include "IF97Series.h"
+#include "externals/IF97/IF97.h"
+#include "Exceptions.h"
+#include "CoolPropTools.h"
+#include <cmath>
+
+namespace CoolProp {
+
+/// Specific gas constant of IAPWS-IF97 in J/kg/K
+static const double R_IF97 = 461.526;
+
+/// One series sum_i n_i*A^I_i*B^J_i of a Gibbs energy with A = a0 + a1*pi and B = b0 + tau
+struct IF97GibbsSeries
+{
+    const double *n;
+    const int *I, *J;
+    std::size_t N;
+    double a0, a1, b0;
+    int Imax, Jmin, Jmax;
+    IF97GibbsSeries(const double *n, const int *I, const int *J, std::size_t N, double a0, double a1, double b0)
+        : n(n), I(I), J(J), N(N), a0(a0), a1(a1), b0(b0), Imax(0), Jmin(0), Jmax(0)
+    {
+        for (std::size_t i = 0; i < N; ++i){
+            Imax = std::max(Imax, I[i]); Jmin = std::min(Jmin, J[i]); Jmax = std::max(Jmax, J[i]);
+        }
+    };
+};
+
+// Region 1, Table 2 of IAPWS R7-97(2012)
+static const int I1[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 8, 8, 21, 23, 29, 30, 31, 32};
+static const int J1[] = {-2, -1, 0, 1, 2, 3, 4, 5, -9, -7, -1, 0, 1, 3, -3, 0, 1, 3, 17, -4, 0, 6, -5, -2, 10, -8, -11, -6, -29, -31, -38, -39, -40, -41};
+static const double n1[] = {0.14632971213167, -0.84548187169114, -0.37563603672040e1, 0.33855169168385e1, -0.95791963387872, 0.15772038513228,
+                            -0.16616417199501e-1, 0.81214629983568e-3, 0.28319080123804e-3, -0.60706301565874e-3, -0.18990068218419e-1,
+                            -0.32529748770505e-1, -0.21841717175414e-1, -0.52838357969930e-4, -0.47184321073267e-3, -0.30001780793026e-3,
+                            0.47661393906987e-4, -0.44141845330846e-5, -0.72694996297594e-15, -0.31679644845054e-4, -0.28270797985312e-5,
+                            -0.85205128120103e-9, -0.22425281908000e-5, -0.65171222895601e-6, -0.14341729937924e-12, -0.40516996860117e-6,
+                            -0.12734301741641e-8, -0.17424871230634e-9, -0.68762131295531e-18, 0.14478307828521e-19, 0.26335781662795e-22,
+                            -0.11947622640071e-22, 0.18228094581404e-23, -0.93537087292458e-25};
+// Region 2, Tables 10 (ideal-gas part) and 11 (residual part)
+static const int I2o[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+static const int J2o[] = {0, 1, -5, -4, -3, -2, -1, 2, 3};
+static const double n2o[] = {-0.96927686500217e1, 0.10086655968018e2, -0.56087911283020e-2, 0.71452738081455e-1, -0.40710498223928,
+                             0.14240819171444e1, -0.43839511319450e1, -0.28408632460772, 0.21268463753307e-1};
+static const int I2r[] = {1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 4, 4, 4, 5, 6, 6, 6, 7, 7, 7, 8, 8, 9, 10, 10, 10, 16, 16, 18, 20, 20, 20,
+                          21, 22, 23, 24, 24, 24};
+static const int J2r[] = {0, 1, 2, 3, 6, 1, 2, 4, 7, 36, 0, 1, 3, 6, 35, 1, 2, 3, 7, 3, 16, 35, 0, 11, 25, 8, 36, 13, 4, 10, 14, 29, 50, 57, 20,
+                          35, 48, 21, 53, 39, 26, 40, 58};
+static const double n2r[] = {-0.17731742473213e-2, -0.17834862292358e-1, -0.45996013696365e-1, -0.57581259083432e-1, -0.50325278727930e-1,
+                             -0.33032641670203e-4, -0.18948987516315e-3, -0.39392777243355e-2, -0.43797295650573e-1, -0.26674547914087e-4,
+                             0.20481737692309e-7, 0.43870667284435e-6, -0.32277677238570e-4, -0.15033924542148e-2, -0.40668253562649e-1,
+                             -0.78847309559367e-9, 0.12790717852285e-7, 0.48225372718507e-6, 0.22922076337661e-5, -0.16714766451061e-10,
+                             -0.21171472321355e-2, -0.23895741934104e2, -0.59059564324270e-17, -0.12621808899101e-5, -0.38946842435739e-1,
+                             0.11256211360459e-10, -0.82311340897998e1, 0.19809712802088e-7, 0.10406965210174e-18, -0.10234747095929e-12,
+                             -0.10018179379511e-8, -0.80882908646985e-10, 0.10693031879409, -0.33662250574171, 0.89185845355421e-24,
+                             0.30629316876232e-12, -0.42002467698208e-5, -0.59056029685639e-25, 0.37826947613457e-5, -0.12768608934681e-14,
+                             0.73087610595061e-28, 0.55414715350778e-16, -0.94369707241210e-6};
+// Region 5, Tables 37 (ideal-gas part) and 38 (residual part)
+static const int I5o[] = {0, 0, 0, 0, 0, 0};
+static const int J5o[] = {0, 1, -3, -2, -1, 2};
+static const double n5o[] = {-0.13179983674201e2, 0.68540841634434e1, -0.24805148933466e-1, 0.36901534980333, -0.31161318213925e1, -0.32961626538917};
+static const int I5r[] = {1, 1, 1, 2, 2, 3};
+static const int J5r[] = {1, 2, 3, 3, 9, 7};
+static const double n5r[] = {0.15736404855259e-2, 0.90153761673944e-3, -0.50270077677648e-2, 0.22440037409485e-5, -0.41163275453471e-5, 0.37919454823456e-7};
+
+static const IF97GibbsSeries region1(n1, I1, J1, sizeof(n1)/sizeof(double), 7.1, -1, -1.222);
+static const IF97GibbsSeries region2o(n2o, I2o, J2o, sizeof(n2o)/sizeof(double), 1, 0, 0);
+static const IF97GibbsSeries region2r(n2r, I2r, J2r, sizeof(n2r)/sizeof(double), 0, 1, -0.5);
+static const IF97GibbsSeries region5o(n5o, I5o, J5o, sizeof(n5o)/sizeof(double), 1, 0, 0);
+static const IF97GibbsSeries region5r(n5r, I5r, J5r, sizeof(n5r)/sizeof(double), 0, 1, 0);
+
+/// The number of states evaluated together
+static const std::size_t IF97_BLOCK = 32;
+/// The largest exponents of A and the widest range of exponents of B of the series above
+static const int IF97_MAX_I = 32, IF97_MAX_J_RANGE = 58;
+
+/// Add a series and its derivatives to the sums for n <= IF97_BLOCK states
+static void add_series(const IF97GibbsSeries &S, const double *pi, const double *tau, std::size_t n,
+                       double *g, double *g_pi, double *g_tau, double *g_pipi, double *g_pitau, double *g_tautau)
+{
+    double A[IF97_BLOCK], B[IF97_BLOCK];
+    double Apow[(IF97_MAX_I + 1)*IF97_BLOCK], Bpow[(IF97_MAX_J_RANGE + 1)*IF97_BLOCK];
+    double s[IF97_BLOCK], s_a[IF97_BLOCK], s_b[IF97_BLOCK], s_aa[IF97_BLOCK], s_ab[IF97_BLOCK], s_bb[IF97_BLOCK];
+
+    for (std::size_t k = 0; k < n; ++k){
+        A[k] = S.a0 + S.a1*pi[k]; B[k] = S.b0 + tau[k];
+        s[k] = 0; s_a[k] = 0; s_b[k] = 0; s_aa[k] = 0; s_ab[k] = 0; s_bb[k] = 0;
+    }
+    // Tables of the powers of A and B, one row per exponent
+    for (std::size_t k = 0; k < n; ++k){ Apow[k] = 1; }
+    for (int i = 1; i <= S.Imax; ++i){
+        double *row = Apow + i*IF97_BLOCK, *prev = row - IF97_BLOCK;
+        for (std::size_t k = 0; k < n; ++k){ row[k] = prev[k]*A[k]; }
+    }
+    double *B0 = Bpow - S.Jmin*IF97_BLOCK;
+    for (std::size_t k = 0; k < n; ++k){ B0[k] = 1; }
+    for (int j = 1; j <= S.Jmax; ++j){
+        double *row = B0 + j*IF97_BLOCK, *prev = row - IF97_BLOCK;
+        for (std::size_t k = 0; k < n; ++k){ row[k] = prev[k]*B[k]; }
+    }
+    for (int j = -1; j >= S.Jmin; --j){
+        double *row = B0 + j*IF97_BLOCK, *prev = row + IF97_BLOCK;
+        for (std::size_t k = 0; k < n; ++k){ row[k] = prev[k]/B[k]; }
+    }
+    // Each term contributes n*A^I*B^J times a constant to each of the sums
+    for (std::size_t t = 0; t < S.N; ++t){
+        const double *Ai = Apow + S.I[t]*IF97_BLOCK, *Bj = B0 + S.J[t]*IF97_BLOCK;
+        const double c = S.n[t], cI = c*S.I[t], cJ = c*S.J[t], cII = cI*(S.I[t] - 1), cIJ = cI*S.J[t], cJJ = cJ*(S.J[t] - 1);
+        for (std::size_t k = 0; k < n; ++k){
+            double x = Ai[k]*Bj[k];
+            s[k] += c*x; s_a[k] += cI*x; s_b[k] += cJ*x; s_aa[k] += cII*x; s_ab[k] += cIJ*x; s_bb[k] += cJJ*x;
+        }
+    }
+    // Differentiate A^I*B^J as I*A^(I-1)*dA/dpi*B^J, etc., with dA/dpi = a1 and dB/dtau = 1
+    for (std::size_t k = 0; k < n; ++k){
+        g[k] += s[k];
+        g_pi[k] += S.a1*s_a[k]/A[k];
+        g_tau[k] += s_b[k]/B[k];
+        g_pipi[k] += S.a1*S.a1*s_aa[k]/(A[k]*A[k]);
+        g_pitau[k] += S.a1*s_ab[k]/(A[k]*B[k]);
+        g_tautau[k] += s_bb[k]/(B[k]*B[k]);
+    }
+}
+
+void IF97_gibbs_derivatives(int region, const double *T, const double *p, std::size_t N, IF97GibbsDerivatives *out)
+{
+    double pstar, Tstar;
+    const IF97GibbsSeries *ideal, *residual;
+    switch (region){
+        case 1: pstar = 16.53e6; Tstar = 1386; ideal = NULL; residual = &region1; break;
+        case 2: pstar = 1e6; Tstar = 540; ideal = &region2o; residual = &region2r; break;
+        case 5: pstar = 1e6; Tstar = 1000; ideal = &region5o; residual = &region5r; break;
+        default: throw ValueError(format("IF97 region [%d] is not one of the Gibbs-form regions 1, 2 and 5", region));
+    }
+    double pi[IF97_BLOCK], tau[IF97_BLOCK], g[IF97_BLOCK], g_pi[IF97_BLOCK], g_tau[IF97_BLOCK], g_pipi[IF97_BLOCK], g_pitau[IF97_BLOCK], g_tautau[IF97_BLOCK];
+    for (std::size_t i0 = 0; i0 < N; i0 += IF97_BLOCK){
+        std::size_t n = std::min(IF97_BLOCK, N - i0);
+        for (std::size_t k = 0; k < n; ++k){
+            pi[k] = p[i0 + k]/pstar; tau[k] = Tstar/T[i0 + k];
+            if (ideal != NULL){
+                // The logarithmic term of the ideal-gas part
+                g[k] = log(pi[k]); g_pi[k] = 1/pi[k]; g_pipi[k] = -1/(pi[k]*pi[k]);
+            }
+            else{
+                g[k] = 0; g_pi[k] = 0; g_pipi[k] = 0;
+            }
+            g_tau[k] = 0; g_pitau[k] = 0; g_tautau[k] = 0;
+        }
+        if (ideal != NULL){ add_series(*ideal, pi, tau, n, g, g_pi, g_tau, g_pipi, g_pitau, g_tautau); }
+        add_series(*residual, pi, tau, n, g, g_pi, g_tau, g_pipi, g_pitau, g_tautau);
+        for (std::size_t k = 0; k < n; ++k){
+            IF97GibbsDerivatives &d = out[i0 + k];
+            d.region = region; d.T = T[i0 + k]; d.p = p[i0 + k]; d.pi = pi[k]; d.tau = tau[k];
+            d.gamma = g[k]; d.gamma_pi = g_pi[k]; d.gamma_tau = g_tau[k];
+            d.gamma_pipi = g_pipi[k]; d.gamma_pitau = g_pitau[k]; d.gamma_tautau = g_tautau[k];
+        }
+    }
+}
+
+bool IF97GibbsDerivatives::is_supported(parameters key)
+{
+    switch (key){
+        case iT: case iP: case iDmass: case iHmass: case iSmass: case iUmass: case iCpmass: case iCvmass: case ispeed_sound:
+            return true;
+        default:
+            return false;
+    }
+}
+
+double IF97GibbsDerivatives::keyed_output(parameters key) const
+{
+    if (region == 0){ throw ValueError("The IF97 Gibbs derivatives have not been evaluated"); }
+    switch (key){
+        case iT: return T;
+        case iP: return p;
+        case iDmass: return p/(R_IF97*T*pi*gamma_pi);
+        case iHmass: return R_IF97*T*tau*gamma_tau;
+        case iSmass: return R_IF97*(tau*gamma_tau - gamma);
+        case iUmass: return R_IF97*T*(tau*gamma_tau - pi*gamma_pi);
+        case iCpmass: return -R_IF97*tau*tau*gamma_tautau;
+        case iCvmass: return R_IF97*(-tau*tau*gamma_tautau + POW2(gamma_pi - tau*gamma_pitau)/gamma_pipi);
+        case ispeed_sound: return sqrt(R_IF97*T*gamma_pi*gamma_pi/(POW2(gamma_pi - tau*gamma_pitau)/(tau*tau*gamma_tautau) - gamma_pipi));
+        default:
+            throw ValueError(format("Output [%s] is not available from the IF97 Gibbs derivatives", get_parameter_information(key, "short").c_str()));
+    }
+}
+
+int IF97_region_Tp(double T, double p)
+{
+    if (!ValidNumber(T) || !ValidNumber(p) || T < 273.15 || T > 2273.15 || p <= 0){ return 0; }
+    if (T > 1073.15){ return (p <= 50e6) ? 5 : 0; }
+    if (p > 100e6){ return 0; }
+    if (T > 623.15){
+        // Boundary between regions 2 and 3, Eq. 5
+        double p_B23 = (0.34805185628969e3 - 0.11671859879975e1*T + 0.10192970039326e-2*T*T)*1e6;
+        return (p > p_B23) ? 3 : 2;
+    }
+    return (p > IF97::psat97(T)) ? 1 : 2;
+}
+
+} /* namespace CoolProp */
@@ -0,0 +1,46 @@
+#ifndef IF97SERIES_H_
+#define IF97SERIES_H_
+
+#include "DataStructures.h"
+#include "CPnumerics.h"
+#include <cstddef>
+
+namespace CoolProp {
+
+/// The dimensionless Gibbs energy of one of the Gibbs-form regions (1, 2 and 5) of IAPWS-IF97 and its derivatives at one state
+/**
+ * gamma = g/(R*T) is a function of the reduced pressure pi = p/pstar and the inverse reduced temperature tau = Tstar/T.
+ * In regions 2 and 5 the values are the sums of the ideal-gas and residual parts.
+ */
+struct IF97GibbsDerivatives
+{
+    int region; ///< The region (1, 2 or 5) the derivatives belong to; 0 if they have not been evaluated
+    double T, p, pi, tau, gamma, gamma_pi, gamma_tau, gamma_pipi, gamma_pitau, gamma_tautau;
+
+    IF97GibbsDerivatives() : region(0), T(_HUGE), p(_HUGE), pi(_HUGE), tau(_HUGE), gamma(_HUGE), gamma_pi(_HUGE), gamma_tau(_HUGE),
+                             gamma_pipi(_HUGE), gamma_pitau(_HUGE), gamma_tautau(_HUGE) {};
+
+    /// Return true if \ref keyed_output can provide this parameter
+    static bool is_supported(parameters key);
+    /// Return one of iT, iP, iDmass, iHmass, iSmass, iUmass, iCpmass, iCvmass or ispeed_sound from the derivatives
+    double keyed_output(parameters key) const;
+};
+
+/// Return the IF97 region (1, 2, 3 or 5) that contains the single-phase state (T,p), or 0 if the state is out of range
+int IF97_region_Tp(double T, double p);
+
+/// Evaluate the derivatives of the Gibbs energy of one region at N states
+/**
+ * The states are evaluated in fixed-size blocks. Within a block the loop over the terms of the series is outermost
+ * and the loop over the states is innermost, so the inner loops run over contiguous arrays and can be vectorized.
+ *
+ * @param region The region (1, 2 or 5) all the states belong to; the states are not checked against its limits
+ * @param T The temperatures in K
+ * @param p The pressures in Pa
+ * @param N The number of states
+ * @param out The N derivative sets
+ */
+void IF97_gibbs_derivatives(int region, const double *T, const double *p, std::size_t N, IF97GibbsDerivatives *out);
+
+} /* namespace CoolProp */
+#endif /* IF97SERIES_H_ */
@@ -184,6 +184,7 @@ void IncompressibleBackend::set_fractions(const std::vector<CoolPropDbl> &fracti
          ( this->_fractions[0]!=fractions[0] ) ) { // Change it!
         if (get_debug_level()>=20) std::cout << format("Incompressible backend: Updating the fractions triggered a change in reference state %s -> %s",vec_to_string(this->_fractions).c_str(),vec_to_string(fractions).c_str()) << std::endl;
         this->_fractions = fractions;
+        composition.set(*fluid, this->_fractions[0]);
         set_reference_state(T_ref(), p_ref(), this->_fractions[0], h_ref(), s_ref());
     }
 }
@@ -383,7 +384,13 @@ CoolPropDbl IncompressibleBackend::HmassP_flash(CoolPropDbl hmass, CoolPropDbl p
         //double deriv(double target);
     };
 
-    HmassP_residual res = HmassP_residual(this, p, _fractions[0], hmass-h_ref()+hmass_ref());
+    double h_raw = hmass-h_ref()+hmass_ref();
+    if (composition.is_valid() && composition.get_x() == _fractions[0]) {
+        // Newton from the tabulated inverse; only fall back to the solver below if that fails
+        double T = composition.T_hmass(h_raw, p);
+        if (ValidNumber(T)) return T;
+    }
+    HmassP_residual res = HmassP_residual(this, p, _fractions[0], h_raw);
 
     double macheps = DBL_EPSILON;
     double tol     = DBL_EPSILON*1e3;
@@ -412,7 +419,13 @@ CoolPropDbl IncompressibleBackend::PSmass_flash(CoolPropDbl p, CoolPropDbl smass
         }
     };
 
-    PSmass_residual res = PSmass_residual(this, p, _fractions[0], smass-s_ref()+smass_ref());
+    double s_raw = smass-s_ref()+smass_ref();
+    if (composition.is_valid() && composition.get_x() == _fractions[0]) {
+        // Newton from the tabulated inverse; only fall back to the solver below if that fails
+        double T = composition.T_smass(s_raw, p);
+        if (ValidNumber(T)) return T;
+    }
+    PSmass_residual res = PSmass_residual(this, p, _fractions[0], s_raw);
 
     double macheps = DBL_EPSILON;
     double tol     = DBL_EPSILON*1e3;
@@ -483,9 +496,11 @@ CoolPropDbl IncompressibleBackend::calc_smass(void){
 
 /// Functions that can be used with the solver, they miss the reference values!
 CoolPropDbl IncompressibleBackend::raw_calc_hmass(double T, double p, double x){
+	if (composition.is_valid() && composition.get_x() == x) return composition.raw_hmass(T, p);
 	return calc_dhdTatPxdT(T,p,x) + p * calc_dhdpatTx(T,fluid->rho(T, p, x),calc_drhodTatPx(T,p,x));
 };
 CoolPropDbl IncompressibleBackend::raw_calc_smass(double T, double p, double x){
+	if (composition.is_valid() && composition.get_x() == x) return composition.raw_smass(T, p);
 	return calc_dsdTatPxdT(T,p,x) + p * calc_dsdpatTx(  fluid->rho(T, p, x),calc_drhodTatPx(T,p,x));
 };
 
@@ -1044,4 +1059,38 @@ TEST_CASE("Internal consistency checks and example use cases for the incompressi
 //    }
 }
 
+TEST_CASE("Enthalpy and entropy flashes of the incompressible backend","[IncompressibleBackend]")
+{
+    const char *names[] = {"MEG", "DowQ", "LiBr"};
+    for (std::size_t k = 0; k < 3; ++k) {
+        CoolProp::IncompressibleBackend backend(names[k]);
+        CoolProp::IncompressibleFluid &fluid = CoolProp::get_incompressible_fluid(names[k]);
+        double Tmin = fluid.getTmin();
+        if (!fluid.is_pure()) {
+            double x = 0.5*(fluid.getxmin()+fluid.getxmax());
+            backend.set_mass_fractions(std::vector<CoolPropDbl>(1, x));
+            Tmin = std::max(Tmin, fluid.Tfreeze(1e5, x)+1);
+        }
+        double ps[2] = {2e6, 1e7};
+        for (std::size_t j = 0; j < 2; ++j) {
+            for (std::size_t i = 0; i < 5; ++i) {
+                double p = ps[j];
+                double T = fluid.getTmax() - (fluid.getTmax()-Tmin)*(i+0.5)/5;
+                backend.update(CoolProp::PT_INPUTS, p, T);
+                double h = backend.hmass(), s = backend.smass();
+                CAPTURE(names[k]);
+                CAPTURE(p);
+                CAPTURE(T);
+                backend.update(CoolProp::HmassP_INPUTS, h, p);
+                CHECK(std::abs(backend.T()-T) < 1e-8);
+                backend.update(CoolProp::PSmass_INPUTS, p, s);
+                CHECK(std::abs(backend.T()-T) < 1e-8);
+            }
+        }
+        // Enthalpies beyond the temperature limits cannot be inverted
+        backend.update(CoolProp::PT_INPUTS, 5e6, fluid.getTmax());
+        CHECK_THROWS(backend.update(CoolProp::HmassP_INPUTS, backend.hmass()+1e5, 5e6));
+    }
+}
+
 #endif /* ENABLE_CATCH */
@@ -29,6 +29,8 @@ protected:
 	CachedElement  _drhodTatPx, _dsdTatPx, _dhdTatPx, _dsdTatPxdT, _dhdTatPxdT, _dsdpatTx, _dhdpatTx;
 
     IncompressibleFluid *fluid;
+    /// The fluid reduced to the current composition, used for the flashes
+    IncompressibleFixedComposition composition;
 
     /// Set the fractions
     /**
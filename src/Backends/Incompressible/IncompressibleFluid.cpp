@@ -6,6 +6,7 @@
 #include "MatrixMath.h"
 #include "PolyMath.h"
 #include <Eigen/Core>
+#include <algorithm>
 
 namespace CoolProp {
 
@@ -32,38 +33,80 @@ bool IncompressibleFluid::is_pure() {
     return false;
 }
 
+/// Derive the coefficients of the derivative and the integrals from the current density and specific heat coefficients
+/** The integral of c/T cannot be written in powers of (T-Tbase). Its
+ *  coefficients are stored in powers of T instead, with the coefficients
+ *  of log(T) in the first row, and the columns are powers of (x-xbase).
+ */
+void IncompressibleFluid::prepare_coefficients(){
+    drhodT_coeffs.resize(0,0);
+    dhdT_int_coeffs.resize(0,0);
+    dsdT_int_coeffs.resize(0,0);
+    if (density.type==IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL && density.coeffs.rows() > 0) {
+        const Eigen::MatrixXd &C = density.coeffs;
+        drhodT_coeffs = Eigen::MatrixXd::Zero(std::max(C.rows()-1, Eigen::MatrixXd::Index(1)), C.cols());
+        for (Eigen::MatrixXd::Index i = 1; i < C.rows(); ++i) {
+            drhodT_coeffs.row(i-1) = C.row(i)*double(i);
+        }
+    }
+    if (specific_heat.type==IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL && specific_heat.coeffs.rows() > 0) {
+        const Eigen::MatrixXd &C = specific_heat.coeffs;
+        const Eigen::MatrixXd::Index r = C.rows(), c = C.cols();
+        dhdT_int_coeffs = Eigen::MatrixXd::Zero(r+1, c);
+        for (Eigen::MatrixXd::Index i = 0; i < r; ++i) {
+            dhdT_int_coeffs.row(i+1) = C.row(i)/double(i+1);
+        }
+        // Expand (T-Tbase)^i/T = (-Tbase)^i/T + sum_{n=1}^{i} binom(i,n)*(-Tbase)^(i-n)*T^(n-1)
+        dsdT_int_coeffs = Eigen::MatrixXd::Zero(r, c);
+        for (Eigen::MatrixXd::Index i = 0; i < r; ++i) {
+            double binom = 1; // binom(i,n)
+            for (Eigen::MatrixXd::Index n = 0; n <= i; ++n) {
+                double factor = binom*pow(-Tbase, static_cast<int>(i-n));
+                if (n == 0) {
+                    dsdT_int_coeffs.row(0) += C.row(i)*factor;
+                } else {
+                    dsdT_int_coeffs.row(n) += C.row(i)*factor/double(n);
+                }
+                binom = binom*double(i-n)/double(n+1);
+            }
+        }
+    }
+}
+
 /// Base exponential function
-double IncompressibleFluid::baseExponential(IncompressibleData data, double y, double ybase){
-    Eigen::VectorXd coeffs = makeVector(data.coeffs);
-    size_t r=coeffs.rows(),c=coeffs.cols();
-    if (strict && (r!=3 || c!=1) ) throw ValueError(format("%s (%d): You have to provide a 3,1 matrix of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
+double IncompressibleFluid::baseExponential(const IncompressibleData &data, double y, double ybase){
+    size_t r=data.coeffs.rows(),c=data.coeffs.cols();
+    if (strict && (r*c!=3 || (r!=1 && c!=1)) ) throw ValueError(format("%s (%d): You have to provide a 3,1 matrix of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
+    const double *coeffs = data.coeffs.data(); // A vector is contiguous in either orientation
     return exp( (double) (coeffs[0] / ( (y-ybase)+coeffs[1] ) - coeffs[2] ) );
 }
 /// Base exponential function with logarithmic term
-double IncompressibleFluid::baseLogexponential(IncompressibleData data, double y, double ybase){
-    Eigen::VectorXd coeffs = makeVector(data.coeffs);
-    size_t r=coeffs.rows(),c=coeffs.cols();
-    if (strict && (r!=3 || c!=1) ) throw ValueError(format("%s (%d): You have to provide a 3,1 matrix of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
+double IncompressibleFluid::baseLogexponential(const IncompressibleData &data, double y, double ybase){
+    size_t r=data.coeffs.rows(),c=data.coeffs.cols();
+    if (strict && (r*c!=3 || (r!=1 && c!=1)) ) throw ValueError(format("%s (%d): You have to provide a 3,1 matrix of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
+    const double *coeffs = data.coeffs.data();
     return exp( (double) ( log( (double) (1.0/((y-ybase)+coeffs[0]) + 1.0/((y-ybase)+coeffs[0])/((y-ybase)+coeffs[0]) ) ) *coeffs[1]+coeffs[2] ) );
 }
 
-double IncompressibleFluid::basePolyOffset(IncompressibleData data, double y, double z){
+double IncompressibleFluid::basePolyOffset(const IncompressibleData &data, double y, double z){
     size_t r=data.coeffs.rows(),c=data.coeffs.cols();
-    double offset = 0.0;
-    double in     = 0.0;
-    Eigen::MatrixXd coeffs;
+    double in = 0.0;
     if (r>0 && c>0) {
-        offset = data.coeffs(0,0);
         if (r==1 && c>1) { // row vector -> function of z
-            coeffs = Eigen::MatrixXd(data.coeffs.block(0,1,r,c-1));
             in = z;
         } else if (r>1 && c==1) { // column vector -> function of y
-            coeffs = Eigen::MatrixXd(data.coeffs.block(1,0,r-1,c));
             in = y;
         } else {
             throw ValueError(format("%s (%d): You have to provide a vector (1D matrix) of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
         }
-        return poly.evaluate(coeffs, in, 0, offset);
+        // The first entry is the offset, the others are the polynomial in (in-offset)
+        const double *coeffs = data.coeffs.data();
+        const double offset = coeffs[0];
+        double result = 0.0;
+        for (std::size_t i = r*c-1; i > 0; --i) {
+            result = result*(in-offset) + coeffs[i];
+        }
+        return result;
     }
     throw ValueError(format("%s (%d): You have to provide a vector (1D matrix) of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
 }
@@ -189,7 +232,7 @@ double IncompressibleFluid::Tfreeze(       double p, double x){
 double IncompressibleFluid::drhodTatPx (double T, double p, double x){
     switch (density.type) {
         case IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL:
-        	return poly.derivative(density.coeffs, T, x, 0, 0, 0, Tbase, xbase);
+            return poly.evaluate(drhodT_coeffs, T, x, 0, 0, Tbase, xbase);
         case IncompressibleData::INCOMPRESSIBLE_NOT_SET:
             throw ValueError(format("%s (%d): The function type is not specified (\"[%d]\"), are you sure the coefficients have been set?",__FILE__,__LINE__,density.type));
         default:
@@ -201,8 +244,20 @@ double IncompressibleFluid::drhodTatPx (double T, double p, double x){
 //  integrated in temperature
 double IncompressibleFluid::dsdTatPxdT(double T, double p, double x){
 	switch (specific_heat.type) {
-		case IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL:
-			return poly.integral(specific_heat.coeffs, T, x, 0, -1, 0, Tbase, xbase);
+		case IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL: {
+			// Horner scheme in (x-xbase) over the columns, each being a*log(T) + T*(b_1 + b_2*T + ...)
+			const Eigen::MatrixXd &S = dsdT_int_coeffs;
+			const double logT = log(T);
+			double result = 0;
+			for (Eigen::MatrixXd::Index j = S.cols()-1; j >= 0; --j) {
+				double col = 0;
+				for (Eigen::MatrixXd::Index n = S.rows()-1; n > 0; --n) {
+					col = (col + S(n,j))*T;
+				}
+				result = result*(x-xbase) + col + S(0,j)*logT;
+			}
+			return result;
+		}
 		case IncompressibleData::INCOMPRESSIBLE_NOT_SET:
 			throw ValueError(format("%s (%d): The function type is not specified (\"[%d]\"), are you sure the coefficients have been set?",__FILE__,__LINE__,specific_heat.type));
 		default:
@@ -215,7 +270,7 @@ double IncompressibleFluid::dsdTatPxdT(double T, double p, double x){
 double IncompressibleFluid::dhdTatPxdT(double T, double p, double x){
 	switch (specific_heat.type) {
 		case IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL:
-			return poly.integral(specific_heat.coeffs, T, x, 0, 0, 0, Tbase, xbase);
+			return poly.evaluate(dhdT_int_coeffs, T, x, 0, 0, Tbase, xbase);
 		case IncompressibleData::INCOMPRESSIBLE_NOT_SET:
 			throw ValueError(format("%s (%d): The function type is not specified (\"[%d]\"), are you sure the coefficients have been set?",__FILE__,__LINE__,specific_heat.type));
 		default:
@@ -415,6 +470,119 @@ bool IncompressibleFluid::checkX(double x){
     return true;
 }
 
+/// Reduce a coefficient matrix to a vector for a fixed value of the second input
+/** The second input enters the columns as powers of dy */
+static std::vector<double> reduce_columns(const Eigen::MatrixXd &coefficients, double dy){
+    std::vector<double> reduced(coefficients.rows(), 0.0);
+    for (Eigen::MatrixXd::Index i = 0; i < coefficients.rows(); ++i) {
+        for (Eigen::MatrixXd::Index j = coefficients.cols()-1; j >= 0; --j) {
+            reduced[i] = reduced[i]*dy + coefficients(i,j);
+        }
+    }
+    return reduced;
+}
+/// Horner evaluation of the polynomial with the given coefficients
+static double horner(const std::vector<double> &coefficients, double x){
+    double result = 0;
+    for (std::size_t i = coefficients.size(); i > 0; --i) {
+        result = result*x + coefficients[i-1];
+    }
+    return result;
+}
+
+void IncompressibleFixedComposition::set(IncompressibleFluid &fluid, double x){
+    this->x = x;
+    valid = false;
+    invertible = false;
+    if (fluid.density.type!=IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL || fluid.specific_heat.type!=IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL
+        || fluid.drhodT_coeffs.size() == 0 || fluid.dsdT_int_coeffs.size() == 0) {
+        return;
+    }
+    Tbase = fluid.Tbase;
+    Tmin = fluid.Tmin;
+    Tmax = fluid.Tmax;
+    const double dx = x - fluid.xbase;
+    rho_coeffs = reduce_columns(fluid.density.coeffs, dx);
+    drhodT_coeffs = reduce_columns(fluid.drhodT_coeffs, dx);
+    d2rhodT2_coeffs.assign(std::max(drhodT_coeffs.size(), std::size_t(2))-1, 0.0);
+    for (std::size_t i = 1; i < drhodT_coeffs.size(); ++i) {
+        d2rhodT2_coeffs[i-1] = drhodT_coeffs[i]*double(i);
+    }
+    c_coeffs = reduce_columns(fluid.specific_heat.coeffs, dx);
+    h_int_coeffs = reduce_columns(fluid.dhdT_int_coeffs, dx);
+    s_int_coeffs = reduce_columns(fluid.dsdT_int_coeffs, dx);
+    valid = true;
+
+    // Tabulate the integrals, which can only be inverted if the specific heat is positive
+    if (!ValidNumber(Tmin) || !ValidNumber(Tmax) || Tmin <= 0 || Tmax <= Tmin) return;
+    const std::size_t N = 33;
+    T_nodes.resize(N); h_nodes.resize(N); s_nodes.resize(N); dTdh_nodes.resize(N); dTds_nodes.resize(N);
+    for (std::size_t k = 0; k < N; ++k) {
+        double T = Tmin + (Tmax-Tmin)*k/(N-1);
+        double cT = c(T);
+        if (!(cT > 0)) return;
+        T_nodes[k] = T;
+        h_nodes[k] = raw_hmass(T, 0);
+        s_nodes[k] = raw_smass(T, 0);
+        dTdh_nodes[k] = 1/cT;
+        dTds_nodes[k] = T/cT;
+    }
+    invertible = true;
+}
+
+double IncompressibleFixedComposition::rho(double T) const {return horner(rho_coeffs, T-Tbase);}
+double IncompressibleFixedComposition::drhodT(double T) const {return horner(drhodT_coeffs, T-Tbase);}
+double IncompressibleFixedComposition::c(double T) const {return horner(c_coeffs, T-Tbase);}
+double IncompressibleFixedComposition::raw_hmass(double T, double p) const {
+    double r = rho(T);
+    return horner(h_int_coeffs, T-Tbase) + p/r*(1 + T/r*drhodT(T));
+}
+double IncompressibleFixedComposition::raw_smass(double T, double p) const {
+    double s_int = 0;
+    for (std::size_t n = s_int_coeffs.size()-1; n > 0; --n) {
+        s_int = (s_int + s_int_coeffs[n])*T;
+    }
+    s_int += s_int_coeffs[0]*log(T);
+    double r = rho(T);
+    return s_int + p/r/r*drhodT(T);
+}
+
+double IncompressibleFixedComposition::T_guess(const std::vector<double> &y_nodes, const std::vector<double> &dTdy_nodes, double y) const {
+    if (y <= y_nodes.front()) return T_nodes.front();
+    if (y >= y_nodes.back()) return T_nodes.back();
+    std::size_t k = std::upper_bound(y_nodes.begin(), y_nodes.end(), y) - y_nodes.begin() - 1;
+    double dy = y_nodes[k+1]-y_nodes[k], t = (y-y_nodes[k])/dy;
+    return (1+2*t)*(1-t)*(1-t)*T_nodes[k] + t*(1-t)*(1-t)*dy*dTdy_nodes[k] + t*t*(3-2*t)*T_nodes[k+1] + t*t*(t-1)*dy*dTdy_nodes[k+1];
+}
+
+double IncompressibleFixedComposition::T_hmass(double hmass, double p) const {
+    if (!invertible) return _HUGE;
+    double T = T_guess(h_nodes, dTdh_nodes, hmass);
+    for (int iter = 0; iter < 20; ++iter) {
+        double r = rho(T), dr = drhodT(T), d2r = horner(d2rhodT2_coeffs, T-Tbase);
+        double f = horner(h_int_coeffs, T-Tbase) + p/r*(1 + T/r*dr) - hmass;
+        double dfdT = c(T) + p*T*(d2r/(r*r) - 2*dr*dr/(r*r*r));
+        double dT = f/dfdT;
+        T = std::min(std::max(T-dT, Tmin), Tmax);
+        if (std::abs(dT) < 1e-12*T) return T;
+    }
+    return _HUGE;
+}
+
+double IncompressibleFixedComposition::T_smass(double smass, double p) const {
+    if (!invertible) return _HUGE;
+    double T = T_guess(s_nodes, dTds_nodes, smass);
+    for (int iter = 0; iter < 20; ++iter) {
+        double r = rho(T), dr = drhodT(T), d2r = horner(d2rhodT2_coeffs, T-Tbase);
+        double f = raw_smass(T, p) - smass;
+        double dfdT = c(T)/T + p*(d2r/(r*r) - 2*dr*dr/(r*r*r));
+        double dT = f/dfdT;
+        T = std::min(std::max(T-dT, Tmin), Tmax);
+        if (std::abs(dT) < 1e-12*T) return T;
+    }
+    return _HUGE;
+}
+
 } /* namespace CoolProp */
 
 
@@ -699,4 +867,41 @@ TEST_CASE("Internal consistency checks and example use cases for the incompressi
 
 }
 
+TEST_CASE("Prepared coefficients for the derivatives and integrals of the incompressible fluids","[IncompressibleFluids]")
+{
+    const char *names[] = {"MEG", "DowQ", "LiBr"};
+    for (std::size_t k = 0; k < 3; ++k) {
+        CoolProp::IncompressibleFluid fluid = CoolProp::get_incompressible_fluid(names[k]);
+        double x = fluid.is_pure() ? 0.0 : 0.5*(fluid.getxmin()+fluid.getxmax());
+        double p = 10e5, dT = 1e-3;
+        // Including the base temperature, where the fractional derivative used to fail
+        double Ts[3] = {fluid.getTmin()+1, fluid.getTbase(), fluid.getTmax()-1};
+        for (std::size_t i = 0; i < 3; ++i) {
+            double T = Ts[i];
+            CAPTURE(names[k]);
+            CAPTURE(T);
+            double drhodT = (fluid.rho(T+dT,p,x)-fluid.rho(T-dT,p,x))/(2*dT);
+            double dhdT = (fluid.dhdTatPxdT(T+dT,p,x)-fluid.dhdTatPxdT(T-dT,p,x))/(2*dT);
+            double dsdT = (fluid.dsdTatPxdT(T+dT,p,x)-fluid.dsdTatPxdT(T-dT,p,x))/(2*dT);
+            CHECK(std::abs(fluid.drhodTatPx(T,p,x)/drhodT-1) < 1e-6);
+            CHECK(std::abs(fluid.c(T,p,x)/dhdT-1) < 1e-6);
+            CHECK(std::abs(fluid.c(T,p,x)/T/dsdT-1) < 1e-6);
+        }
+        // A micro-benchmark of the evaluation of all the properties
+        double T = 0.5*(fluid.getTmin()+fluid.getTmax()), sum = 0;
+        const int N = 100000;
+        clock_t t1 = clock();
+        for (int i = 0; i < N; ++i) {
+            double Ti = T + 1e-6*i;
+            sum += fluid.rho(Ti,p,x) + fluid.c(Ti,p,x) + fluid.visc(Ti,p,x) + fluid.cond(Ti,p,x)
+                 + fluid.drhodTatPx(Ti,p,x) + fluid.dhdTatPxdT(Ti,p,x) + fluid.dsdTatPxdT(Ti,p,x);
+        }
+        double elapsed = (clock() - t1)/((double)CLOCKS_PER_SEC);
+        if (CoolProp::get_debug_level() > 0) {
+            std::cout << format("%s: %g us for rho, c, visc, cond, drhodT and the integrals of c (sum %g)\n", names[k], elapsed/N*1e6, sum);
+        }
+        CHECK(ValidNumber(sum));
+    }
+}
+
 #endif /* ENABLE_CATCH */
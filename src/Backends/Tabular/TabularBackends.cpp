@@ -33,6 +33,10 @@ static CoolProp::TabularDataLibrary library;
 
 namespace CoolProp{
 
+std::size_t get_tabular_library_bytes(){
+    return library.heap_bytes();
+}
+
 /**
  * @brief 
  * @param table
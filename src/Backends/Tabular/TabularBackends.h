@@ -33,6 +33,9 @@ public:
     
     PackablePhaseEnvelopeData() : revision(0) {} ;
 
+    /// The bytes allocated by the phase envelope and its packed copy
+    std::size_t heap_bytes() const { return PhaseEnvelopeData::heap_bytes() + CoolProp::heap_bytes(vectors) + CoolProp::heap_bytes(matrices); };
+
     void copy_from_nonpackable(const PhaseEnvelopeData &PED) {
         /* Use X macros to auto-generate the copying */
         #define X(name) name = PED.name;
@@ -42,6 +45,7 @@ public:
         #define X(name) name = PED.name;
         PHASE_ENVELOPE_MATRICES
         #undef X
+        build_index();
     };
 
     std::map<std::string, std::vector<double> > vectors;
@@ -92,6 +96,8 @@ public:
         iTsat_max = std::distance(T.begin(), std::max_element(T.begin(), T.end()));
         // Find the index of the point with the highest pressure
         ipsat_max = std::distance(p.begin(), std::max_element(p.begin(), p.end()));
+        // Index the monotone pieces of the curves
+        build_index();
     };
     void deserialize(msgpack::object &deserialized){       
         PackablePhaseEnvelopeData temp;
@@ -157,6 +163,15 @@ class PureFluidSaturationTableData{
     
 		MSGPACK_DEFINE(revision, vectors); // write the member variables that you want to pack
 
+        /// The bytes allocated by the table and its packed copy
+        std::size_t heap_bytes() const {
+            std::size_t bytes = CoolProp::heap_bytes(vectors);
+            #define X(name) bytes += CoolProp::heap_bytes(name);
+            LIST_OF_SATURATION_VECTORS
+            #undef X
+            return bytes;
+        };
+
         /***
          * \brief Determine if a set of inputs are single-phase or inside the saturation table
          * @param main The main variable that is being provided (currently T or P)
@@ -466,6 +481,16 @@ class SinglePhaseGriddedTableData{
         void build(shared_ptr<CoolProp::AbstractState> &AS);
     
 		MSGPACK_DEFINE(revision, matrices, xmin, xmax, ymin, ymax); // write the member variables that you want to pack
+
+        /// The bytes allocated by the table and its packed copy
+        std::size_t heap_bytes() const {
+            std::size_t bytes = CoolProp::heap_bytes(xvec) + CoolProp::heap_bytes(yvec) + CoolProp::heap_bytes(nearest_neighbor_i) + CoolProp::heap_bytes(nearest_neighbor_j)
+                              + CoolProp::heap_bytes(matrices);
+            #define X(name) bytes += CoolProp::heap_bytes(name);
+            LIST_OF_MATRICES
+            #undef X
+            return bytes;
+        };
 		/// Resize all the matrices
 		void resize(std::size_t Nx, std::size_t Ny){
 			/* Use X macros to auto-generate the code; each will look something like: T.resize(Nx, std::vector<double>(Ny, _HUGE)); */
@@ -734,6 +759,11 @@ public:
         alt_i = 9999999; alt_j = 9999999;
     }
     std::vector<double> T, rhomolar, hmolar, p, smolar, umolar;
+    /// The bytes allocated by the coefficients
+    std::size_t heap_bytes() const {
+        return CoolProp::heap_bytes(T) + CoolProp::heap_bytes(rhomolar) + CoolProp::heap_bytes(hmolar) + CoolProp::heap_bytes(p)
+               + CoolProp::heap_bytes(smolar) + CoolProp::heap_bytes(umolar);
+    };
     /// Return a const reference to the desired matrix
     const std::vector<double> & get(const parameters params) const
     {
@@ -802,6 +832,20 @@ public:
     void build_tables(shared_ptr<CoolProp::AbstractState> &AS);
     /// Build the \f$a_{i,j}\f$ coefficients for bicubic interpolation
     void build_coeffs(SinglePhaseGriddedTableData &table, std::vector<std::vector<CellCoeffs> > &coeffs);
+    /// The bytes allocated by the tables and the coefficients
+    std::size_t heap_bytes() const {
+        std::size_t bytes = single_phase_logph.heap_bytes() + single_phase_logpT.heap_bytes() + pure_saturation.heap_bytes() + phase_envelope.heap_bytes();
+        const std::vector<std::vector<CellCoeffs> > *coeffs[] = {&coeffs_ph, &coeffs_pT};
+        for (std::size_t k = 0; k < 2; ++k){
+            bytes += coeffs[k]->capacity()*sizeof(std::vector<CellCoeffs>);
+            for (std::size_t i = 0; i < coeffs[k]->size(); ++i){
+                const std::vector<CellCoeffs> &row = (*coeffs[k])[i];
+                bytes += row.capacity()*sizeof(CellCoeffs);
+                for (std::size_t j = 0; j < row.size(); ++j){ bytes += row[j].heap_bytes(); }
+            }
+        }
+        return bytes;
+    };
 };
 
 class TabularDataLibrary
@@ -826,8 +870,19 @@ public:
     }
     /// Return a pointer to the set of tabular datasets
     TabularDataSet * get_set_of_tables(shared_ptr<AbstractState> &AS, bool &loaded);
+    /// The bytes used by the sets of tables that have been built or loaded
+    std::size_t heap_bytes() const {
+        std::size_t bytes = map_node_bytes(data);
+        for (std::map<std::string, TabularDataSet>::const_iterator it = data.begin(); it != data.end(); ++it){
+            bytes += CoolProp::heap_bytes(it->first) + it->second.heap_bytes();
+        }
+        return bytes;
+    };
 };
 
+/// The bytes used by the process-wide library of tables of the tabular backends
+std::size_t get_tabular_library_bytes();
+
 /**
  * @brief This class contains the general code for tabular backends (TTSE, bicubic, etc.)
  *
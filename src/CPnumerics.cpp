@@ -135,10 +135,12 @@ void solve_cubic(double a, double b, double c, double d, int &N, double &x0, dou
     }
     else //(DELTA>0)
     {
-        // Three real roots
-        double t0 = 2.0*sqrt(-p/3.0)*cos(1.0/3.0*acos(3.0*q/(2.0*p)*sqrt(-3.0/p))-0*2.0*M_PI/3.0);
-        double t1 = 2.0*sqrt(-p/3.0)*cos(1.0/3.0*acos(3.0*q/(2.0*p)*sqrt(-3.0/p))-1*2.0*M_PI/3.0);
-        double t2 = 2.0*sqrt(-p/3.0)*cos(1.0/3.0*acos(3.0*q/(2.0*p)*sqrt(-3.0/p))-2*2.0*M_PI/3.0);
+        // Three real roots; where they coalesce, round-off can make p non-negative or put the argument of acos outside [-1, 1]
+        double r = (p < 0) ? 2.0*sqrt(-p/3.0) : 0;
+        double arg = (p < 0) ? std::min(1.0, std::max(-1.0, 3.0*q/(2.0*p)*sqrt(-3.0/p))) : 0;
+        double t0 = r*cos(1.0/3.0*acos(arg)-0*2.0*M_PI/3.0);
+        double t1 = r*cos(1.0/3.0*acos(arg)-1*2.0*M_PI/3.0);
+        double t2 = r*cos(1.0/3.0*acos(arg)-2*2.0*M_PI/3.0);
 
         N = 3;
         x0 = t0-b/(3*a);
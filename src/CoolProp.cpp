@@ -46,6 +46,10 @@
 #include "DataStructures.h"
 #include "Backends/REFPROP/REFPROPMixtureBackend.h"
 #include "Backends/Cubics/CubicsLibrary.h"
+#include "Backends/Cubics/VTPRBackend.h"
+#if !defined(NO_TABULAR_BACKENDS)
+    #include "Backends/Tabular/TabularBackends.h"
+#endif
 
 #if defined(ENABLE_CATCH)
     #include "catch.hpp"
@@ -270,42 +274,8 @@ void _PropsSI_initialize(const std::string &backend,
     }
 }
 
-struct output_parameter{
-	enum OutputParametersType {OUTPUT_TYPE_UNSET = 0, OUTPUT_TYPE_TRIVIAL, OUTPUT_TYPE_NORMAL, OUTPUT_TYPE_FIRST_DERIVATIVE, OUTPUT_TYPE_FIRST_SATURATION_DERIVATIVE, OUTPUT_TYPE_SECOND_DERIVATIVE};
-	CoolProp::parameters Of1, Wrt1, Constant1, Wrt2, Constant2;
-	OutputParametersType type;
-    /// Parse a '&' separated string into a data structure with one entry per output
-    /// Covers both normal and derivative outputs
-    static std::vector<output_parameter> get_output_parameters(const std::vector<std::string> &Outputs){
-        std::vector<output_parameter> outputs;
-        for (std::vector<std::string>::const_iterator str = Outputs.begin(); str != Outputs.end(); ++str){
-            output_parameter out;
-            CoolProp::parameters iOutput;
-            if (is_valid_parameter(*str, iOutput)){
-                out.Of1 = iOutput;
-                if (is_trivial_parameter(iOutput)){ out.type = OUTPUT_TYPE_TRIVIAL; }
-                else{ out.type = OUTPUT_TYPE_NORMAL; }
-            }
-            else if (is_valid_first_saturation_derivative(*str, out.Of1, out.Wrt1)){
-                out.type = OUTPUT_TYPE_FIRST_SATURATION_DERIVATIVE;
-            }
-            else if (is_valid_first_derivative(*str, out.Of1, out.Wrt1, out.Constant1)){
-                out.type = OUTPUT_TYPE_FIRST_DERIVATIVE;
-            }
-            else if (is_valid_second_derivative(*str, out.Of1, out.Wrt1, out.Constant1, out.Wrt2, out.Constant2)){
-                out.type = OUTPUT_TYPE_SECOND_DERIVATIVE;
-            }
-            else{
-                throw ValueError(format("Output string is invalid [%s]", str->c_str()));
-            }
-            outputs.push_back(out);
-        }
-        return outputs;
-    };
-};
-
 void _PropsSI_outputs(shared_ptr<AbstractState> &State,
-	     			 const std::vector<output_parameter> &output_parameters,
+	     			 const OutputPlan &output_parameters,
 		    		 CoolProp::input_pairs input_pair,
 			    	 const std::vector<double> &in1,
 			    	 const std::vector<double> &in2,
@@ -317,7 +287,7 @@ void _PropsSI_outputs(shared_ptr<AbstractState> &State,
     // If all trivial outputs, never do a state update
     bool all_trivial_outputs = true;
     for (std::size_t j = 0; j < output_parameters.size(); ++j){
-        if (output_parameters[j].type != output_parameter::OUTPUT_TYPE_TRIVIAL){
+        if (output_parameters[j].type != OutputPlan::OUTPUT_TYPE_TRIVIAL){
             all_trivial_outputs = false;
         }
     }
@@ -329,7 +299,7 @@ void _PropsSI_outputs(shared_ptr<AbstractState> &State,
         split_input_pair(input_pair, p1, p2);
         // See if each parameter is in the output vector and is a normal type input
         for (std::size_t j = 0; j < output_parameters.size(); ++j){
-            if (output_parameters[j].type != output_parameter::OUTPUT_TYPE_NORMAL){
+            if (output_parameters[j].type != OutputPlan::OUTPUT_TYPE_NORMAL){
                 all_outputs_in_inputs = false; break;
             }
             if (!(output_parameters[j].Of1 == p1 || output_parameters[j].Of1 == p2)){
@@ -381,6 +351,8 @@ void _PropsSI_outputs(shared_ptr<AbstractState> &State,
                     State->update_with_guesses(input_pair, in1[i], in2[i], guesses);
                     guesses.clear();
                 }
+                // Calculate the values shared by the outputs in one pass
+                State->output_intermediates(output_parameters.intermediates());
             }
         }
         catch(...){
@@ -404,30 +376,17 @@ void _PropsSI_outputs(shared_ptr<AbstractState> &State,
                 }
             }
             try{
-                const output_parameter &output = output_parameters[j];
-                switch (output.type){
-                    case output_parameter::OUTPUT_TYPE_TRIVIAL:
-                    case output_parameter::OUTPUT_TYPE_NORMAL:
-                        IO[i][j] = State->keyed_output(output.Of1); 
-                        if (use_guesses) {
-                            switch (output.Of1) {
-                            case iDmolar: guesses.rhomolar = IO[i][j]; break;
-                            case iT: guesses.T = IO[i][j]; break;
-                            case iP: guesses.p = IO[i][j]; break;
-                            case iHmolar: guesses.hmolar = IO[i][j]; break;
-                            case iSmolar: guesses.smolar = IO[i][j]; break;
-                            default: throw ValueError("Don't understand this parameter");
-                            }
-                        }
-                        break;
-                    case output_parameter::OUTPUT_TYPE_FIRST_DERIVATIVE:
-                        IO[i][j] = State->first_partial_deriv(output.Of1, output.Wrt1, output.Constant1); break;
-                    case output_parameter::OUTPUT_TYPE_FIRST_SATURATION_DERIVATIVE:
-                        IO[i][j] = State->first_saturation_deriv(output.Of1, output.Wrt1); break;
-                    case output_parameter::OUTPUT_TYPE_SECOND_DERIVATIVE:
-                        IO[i][j] = State->second_partial_deriv(output.Of1, output.Wrt1, output.Constant1, output.Wrt2, output.Constant2); break;
-                    default:
-                        throw ValueError(format("")); break;
+                const OutputPlan::Output &output = output_parameters[j];
+                IO[i][j] = output_parameters.evaluate(*State, j);
+                if (use_guesses && (output.type == OutputPlan::OUTPUT_TYPE_TRIVIAL || output.type == OutputPlan::OUTPUT_TYPE_NORMAL)) {
+                    switch (output.Of1) {
+                    case iDmolar: guesses.rhomolar = IO[i][j]; break;
+                    case iT: guesses.T = IO[i][j]; break;
+                    case iP: guesses.p = IO[i][j]; break;
+                    case iHmolar: guesses.hmolar = IO[i][j]; break;
+                    case iSmolar: guesses.smolar = IO[i][j]; break;
+                    default: throw ValueError("Don't understand this parameter");
+                    }
                 }
                 // At least one has succeeded
                 success_inner = true;
@@ -509,7 +468,7 @@ void _PropsSImulti(const std::vector<std::string> &Outputs,
     shared_ptr<AbstractState> State;
     CoolProp::parameters key1 = INVALID_PARAMETER, key2 = INVALID_PARAMETER;   // Initialize to invalid parameter values
     CoolProp::input_pairs input_pair = INPUT_PAIR_INVALID;                     // Initialize to invalid input pair
-    std::vector<output_parameter> output_parameters;
+    OutputPlan output_parameters;
     std::vector<double> v1, v2;
 
     try{
@@ -540,7 +499,7 @@ void _PropsSImulti(const std::vector<std::string> &Outputs,
     }
 
     try{
-        output_parameters = output_parameter::get_output_parameters(Outputs);
+        output_parameters = OutputPlan(Outputs);
     }
     catch (std::exception &e){
         // Output parameter parsing failed.  Stop.
@@ -1084,6 +1043,17 @@ std::string PhaseSI(const std::string &Name1, double Prop1, const std::string &N
     return phase_lookup_string(static_cast<phases>(Phase_int));                 //     return phase as a string
 }
 
+LibraryMemoryFootprint get_library_memory_footprint(void)
+{
+    LibraryMemoryFootprint footprint;
+    footprint.fluid_library = get_library().heap_bytes();
+    #if !defined(NO_TABULAR_BACKENDS)
+        footprint.tabular_library = get_tabular_library_bytes();
+    #endif
+    footprint.UNIFAC_library = get_UNIFAC_library_bytes();
+    return footprint;
+}
+
 /*
 std::string PhaseSI(const std::string &Name1, double Prop1, const std::string &Name2, double Prop2, const std::string &FluidName, const std::vector<double> &z)
 {
@@ -355,6 +355,26 @@ EXPORT_CODE double CONVENTION HAPropsSI(const char *Output, const char *Name1, d
     fpu_reset_guard guard;
     return HumidAir::HAPropsSI(std::string(Output), std::string(Name1), Prop1, std::string(Name2), Prop2, std::string(Name3), Prop3);
 }
+EXPORT_CODE void CONVENTION HAPropsSImulti(const char *Outputs, const char *Name1, const double *Prop1, const char *Name2, const double *Prop2, const char *Name3, const double *Prop3, const long length, double *out, long *errcode, char *message_buffer, const long buffer_length)
+{
+    *errcode = 0;
+    fpu_reset_guard guard;
+    try{
+        std::vector<std::string> outputs = strsplit(Outputs, '&');
+        std::vector<std::vector<double> > IO = HumidAir::HAPropsSImulti(outputs, Name1, std::vector<double>(Prop1, Prop1 + length), Name2, std::vector<double>(Prop2, Prop2 + length), Name3, std::vector<double>(Prop3, Prop3 + length));
+        if (IO.size() != static_cast<std::size_t>(length)){
+            throw CoolProp::ValueError(CoolProp::get_global_param_string("errstring"));
+        }
+        for (std::size_t i = 0; i < IO.size(); ++i){
+            for (std::size_t j = 0; j < outputs.size(); ++j){
+                out[i*outputs.size() + j] = IO[i][j];
+            }
+        }
+    }
+    catch (...){
+        HandleException(errcode, message_buffer, buffer_length);
+    }
+}
 EXPORT_CODE double CONVENTION cair_sat(double T)
 {
     fpu_reset_guard guard;
@@ -711,3 +731,33 @@ EXPORT_CODE void CONVENTION AbstractState_all_critical_points(const long handle,
         HandleException(errcode, message_buffer, buffer_length);
     }
 }
+
+EXPORT_CODE void CONVENTION AbstractState_get_memory_footprint(const long handle, double *owned_model, double *shared_model, double *cached_derivatives, double *child_states, double *phase_envelope, double *spinodal, long *errcode, char *message_buffer, const long buffer_length) {
+    *errcode = 0;
+    try {
+        shared_ptr<CoolProp::AbstractState> &AS = handle_manager.get(handle);
+        CoolProp::MemoryFootprint footprint = AS->memory_footprint();
+        *owned_model = static_cast<double>(footprint.owned_model);
+        *shared_model = static_cast<double>(footprint.shared_model);
+        *cached_derivatives = static_cast<double>(footprint.cached_derivatives);
+        *child_states = static_cast<double>(footprint.child_states);
+        *phase_envelope = static_cast<double>(footprint.phase_envelope);
+        *spinodal = static_cast<double>(footprint.spinodal);
+    }
+    catch (...) {
+        HandleException(errcode, message_buffer, buffer_length);
+    }
+}
+
+EXPORT_CODE void CONVENTION get_library_memory_footprint(double *fluid_library, double *tabular_library, double *UNIFAC_library, long *errcode, char *message_buffer, const long buffer_length) {
+    *errcode = 0;
+    try {
+        CoolProp::LibraryMemoryFootprint footprint = CoolProp::get_library_memory_footprint();
+        *fluid_library = static_cast<double>(footprint.fluid_library);
+        *tabular_library = static_cast<double>(footprint.tabular_library);
+        *UNIFAC_library = static_cast<double>(footprint.UNIFAC_library);
+    }
+    catch (...) {
+        HandleException(errcode, message_buffer, buffer_length);
+    }
+}
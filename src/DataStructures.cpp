@@ -102,7 +102,7 @@ const parameter_info parameter_info_list[] = {
 class ParameterInformation
 {
 public:
-    std::map<int, bool> trivial_map;
+    std::vector<int> trivial_by_key; ///< 1 if the parameter with this key is trivial, 0 if not, -1 if there is no such parameter
     std::map<int, std::string> short_desc_map, description_map, IO_map, units_map;
     std::map<std::string, int> index_map;
     ParameterInformation()
@@ -115,7 +115,8 @@ public:
             units_map.insert(std::pair<int, std::string>(el->key, el->units));
             description_map.insert(std::pair<int, std::string>(el->key, el->description));
             index_map_insert(el->short_desc, el->key);
-            trivial_map.insert(std::pair<int, bool>(el->key, el->trivial));
+            if (el->key >= static_cast<int>(trivial_by_key.size())){ trivial_by_key.resize(el->key + 1, -1); }
+            trivial_by_key[el->key] = el->trivial ? 1 : 0;
         }
         // Backward compatibility aliases
         index_map_insert("D", iDmass);
@@ -154,13 +155,10 @@ static ParameterInformation parameter_information;
 
 bool is_trivial_parameter(int key)
 {
-    // Try to find it
-    std::map<int, bool>::const_iterator it = parameter_information.trivial_map.find(key);
-    // If equal to end, not found
-    if (it != parameter_information.trivial_map.end())
+    // Look it up directly by key; this is called for every keyed output
+    if (key >= 0 && key < static_cast<int>(parameter_information.trivial_by_key.size()) && parameter_information.trivial_by_key[key] >= 0)
     {
-        // Found it, return it
-        return it->second;
+        return parameter_information.trivial_by_key[key] == 1;
     }
     else
     {
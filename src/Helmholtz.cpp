@@ -284,6 +284,15 @@ void ResidualHelmholtzGeneralizedExponential::all(const CoolPropDbl &tau, const
     
     return;
 };
+
+std::size_t ResidualHelmholtzGeneralizedExponential::heap_bytes() const{
+    std::size_t bytes = CoolProp::heap_bytes(s) + CoolProp::heap_bytes(elements) + CoolProp::heap_bytes(l_int) + CoolProp::heap_bytes(m_int);
+    const std::vector<double> * const coefficients[] = {&n, &d, &t, &c, &l_double, &omega, &m_double, &eta1, &epsilon1, &eta2, &epsilon2, &beta1, &gamma1, &beta2, &gamma2};
+    for (std::size_t i = 0; i < sizeof(coefficients)/sizeof(coefficients[0]); ++i){
+        bytes += CoolProp::heap_bytes(*coefficients[i]);
+    }
+    return bytes;
+}
     
 void ResidualHelmholtzGeneralizedExponential::to_json(rapidjson::Value &el, rapidjson::Document &doc){
     el.AddMember("type","GeneralizedExponential",doc.GetAllocator());
@@ -876,10 +885,11 @@ void IdealHelmholtzCP0PolyT::to_json(rapidjson::Value &el, rapidjson::Document &
     }
     void IdealHelmholtzPlanckEinsteinGeneralized::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw()
     {
-        // First pre-calculate exp(theta[i]*tau) for each contribution; used in each term
-        std::vector<double> expthetatau(N); for (std::size_t i=0; i < N; ++i){ expthetatau[i] = exp(theta[i]*tau); }
-        
         if (!enabled){ return; }
+        
+        // First pre-calculate exp(theta[i]*tau) for each contribution; used in each term
+        // The vector is a member, so that its storage is reused between calls
+        expthetatau.resize(N); for (std::size_t i=0; i < N; ++i){ expthetatau[i] = exp(theta[i]*tau); }
         {
             CoolPropDbl s=0; for (std::size_t i=0; i < N; ++i){ s += n[i]*log(c[i]+d[i]*expthetatau[i]); }
             derivs.alphar += s;
@@ -23,6 +23,9 @@
 #include <string.h>
 #include <iostream>
 #include <list>
+#include <mutex>
+#include <thread>
+#include <functional>
 #include "externals/IF97/IF97.h"
 
 /// This is a stub overload to help with all the strcmp calls below and avoid needing to rewrite all of them
@@ -41,33 +44,343 @@ void strcpy(std::string &s, const std::string &e){
     s = e;
 }
 
-shared_ptr<CoolProp::HelmholtzEOSBackend> Water, Air;
-shared_ptr<CoolProp::AbstractState> WaterIF97;
-
 namespace HumidAir
 {
+    /// The evaluators of the HumidAirState that is being evaluated by this thread; all the functions in this file work on these
+    static thread_local CoolProp::HelmholtzEOSBackend *Water = NULL, *Air = NULL;
+    static thread_local CoolProp::AbstractState *WaterIF97 = NULL;
+    static thread_local HumidAirFits *Fits = NULL;
+
     enum givens{GIVEN_INVALID=0, GIVEN_TDP,GIVEN_PSIW, GIVEN_HUMRAT,GIVEN_VDA, GIVEN_VHA,GIVEN_TWB,GIVEN_RH,GIVEN_ENTHALPY,GIVEN_ENTHALPY_HA,GIVEN_ENTROPY,GIVEN_ENTROPY_HA, GIVEN_T,GIVEN_P,GIVEN_VISC,GIVEN_COND,GIVEN_CP,GIVEN_CPHA, GIVEN_COMPRESSIBILITY_FACTOR, GIVEN_PARTIAL_PRESSURE_WATER, GIVEN_CV, GIVEN_CVHA, GIVEN_INTERNAL_ENERGY, GIVEN_INTERNAL_ENERGY_HA, GIVEN_SPEED_OF_SOUND, GIVEN_ISENTROPIC_EXPONENT};
     
-    void _HAPropsSI_inputs(double p, const std::vector<givens> &input_keys, const std::vector<double> &input_vals, double &T, double &psi_w);
+    /// The solution at a neighbouring state point, used as the starting point of the iterative solutions in _HAPropsSI_inputs
+    struct HAPropsSIGuesses{
+        double T, W;
+        double p_sat, T_sat; ///< The saturation temperature of pure water at the pressure p_sat
+        HAPropsSIGuesses() : T(_HUGE), W(_HUGE), p_sat(_HUGE), T_sat(_HUGE) {};
+    };
+
+    void _HAPropsSI_inputs(double p, const std::vector<givens> &input_keys, const std::vector<double> &input_vals, double &T, double &psi_w, HAPropsSIGuesses *guesses = NULL);
     double _HAPropsSI_outputs(givens OuputType, double p, double T, double psi_w);
 
-void check_fluid_instantiation()
+#if !defined(COOLPROP_CXX11_THREAD_LOCAL)
+/// Without C++11 thread_local the evaluations are serialized, since the evaluators above may be shared by all the threads
+static std::recursive_mutex evaluators_mutex;
+#endif
+
+/// Binds the evaluators of a HumidAirState to the calling thread for the lifetime of this object and restores the previous ones afterwards
+class ScopedEvaluators
+{
+private:
+#if !defined(COOLPROP_CXX11_THREAD_LOCAL)
+    std::lock_guard<std::recursive_mutex> lock; ///< Held for the whole evaluation; declared first so that it is taken before the evaluators are read
+#endif
+    CoolProp::HelmholtzEOSBackend *old_Water, *old_Air;
+    CoolProp::AbstractState *old_WaterIF97;
+    HumidAirFits *old_Fits;
+public:
+    ScopedEvaluators(HumidAirState &state) : 
+#if !defined(COOLPROP_CXX11_THREAD_LOCAL)
+        lock(evaluators_mutex),
+#endif
+        old_Water(Water), old_Air(Air), old_WaterIF97(WaterIF97), old_Fits(Fits){
+        bind(state);
+    };
+    ~ScopedEvaluators(){
+        Water = old_Water; Air = old_Air; WaterIF97 = old_WaterIF97; Fits = old_Fits;
+    };
+    /// Make the calling thread work on the evaluators of the given state
+    static void bind(HumidAirState &state){
+        Water = state.Water.get(); Air = state.Air.get(); WaterIF97 = state.WaterIF97.get(); Fits = state.fits.get();
+    };
+};
+
+/// The states that are not used by any thread, kept so that their fits can be reused: those of the threads that have exited
+/// and those of the worker threads of HAPropsSImulti between calls
+static std::vector<shared_ptr<HumidAirState> > idle_states;
+static std::mutex idle_states_mutex;
+
+/// Take a state from the idle states, or create one if there are none
+static shared_ptr<HumidAirState> acquire_state()
 {
-    if (!Water.get()){
-        Water.reset(new CoolProp::HelmholtzEOSBackend("Water"));
+    {
+        std::lock_guard<std::mutex> lock(idle_states_mutex);
+        if (!idle_states.empty()){
+            shared_ptr<HumidAirState> state = idle_states.back();
+            idle_states.pop_back();
+            return state;
+        }
     }
-    if (!WaterIF97.get()){
-        WaterIF97.reset(CoolProp::AbstractState::factory("IF97","Water"));
+    return shared_ptr<HumidAirState>(new HumidAirState());
+}
+/// Return a state to the idle states; it is deleted if there are already as many idle states as hardware threads
+static void release_state(const shared_ptr<HumidAirState> &state)
+{
+    std::lock_guard<std::mutex> lock(idle_states_mutex);
+    if (idle_states.size() < std::max(1U, std::thread::hardware_concurrency())){
+        idle_states.push_back(state);
     }
-    if (!Air.get()){
-        Air.reset(new CoolProp::HelmholtzEOSBackend("Air"));
+}
+
+#if defined(COOLPROP_CXX11_THREAD_LOCAL)
+/// The state that backs HAPropsSI in one thread; it is returned to the idle states when the thread exits
+struct ThreadStateHolder
+{
+    shared_ptr<HumidAirState> state;
+    ~ThreadStateHolder(){
+        if (state){ release_state(state); }
+    };
+};
+static thread_local ThreadStateHolder thread_state;
+
+/// Get the HumidAirState that belongs to the calling thread, taking it on first use
+static HumidAirState &get_thread_state()
+{
+    if (!thread_state.state){
+        thread_state.state = acquire_state();
+    }
+    return *thread_state.state;
+}
+#else
+/// The state that backs HAPropsSI in all the threads; it is only evaluated with evaluators_mutex held
+static shared_ptr<HumidAirState> thread_state;
+
+/// Get the HumidAirState shared by all the threads, creating it on first use
+static HumidAirState &get_thread_state()
+{
+    std::lock_guard<std::recursive_mutex> lock(evaluators_mutex);
+    if (!thread_state){
+        thread_state = acquire_state();
+    }
+    return *thread_state;
+}
+#endif
+
+void check_fluid_instantiation()
+{
+    // Outside of a HumidAirState evaluation, fall back to the evaluators of the calling thread
+    if (Water == NULL || Air == NULL || WaterIF97 == NULL){
+        ScopedEvaluators::bind(get_thread_state());
     }
 };
 
 static double epsilon=0.621945,R_bar=8.314472;
-static int FlagUseVirialCorrelations=0,FlagUseIsothermCompressCorrelation=0,FlagUseIdealGasEnthalpyCorrelations=0;
+static int FlagUseVirialCorrelations=0,FlagUseIsothermCompressCorrelation=0,FlagUseIdealGasEnthalpyCorrelations=0,FlagUsePrecomputedFits=0;
 double f_factor(double T, double p);
 
+/// A piecewise Chebyshev approximation of a function of temperature
+/**
+The function is sampled at the Chebyshev extrema of each interval, and an interval is bisected until the
+approximation reproduces the function to within the tolerance at the points halfway between the nodes
+*/
+class ChebyshevFit1D
+{
+private:
+    std::vector<double> edges; ///< The edges of the intervals, in increasing order
+    std::vector<std::vector<double> > c, dc; ///< The coefficients of the approximation and of its derivative in each interval
+    enum{N = 17, MAX_DEPTH = 12};
+
+    static double clenshaw(const std::vector<double> &coeffs, double x){
+        double b1 = 0, b2 = 0;
+        for (std::size_t j = coeffs.size() - 1; j > 0; --j){
+            double b0 = 2*x*b1 - b2 + coeffs[j];
+            b2 = b1; b1 = b0;
+        }
+        return x*b1 - b2 + coeffs[0];
+    }
+    void fit_interval(CoolProp::FuncWrapper1D &func, double a, double b, double tol, bool relative, int depth){
+        std::vector<double> f(N), coeffs(N), dcoeffs(N, 0.0);
+        double scale = 0;
+        for (std::size_t k = 0; k < N; ++k){
+            f[k] = func.call(0.5*(a + b) + 0.5*(b - a)*cos(M_PI*k/(N - 1)));
+            if (!ValidNumber(f[k])){ throw CoolProp::ValueError(format("Invalid value when fitting at T: %g K", 0.5*(a + b) + 0.5*(b - a)*cos(M_PI*k/(N - 1)))); }
+            scale = std::max(scale, std::abs(f[k]));
+        }
+        for (std::size_t j = 0; j < N; ++j){
+            double summer = 0.5*(f[0] + ((j % 2 == 0) ? f[N - 1] : -f[N - 1]));
+            for (std::size_t k = 1; k < N - 1; ++k){ summer += f[k]*cos(M_PI*j*k/(N - 1)); }
+            coeffs[j] = 2*summer/(N - 1);
+        }
+        coeffs[0] /= 2; coeffs[N - 1] /= 2;
+        if (!relative){ scale = 1; }
+        // Check the approximation between the nodes
+        double err = 0;
+        for (std::size_t k = 0; k < N - 1; ++k){
+            double x = cos(M_PI*(k + 0.5)/(N - 1));
+            err = std::max(err, std::abs(clenshaw(coeffs, x) - func.call(0.5*(a + b) + 0.5*(b - a)*x)));
+        }
+        if (!(err <= tol*scale) && depth < MAX_DEPTH){
+            fit_interval(func, a, 0.5*(a + b), tol, relative, depth + 1);
+            fit_interval(func, 0.5*(a + b), b, tol, relative, depth + 1);
+            return;
+        }
+        // Coefficients of the derivative with respect to T
+        dcoeffs[N - 2] = 2*(N - 1)*coeffs[N - 1];
+        for (std::size_t j = N - 2; j > 0; --j){
+            dcoeffs[j - 1] = dcoeffs[j + 1] + 2*j*coeffs[j];
+        }
+        dcoeffs[0] /= 2;
+        for (std::size_t j = 0; j < N; ++j){ dcoeffs[j] *= 2/(b - a); }
+        edges.push_back(a); c.push_back(coeffs); dc.push_back(dcoeffs);
+    }
+    std::size_t interval(double T) const{
+        std::size_t i = std::upper_bound(edges.begin(), edges.end(), T) - edges.begin();
+        return (i == 0) ? 0 : std::min(i - 1, c.size() - 1);
+    }
+public:
+    bool valid() const{ return !c.empty(); };
+    double Tmin() const{ return edges.front(); };
+    double Tmax() const{ return edges.back(); };
+    bool in_range(double T) const{ return !c.empty() && T >= edges.front() && T <= edges.back(); };
+    /// Build the approximation over the given breakpoints, which are where the function or its derivative is discontinuous
+    /**
+    If the function cannot be evaluated somewhere in the range, the approximation is left empty
+    */
+    void build(CoolProp::FuncWrapper1D &func, const std::vector<double> &breakpoints, double tol, bool relative){
+        edges.clear(); c.clear(); dc.clear();
+        try{
+            for (std::size_t i = 0; i + 1 < breakpoints.size(); ++i){
+                fit_interval(func, breakpoints[i], breakpoints[i + 1], tol, relative, 0);
+            }
+            edges.push_back(breakpoints.back());
+        }
+        catch(...){
+            edges.clear(); c.clear(); dc.clear();
+        }
+    };
+    double evaluate(double T) const{
+        std::size_t i = interval(T);
+        return clenshaw(c[i], (2*T - edges[i] - edges[i + 1])/(edges[i + 1] - edges[i]));
+    };
+    double derivative(double T) const{
+        std::size_t i = interval(T);
+        return clenshaw(dc[i], (2*T - edges[i] - edges[i + 1])/(edges[i + 1] - edges[i]));
+    };
+};
+
+/// The functions of temperature alone that can be evaluated from precomputed fits
+enum fitted_quantities{FIT_B_AIR = 0, FIT_DBDT_AIR, FIT_C_AIR, FIT_DCDT_AIR, FIT_B_WATER, FIT_DBDT_WATER, FIT_C_WATER, FIT_DCDT_WATER,
+                       FIT_P_WS, FIT_VBAR_WS, FIT_H0_WATER, FIT_H0_AIR, FIT_S0_WATER, FIT_S0_AIR, FIT_NUMBER_OF_QUANTITIES};
+
+/// The fits at one pressure of the functions that also depend on pressure
+struct PressureFits
+{
+    double p;
+    std::size_t calls; ///< The number of times the fits at this pressure were asked for
+    bool built, h_w_built;
+    ChebyshevFit1D f, ///< The enhancement factor
+                   ln_p_s, ///< The logarithm of the saturation partial pressure of water in humid air, f*p_ws
+                   h_w; ///< The mass enthalpy of liquid water
+    PressureFits(double p) : p(p), calls(0), built(false), h_w_built(false){};
+};
+
+/// The precomputed fits that belong to a HumidAirState
+/**
+Each fit is built the first time it is needed.  While a fit is being built, it is flagged as built but is still
+empty, so that the function being fitted is evaluated exactly.
+*/
+struct HumidAirFits
+{
+    std::vector<ChebyshevFit1D> quantities;
+    std::vector<bool> quantities_built;
+    std::list<PressureFits> pressures; ///< Most recently used first
+    HumidAirFits() : quantities(FIT_NUMBER_OF_QUANTITIES), quantities_built(FIT_NUMBER_OF_QUANTITIES, false){};
+};
+
+/// The range of temperatures covered by the fits of the functions of temperature alone
+static const double T_min_fits = 100, T_max_fits = 640;
+/// The number of times the fits at a pressure must be asked for before they are built, so that pressures that are only used a few times are not fitted
+static const std::size_t fit_pressure_threshold = 50;
+/// The number of pressures for which fits are kept
+static const std::size_t fit_pressure_count = 4;
+
+static double fit_source(fitted_quantities key, double T);
+static void build_pressure_fits(PressureFits &fits);
+
+class FittedQuantity : public CoolProp::FuncWrapper1D
+{
+private:
+    fitted_quantities key;
+public:
+    FittedQuantity(fitted_quantities key) : key(key){};
+    double call(double T){ return fit_source(key, T); }
+};
+
+/// Evaluate a function of temperature from its fit if precomputed fits are in use and T is within the range of the fit
+static bool fitted(fitted_quantities key, double T, double &val)
+{
+    check_fluid_instantiation();
+    if (!FlagUsePrecomputedFits || Fits == NULL){ return false; }
+    if (!Fits->quantities_built[key]){
+        Fits->quantities_built[key] = true;
+        std::vector<double> breakpoints(2, T_min_fits); breakpoints[1] = T_max_fits;
+        double tol = 1e-12;
+        if (key == FIT_P_WS || key == FIT_VBAR_WS){
+            // Saturated liquid water only exists above the triple point
+            breakpoints[0] = 273.16; tol = 1e-9;
+        }
+        FittedQuantity func(key);
+        Fits->quantities[key].build(func, breakpoints, tol, true);
+    }
+    const ChebyshevFit1D &fit = Fits->quantities[key];
+    if (!fit.in_range(T)){ return false; }
+    val = fit.evaluate(T);
+    return true;
+}
+
+/// Get the fits at the given pressure, or NULL if they are not in use or have not been built
+static PressureFits *fitted_pressure(double p)
+{
+    check_fluid_instantiation();
+    if (!FlagUsePrecomputedFits || Fits == NULL){ return NULL; }
+    std::list<PressureFits> &pressures = Fits->pressures;
+    std::list<PressureFits>::iterator it = pressures.begin();
+    for (; it != pressures.end(); ++it){
+        if (it->p == p){ break; }
+    }
+    if (it == pressures.end()){
+        pressures.push_front(PressureFits(p));
+        if (pressures.size() > fit_pressure_count){ pressures.pop_back(); }
+    }
+    else if (it != pressures.begin()){
+        pressures.splice(pressures.begin(), pressures, it);
+    }
+    PressureFits &fits = pressures.front();
+    if (!fits.built && ++fits.calls >= fit_pressure_threshold){
+        fits.built = true;
+        build_pressure_fits(fits);
+    }
+    return fits.built ? &fits : NULL;
+}
+
+/// Solve for the temperature at which the saturation partial pressure of water in humid air at pressure p is p_w, by Newton's method on the fits
+/**
+Returns false if the fits at this pressure are not available or do not contain the solution
+*/
+static bool fitted_saturation_temperature(double p, double p_w, double T_guess, double &T)
+{
+    PressureFits *fits = fitted_pressure(p);
+    if (fits == NULL || !fits->ln_p_s.valid()){ return false; }
+    const ChebyshevFit1D &ln_p_s = fits->ln_p_s;
+    double target = log(p_w), T_lo = ln_p_s.Tmin(), T_hi = ln_p_s.Tmax();
+    if (!(target >= ln_p_s.evaluate(T_lo) && target <= ln_p_s.evaluate(T_hi))){ return false; }
+    T = (T_guess > T_lo && T_guess < T_hi) ? T_guess : 0.5*(T_lo + T_hi);
+    for (int iter = 0; iter < 100; ++iter){
+        double resid = ln_p_s.evaluate(T) - target;
+        // The saturation pressure increases with temperature, so the residual keeps the solution bracketed
+        if (resid > 0){ T_hi = T; } else { T_lo = T; }
+        double T_new = T - resid/ln_p_s.derivative(T);
+        if (!(T_new > T_lo && T_new < T_hi)){
+            // Bisect if the Newton step leaves the bracket
+            T_new = 0.5*(T_lo + T_hi);
+        }
+        double change = std::abs(T_new - T);
+        T = T_new;
+        if (change < 1e-10){ return true; }
+    }
+    return false;
+}
+
 // A couple of convenience functions that are needed quite a lot
 static double MM_Air(void)
 {
@@ -81,7 +394,8 @@ static double MM_Water(void)
 }
 static double B_Air(double T)
 {
-    check_fluid_instantiation();
+    double val;
+    if (fitted(FIT_B_AIR, T, val)){ return val; }
     Air->specify_phase(CoolProp::iphase_gas);
     Air->update_DmolarT_direct(1e-12,T);
     Air->unspecify_phase();
@@ -89,7 +403,8 @@ static double B_Air(double T)
 }
 static double dBdT_Air(double T)
 {
-    check_fluid_instantiation();
+    double val;
+    if (fitted(FIT_DBDT_AIR, T, val)){ return val; }
     Air->specify_phase(CoolProp::iphase_gas);
     Air->update_DmolarT_direct(1e-12,T);
     Air->unspecify_phase();
@@ -97,7 +412,8 @@ static double dBdT_Air(double T)
 }
 static double B_Water(double T)
 {
-    check_fluid_instantiation();
+    double val;
+    if (fitted(FIT_B_WATER, T, val)){ return val; }
     Water->specify_phase(CoolProp::iphase_gas);
     Water->update_DmolarT_direct(1e-12,T);
     Water->unspecify_phase();
@@ -105,7 +421,8 @@ static double B_Water(double T)
 }
 static double dBdT_Water(double T)
 {
-    check_fluid_instantiation();
+    double val;
+    if (fitted(FIT_DBDT_WATER, T, val)){ return val; }
     Water->specify_phase(CoolProp::iphase_gas);
     Water->update_DmolarT_direct(1e-12,T);
     Water->unspecify_phase();
@@ -113,7 +430,8 @@ static double dBdT_Water(double T)
 }
 static double C_Air(double T)
 {
-    check_fluid_instantiation();
+    double val;
+    if (fitted(FIT_C_AIR, T, val)){ return val; }
     Air->specify_phase(CoolProp::iphase_gas);
     Air->update_DmolarT_direct(1e-12,T);
     Air->unspecify_phase();
@@ -121,7 +439,8 @@ static double C_Air(double T)
 }
 static double dCdT_Air(double T)
 {
-    check_fluid_instantiation();
+    double val;
+    if (fitted(FIT_DCDT_AIR, T, val)){ return val; }
     Air->specify_phase(CoolProp::iphase_gas);
     Air->update_DmolarT_direct(1e-12,T);
     Air->unspecify_phase();
@@ -129,7 +448,8 @@ static double dCdT_Air(double T)
 }
 static double C_Water(double T)
 {
-    check_fluid_instantiation();
+    double val;
+    if (fitted(FIT_C_WATER, T, val)){ return val; }
     Water->specify_phase(CoolProp::iphase_gas);
     Water->update_DmolarT_direct(1e-12,T);
     Water->unspecify_phase();
@@ -137,7 +457,8 @@ static double C_Water(double T)
 }
 static double dCdT_Water(double T)
 {
-    check_fluid_instantiation();
+    double val;
+    if (fitted(FIT_DCDT_WATER, T, val)){ return val; }
     Water->specify_phase(CoolProp::iphase_gas);
     Water->update_DmolarT_direct(1e-12,T);
     Water->unspecify_phase();
@@ -166,6 +487,17 @@ void UseIsothermCompressCorrelation(int flag)
         printf("UseIsothermCompressCorrelation takes an integer, either 0 (no) or 1 (yes)\n");
     }
 }
+void UsePrecomputedFits(int flag)
+{
+    if (flag==0 || flag==1)
+    {
+        FlagUsePrecomputedFits=flag;
+    }
+    else
+    {
+        printf("UsePrecomputedFits takes an integer, either 0 (no) or 1 (yes)\n");
+    }
+}
 void UseIdealGasEnthalpyCorrelations(int flag)
 {
     if (flag==0 || flag==1)
@@ -247,7 +579,8 @@ static double Brent_HAProps_W(givens OutputKey, double p, givens In1Name, double
     }
     return W;
 }
-static double Brent_HAProps_T(givens OutputKey, double p, givens In1Name, double Input1, double TargetVal, double T_min, double T_max)
+/// If T_guess is valid, a secant solution starting from it is tried first, and kept if it lies in [T_min, T_max]
+static double Brent_HAProps_T(givens OutputKey, double p, givens In1Name, double Input1, double TargetVal, double T_min, double T_max, double T_guess = _HUGE)
 {
     double T;
     class BrentSolverResids : public CoolProp::FuncWrapper1D
@@ -276,6 +609,14 @@ static double Brent_HAProps_T(givens OutputKey, double p, givens In1Name, double
 
     BrentSolverResids BSR = BrentSolverResids(OutputKey, p, In1Name, Input1, TargetVal);
 
+    if (ValidNumber(T_guess)){
+        try{
+            T = CoolProp::Secant(BSR, T_guess, 1e-3, 1e-10*std::max(1.0, std::abs(TargetVal)), 10);
+            if (ValidNumber(T) && T >= T_min && T <= T_max){ return T; }
+        }
+        catch(...){}
+    }
+
     // Now we need to check the bounds and make sure that they are ok (don't yield invalid output)
     // and actually bound the solution
     double r_min = BSR.call(T_min);
@@ -318,6 +659,7 @@ static double Brent_HAProps_T(givens OutputKey, double p, givens In1Name, double
 static double Secant_Tdb_at_saturated_W(double psi_w, double p, double T_guess)
 {
     double T;
+    if (fitted_saturation_temperature(p, psi_w*p, T_guess, T)){ return T; }
     class BrentSolverResids : public CoolProp::FuncWrapper1D
     {
     private:
@@ -664,13 +1006,20 @@ double f_factor(double T, double p)
         line1,line2,line3,line4,line5,line6,line7,line8,k_T,beta_H,LHS,RHS,psi_ws,
         vbar_ws;
 
+    PressureFits *fits = fitted_pressure(p);
+    if (fits != NULL && fits->f.in_range(T)){
+        return fits->f.evaluate(T);
+    }
+
     // Saturation pressure [Pa]
     if (T>273.16)
     {
         // It is liquid water
-        Water->update(CoolProp::QT_INPUTS, 0, T);
-        p_ws = Water->p();
-        vbar_ws = 1.0/Water->keyed_output(CoolProp::iDmolar); //[m^3/mol]
+        if (!fitted(FIT_P_WS, T, p_ws) || !fitted(FIT_VBAR_WS, T, vbar_ws)){
+            Water->update(CoolProp::QT_INPUTS, 0, T);
+            p_ws = Water->p();
+            vbar_ws = 1.0/Water->keyed_output(CoolProp::iDmolar); //[m^3/mol]
+        }
         beta_H = HenryConstant(T); //[1/Pa]
     }
     else
@@ -878,6 +1227,8 @@ double Pressure(double T, double v_bar, double psi_w){
 double IdealGasMolarEnthalpy_Water(double T, double p)
 {
     double hbar_w_0, tau, hbar_w;
+    // The ideal-gas enthalpy does not depend on pressure
+    if (fitted(FIT_H0_WATER, T, hbar_w)){ return hbar_w; }
     // Ideal-Gas contribution to enthalpy of water
     hbar_w_0 = -0.01102303806; //[J/mol]
     
@@ -903,6 +1254,9 @@ double IdealGasMolarEntropy_Water(double T, double p)
     
     double sbar_w, tau, R_bar;
     R_bar = 8.314371; //[J/mol/K]
+
+    // The fit is of the entropy at 101325 Pa
+    if (fitted(FIT_S0_WATER, T, sbar_w)){ return sbar_w - R_bar*log(p/101325); }
     
     // Calculate the offset in the water entropy from a given state with a known (desired) entropy
     double Tref = 473.15, pref = 101325, sref = 141.18297895840303;
@@ -922,6 +1276,8 @@ double IdealGasMolarEntropy_Water(double T, double p)
 double IdealGasMolarEnthalpy_Air(double T, double p)
 {
     double hbar_a_0, tau, hbar_a, R_bar_Lemmon;
+    // The ideal-gas enthalpy does not depend on pressure
+    if (fitted(FIT_H0_AIR, T, hbar_a)){ return hbar_a; }
     // Ideal-Gas contribution to enthalpy of air
     hbar_a_0 = -7914.149298; //[J/mol]
     
@@ -951,6 +1307,9 @@ double IdealGasMolarEntropy_Air(double T, double vmolar_a)
 
     vmolar_a_0 = R_bar_Lemmon*T0/p0; //[m^3/mol]
 
+    // The fit is of the entropy at vmolar_a_0
+    if (fitted(FIT_S0_AIR, T, sbar_a)){ return sbar_a + R_bar_Lemmon*log(vmolar_a/vmolar_a_0); }
+
     // Calculate the offset in the air entropy from a given state with a known (desired) entropy
     double Tref = 473.15, vmolarref = 0.038837605637863169, sref = 212.22365283759311;
     Air->update(CoolProp::DmolarT_INPUTS, 1/vmolar_a_0, Tref);
@@ -969,6 +1328,108 @@ double IdealGasMolarEntropy_Air(double T, double vmolar_a)
     return sbar_a; //[J/mol[air]/K]
 }
 
+/// The exact value of a function of temperature that can be fitted
+static double fit_source(fitted_quantities key, double T)
+{
+    switch (key){
+        case FIT_B_AIR: return B_Air(T);
+        case FIT_DBDT_AIR: return dBdT_Air(T);
+        case FIT_C_AIR: return C_Air(T);
+        case FIT_DCDT_AIR: return dCdT_Air(T);
+        case FIT_B_WATER: return B_Water(T);
+        case FIT_DBDT_WATER: return dBdT_Water(T);
+        case FIT_C_WATER: return C_Water(T);
+        case FIT_DCDT_WATER: return dCdT_Water(T);
+        case FIT_P_WS:
+            Water->update(CoolProp::QT_INPUTS, 0, T);
+            return Water->p();
+        case FIT_VBAR_WS:
+            Water->update(CoolProp::QT_INPUTS, 0, T);
+            return 1.0/Water->keyed_output(CoolProp::iDmolar);
+        case FIT_H0_WATER: return IdealGasMolarEnthalpy_Water(T, 101325);
+        case FIT_H0_AIR: return IdealGasMolarEnthalpy_Air(T, 101325);
+        case FIT_S0_WATER: return IdealGasMolarEntropy_Water(T, 101325);
+        case FIT_S0_AIR: return IdealGasMolarEntropy_Air(T, 8.314510*273.15/101325);
+        default:
+            throw CoolProp::ValueError(format("Invalid fitted quantity: %d", key));
+    }
+}
+
+/// Mass enthalpy of liquid water in J/kg, with the density from IF97
+static double LiquidWaterEnthalpy(double T, double p)
+{
+    PressureFits *fits = fitted_pressure(p);
+    if (fits != NULL){
+        if (!fits->h_w_built){
+            fits->h_w_built = true;
+            // Liquid up to just below the saturation temperature, where IF97 switches regions
+            if (p > 611.657 && p < 22.064e6){
+                class LiquidWaterEnthalpyFunction : public CoolProp::FuncWrapper1D
+                {
+                public:
+                    double p;
+                    LiquidWaterEnthalpyFunction(double p) : p(p){};
+                    double call(double T){ return LiquidWaterEnthalpy(T, p); }
+                } func(p);
+                std::vector<double> breakpoints(2, 273.16); breakpoints[1] = std::min(IF97::Tsat97(p) - 1e-3, T_max_fits);
+                fits->h_w.build(func, breakpoints, 1e-10, true);
+            }
+        }
+        if (fits->h_w.in_range(T)){ return fits->h_w.evaluate(T); }
+    }
+    WaterIF97->update(CoolProp::PT_INPUTS, p, T);
+    Water->update(CoolProp::DmassT_INPUTS, WaterIF97->rhomass(), T);
+    return Water->keyed_output(CoolProp::iHmass); //[J/kg_water]
+}
+
+/// Build the fits of the enhancement factor and the saturation partial pressure of water at one pressure
+static void build_pressure_fits(PressureFits &fits)
+{
+    class EnhancementFactorFunction : public CoolProp::FuncWrapper1D
+    {
+    public:
+        double p;
+        EnhancementFactorFunction(double p) : p(p){};
+        double call(double T){ return f_factor(T, p); }
+    } f_func(fits.p);
+    class SaturationPartialPressureFunction : public CoolProp::FuncWrapper1D
+    {
+    public:
+        double p;
+        SaturationPartialPressureFunction(double p) : p(p){};
+        double call(double T){ return log(f_factor(T, p)*((T >= 273.16) ? IF97::psat97(T) : psub_Ice(T))); }
+    } ln_p_s_func(fits.p);
+    class SublimationFunction : public CoolProp::FuncWrapper1D
+    {
+    public:
+        double p;
+        SublimationFunction(double p) : p(p){};
+        double call(double T){ return psub_Ice(T) - p; }
+    } sub_func(fits.p);
+
+    // The enhancement factor has kinks where the saturation pressure of water crosses the pressure
+    std::vector<double> breakpoints(1, T_min_fits);
+    try{
+        if (fits.p < psub_Ice(273.16)){
+            breakpoints.push_back(CoolProp::Brent(sub_func, T_min_fits, 273.16, DBL_EPSILON, 1e-10, 100));
+        }
+        breakpoints.push_back(273.16);
+        if (fits.p > psub_Ice(273.16) && fits.p < Water->p_critical()){
+            Water->update(CoolProp::PQ_INPUTS, fits.p, 0);
+            if (Water->T() > 273.16 && Water->T() < T_max_fits){
+                breakpoints.push_back(Water->T());
+            }
+        }
+        breakpoints.push_back(T_max_fits);
+    }
+    catch(...){
+        return;
+    }
+    // The enhancement factor itself is only converged to within 1e-8
+    fits.f.build(f_func, breakpoints, 1e-8, true);
+    fits.ln_p_s.build(ln_p_s_func, breakpoints, 1e-8, false);
+}
+
 /**
  @param T Temperature, in K
  @param p Pressure (not used)
@@ -1145,6 +1606,7 @@ double DewpointTemperature(double T, double p, double psi_w)
     else{
         T0 = 268;
     }
+    if (fitted_saturation_temperature(p, p_w, T0, Tdp)){ return Tdp; }
     // A good guess for Tdp is that enhancement factor is unity, which yields
     // p_w_s = p_w, and get guess for T from saturation temperature
 
@@ -1221,11 +1683,8 @@ public:
         psi_wb = W_s_wb/(epsilon+W_s_wb);
         if (Twb > 273.16)
         {
-            // Use IF97 to do the flash
-            WaterIF97->update(CoolProp::PT_INPUTS, _p, Twb);
             // Enthalpy of water [J/kg_water]
-            Water->update(CoolProp::DmassT_INPUTS, WaterIF97->rhomass(), Twb);
-            h_w = Water->keyed_output(CoolProp::iHmass); //[J/kg_water]
+            h_w = LiquidWaterEnthalpy(Twb, _p);
         }
         else
         {
@@ -1544,7 +2003,7 @@ bool match_input_key(const std::vector<givens> &input_keys, givens key)
 }
 
 /// Calculate T (dry bulb temp) and psi_w (water mole fraction) given the pair of inputs
-void _HAPropsSI_inputs(double p, const std::vector<givens> &input_keys, const std::vector<double> &input_vals, double &T, double &psi_w)
+void _HAPropsSI_inputs(double p, const std::vector<givens> &input_keys, const std::vector<double> &input_vals, double &T, double &psi_w, HAPropsSIGuesses *guesses)
 {
     if (CoolProp::get_debug_level() > 0){ std::cout << format("length of input_keys is %d\n", input_keys.size()); }
     if (input_keys.size() != input_vals.size()){ throw CoolProp::ValueError(format("Length of input_keys (%d) does not equal that of input_vals (%d)", input_keys.size(), input_vals.size())); }
@@ -1569,7 +2028,7 @@ void _HAPropsSI_inputs(double p, const std::vector<givens> &input_keys, const st
                 double W;
                 try{
                     // Find the value for W
-                    double W_guess = 0.0001;
+                    double W_guess = (guesses != NULL && ValidNumber(guesses->W) && guesses->W > 0) ? guesses->W : 0.0001;
                     W = Secant_HAProps_W(p, T, othergiven, input_vals[other], W_guess);
                     if (!ValidNumber(W)){
                         throw CoolProp::ValueError("Iterative value for W is invalid");
@@ -1634,8 +2093,13 @@ void _HAPropsSI_inputs(double p, const std::vector<givens> &input_keys, const st
                     throw CoolProp::ValueError("For dry air, dewpoint is an invalid input variable\n");
                 }
             }
+            else if (guesses != NULL && guesses->p_sat == p){
+                T_max = guesses->T_sat - 1;
+            }
             else{
-                T_max = CoolProp::PropsSI("T","P",p,"Q",0,"Water") - 1;
+                Water->update(CoolProp::PQ_INPUTS, p, 0);
+                T_max = Water->T() - 1;
+                if (guesses != NULL){ guesses->p_sat = p; guesses->T_sat = Water->T(); }
             }
         }
         // Minimum drybulb temperature is the drybulb temperature corresponding to saturated air for the humidity ratio
@@ -1665,8 +2129,9 @@ void _HAPropsSI_inputs(double p, const std::vector<givens> &input_keys, const st
         }
 
         try{
-            // Use the Brent's method solver to find T.  Slow but reliable
-            T = Brent_HAProps_T(SecondaryInputKey, p, MainInputKey, MainInputValue, SecondaryInputValue, T_min,T_max);
+            // Use the Brent's method solver to find T.  Slow but reliable; starts from the neighbouring solution if there is one
+            double T_guess = (guesses != NULL) ? guesses->T : _HUGE;
+            T = Brent_HAProps_T(SecondaryInputKey, p, MainInputKey, MainInputValue, SecondaryInputValue, T_min, T_max, T_guess);
         }
         catch(std::exception &e){
             if (CoolProp::get_debug_level() > 0){ std::cout << "ERROR: " << e.what() << std::endl; }
@@ -1803,70 +2268,140 @@ double _HAPropsSI_outputs(givens OutputType, double p, double T, double psi_w)
             return _HUGE;
     }
 }
-double HAPropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3)
+HumidAirState::HumidAirState()
 {
-    try
-    {
-        // Add a check to make sure that Air and Water fluid states have been properly instantiated
-        check_fluid_instantiation();
-        Water->clear();
-        Air->clear();
+    Water.reset(new CoolProp::HelmholtzEOSBackend("Water"));
+    WaterIF97.reset(CoolProp::AbstractState::factory("IF97","Water"));
+    Air.reset(new CoolProp::HelmholtzEOSBackend("Air"));
+    fits.reset(new HumidAirFits());
+}
+/// Find which of the three inputs is the pressure and load the keys of the other two into input_keys; returns the index of the pressure
+static std::size_t parse_HAPropsSI_inputs(givens In1Type, givens In2Type, givens In3Type, std::vector<givens> &input_keys)
+{
+    std::size_t ip;
+    if (In1Type == GIVEN_P){ ip = 0; input_keys[0] = In2Type; input_keys[1] = In3Type; }
+    else if (In2Type == GIVEN_P){ ip = 1; input_keys[0] = In1Type; input_keys[1] = In3Type; }
+    else if (In3Type == GIVEN_P){ ip = 2; input_keys[0] = In1Type; input_keys[1] = In2Type; }
+    else{
+        throw CoolProp::ValueError("Pressure must be one of the inputs to HAPropsSI");
+    }
+    if (input_keys[0] == input_keys[1]){
+        throw CoolProp::ValueError("Other two inputs to HAPropsSI aside from pressure cannot be the same");
+    }
+    return ip;
+}
+double HumidAirState::PropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3)
+{
+    // All the functions called below work on the evaluators of this state
+    ScopedEvaluators evaluators(*this);
+    Water->clear();
+    Air->clear();
 
-        if (CoolProp::get_debug_level() > 0){ std::cout << format("HAPropsSI(%s,%s,%g,%s,%g,%s,%g)\n", OutputName.c_str(), Input1Name.c_str(), Input1, Input2Name.c_str(), Input2, Input3Name.c_str(), Input3); }
-        
-        std::vector<givens> input_keys(2);
-        std::vector<double> input_vals(2);
-        
-        givens In1Type, In2Type, In3Type, OutputType;
-        double p, T = _HUGE, psi_w = _HUGE;
+    if (CoolProp::get_debug_level() > 0){ std::cout << format("HAPropsSI(%s,%s,%g,%s,%g,%s,%g)\n", OutputName.c_str(), Input1Name.c_str(), Input1, Input2Name.c_str(), Input2, Input3Name.c_str(), Input3); }
+    
+    std::vector<givens> input_keys(2);
+    std::vector<double> input_vals(2);
+    
+    givens In1Type, In2Type, In3Type, OutputType;
+    double p, T = _HUGE, psi_w = _HUGE;
 
-        // First figure out what kind of inputs you have, convert names to enum values
-        In1Type = Name2Type(Input1Name.c_str());
-        In2Type = Name2Type(Input2Name.c_str());
-        In3Type = Name2Type(Input3Name.c_str());
-        
-        // Output type
-        OutputType = Name2Type(OutputName.c_str());
-        
-        // Check for trivial inputs
-        if (OutputType == In1Type){return Input1;}
-        if (OutputType == In2Type){return Input2;}
-        if (OutputType == In3Type){return Input3;}
-        
-        // Check that pressure is provided; load input vectors
-        if (In1Type == GIVEN_P){ 
-            p = Input1; 
-            input_keys[0] = In2Type; input_keys[1] = In3Type; 
-            input_vals[0] = Input2; input_vals[1] = Input3;
-        }
-        else if (In2Type == GIVEN_P){ 
-            p = Input2; 
-            input_keys[0] = In1Type; input_keys[1] = In3Type; 
-            input_vals[0] = Input1; input_vals[1] = Input3;
-        }
-        else if (In3Type == GIVEN_P){ 
-            p = Input3;
-            input_keys[0] = In1Type; input_keys[1] = In2Type; 
-            input_vals[0] = Input1; input_vals[1] = Input2;
+    // First figure out what kind of inputs you have, convert names to enum values
+    In1Type = Name2Type(Input1Name.c_str());
+    In2Type = Name2Type(Input2Name.c_str());
+    In3Type = Name2Type(Input3Name.c_str());
+    
+    // Output type
+    OutputType = Name2Type(OutputName.c_str());
+    
+    // Check for trivial inputs
+    if (OutputType == In1Type){return Input1;}
+    if (OutputType == In2Type){return Input2;}
+    if (OutputType == In3Type){return Input3;}
+    
+    // Check that pressure is provided; load input vectors
+    double Inputs[3] = {Input1, Input2, Input3};
+    std::size_t ip = parse_HAPropsSI_inputs(In1Type, In2Type, In3Type, input_keys);
+    p = Inputs[ip];
+    input_vals[0] = Inputs[ip == 0 ? 1 : 0]; input_vals[1] = Inputs[ip == 2 ? 1 : 2];
+    
+    // Parse the inputs to get to set of p, T, psi_w
+    _HAPropsSI_inputs(p, input_keys, input_vals, T, psi_w);
+
+    if (CoolProp::get_debug_level() > 0){ std::cout << format("HAPropsSI input conversion yields T: %g, psi_w: %g\n", T, psi_w); }
+
+    // Calculate the output value desired
+    double val = _HAPropsSI_outputs(OutputType, p, T, psi_w);
+    
+    if (CoolProp::get_debug_level() > 0){ std::cout << format("HAPropsSI is about to return %g\n", val); }
+    return val;
+}
+std::vector<std::vector<double> > HumidAirState::PropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3)
+{
+    ScopedEvaluators evaluators(*this);
+    Water->clear();
+    Air->clear();
+
+    if (Input1.size() != Input2.size() || Input1.size() != Input3.size()){
+        throw CoolProp::ValueError(format("Sizes of inputs to HAPropsSImulti [%d,%d,%d] are not all the same", Input1.size(), Input2.size(), Input3.size()));
+    }
+    // Parse all the names once
+    givens InTypes[3] = {Name2Type(Input1Name.c_str()), Name2Type(Input2Name.c_str()), Name2Type(Input3Name.c_str())};
+    const std::vector<double> *Inputs[3] = {&Input1, &Input2, &Input3};
+    std::vector<givens> OutputTypes(Outputs.size());
+    // For the outputs that are also inputs, the index of that input, otherwise -1
+    std::vector<int> trivial(Outputs.size(), -1);
+    for (std::size_t j = 0; j < Outputs.size(); ++j){
+        OutputTypes[j] = Name2Type(Outputs[j].c_str());
+        for (int k = 2; k >= 0; --k){
+            if (OutputTypes[j] == InTypes[k]){ trivial[j] = k; }
+        }
+    }
+    std::vector<givens> input_keys(2);
+    std::size_t ip = parse_HAPropsSI_inputs(InTypes[0], InTypes[1], InTypes[2], input_keys);
+    const std::vector<double> &P = *Inputs[ip], &In_a = *Inputs[ip == 0 ? 1 : 0], &In_b = *Inputs[ip == 2 ? 1 : 2];
+
+    std::vector<double> input_vals(2);
+    std::vector<std::vector<double> > IO(Input1.size(), std::vector<double>(Outputs.size(), _HUGE));
+    HAPropsSIGuesses guesses;
+    for (std::size_t i = 0; i < IO.size(); ++i){
+        std::vector<double> &out = IO[i];
+        for (std::size_t j = 0; j < Outputs.size(); ++j){
+            if (trivial[j] >= 0){ out[j] = (*Inputs[trivial[j]])[i]; }
+        }
+        double p = P[i], T = _HUGE, psi_w = _HUGE;
+        input_vals[0] = In_a[i]; input_vals[1] = In_b[i];
+        try{
+            _HAPropsSI_inputs(p, input_keys, input_vals, T, psi_w, &guesses);
         }
-        else{
-            throw CoolProp::ValueError("Pressure must be one of the inputs to HAPropsSI");
+        catch (std::exception &e){
+            CoolProp::set_error_string(e.what());
+            T = _HUGE;
         }
-        
-        if (input_keys[0] == input_keys[1]){
-            throw CoolProp::ValueError("Other two inputs to HAPropsSI aside from pressure cannot be the same");
+        if (!ValidNumber(T) || !ValidNumber(psi_w)){
+            // Do not start the next point from a failed one
+            guesses.T = _HUGE; guesses.W = _HUGE;
+            continue;
         }
-        
-        // Parse the inputs to get to set of p, T, psi_w
-        _HAPropsSI_inputs(p, input_keys, input_vals, T, psi_w);
-
-        if (CoolProp::get_debug_level() > 0){ std::cout << format("HAPropsSI input conversion yields T: %g, psi_w: %g\n", T, psi_w); }
-
-        // Calculate the output value desired
-        double val = _HAPropsSI_outputs(OutputType, p, T, psi_w);
-        
-        if (CoolProp::get_debug_level() > 0){ std::cout << format("HAPropsSI is about to return %g\n", val); }
-        return val;
+        for (std::size_t j = 0; j < Outputs.size(); ++j){
+            if (trivial[j] >= 0){ continue; }
+            try{
+                out[j] = _HAPropsSI_outputs(OutputTypes[j], p, T, psi_w);
+            }
+            catch (std::exception &e){
+                CoolProp::set_error_string(e.what());
+            }
+        }
+        guesses.T = T;
+        guesses.W = HumidityRatio(psi_w);
+    }
+    return IO;
+}
+double HAPropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3)
+{
+    try
+    {
+        // Each thread works on its own evaluators so that concurrent calls do not interfere
+        return get_thread_state().PropsSI(OutputName, Input1Name, Input1, Input2Name, Input2, Input3Name, Input3);
     }
     catch (std::exception &e)
     {
@@ -1879,6 +2414,68 @@ double HAPropsSI(const std::string &OutputName, const std::string &Input1Name, d
     }
 }
 
+/// Evaluate the points [istart, iend) of a call to HAPropsSImulti on a state taken from the idle states
+static void HAPropsSImulti_block(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3, std::size_t istart, std::size_t iend, std::vector<std::vector<double> > &IO)
+{
+    shared_ptr<HumidAirState> state;
+    try{
+        state = acquire_state();
+        std::vector<double> In1(Input1.begin() + istart, Input1.begin() + iend), In2(Input2.begin() + istart, Input2.begin() + iend), In3(Input3.begin() + istart, Input3.begin() + iend);
+        std::vector<std::vector<double> > block = state->PropsSImulti(Outputs, Input1Name, In1, Input2Name, In2, Input3Name, In3);
+        for (std::size_t i = istart; i < iend; ++i){ IO[i].swap(block[i - istart]); }
+    }
+    catch (std::exception &e){
+        // Leave the points of this block as _HUGE
+        CoolProp::set_error_string(e.what());
+    }
+    if (state){ release_state(state); }
+}
+std::vector<std::vector<double> > HAPropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3, std::size_t Nthreads)
+{
+    // Below this many points per thread, starting the threads costs more than it saves
+    const std::size_t min_points_per_thread = 100;
+    try
+    {
+        if (Nthreads == 0){ Nthreads = std::max(1U, std::thread::hardware_concurrency()); }
+        Nthreads = std::min(Nthreads, Input1.size()/min_points_per_thread);
+#if !defined(COOLPROP_CXX11_THREAD_LOCAL)
+        // The evaluations are serialized, so more threads would not help
+        Nthreads = 1;
+#endif
+        if (Nthreads <= 1){
+            return get_thread_state().PropsSImulti(Outputs, Input1Name, Input1, Input2Name, Input2, Input3Name, Input3);
+        }
+        // Check the names and sizes before starting any threads
+        HumidAirState &state = get_thread_state();
+        state.PropsSImulti(Outputs, Input1Name, std::vector<double>(), Input2Name, std::vector<double>(), Input3Name, std::vector<double>());
+        if (Input1.size() != Input2.size() || Input1.size() != Input3.size()){
+            throw CoolProp::ValueError(format("Sizes of inputs to HAPropsSImulti [%d,%d,%d] are not all the same", Input1.size(), Input2.size(), Input3.size()));
+        }
+        // Contiguous blocks, so that each point still starts from its neighbour; the calling thread takes the last one
+        std::vector<std::vector<double> > IO(Input1.size(), std::vector<double>(Outputs.size(), _HUGE));
+        std::vector<std::thread> threads;
+        for (std::size_t k = 0; k < Nthreads; ++k){
+            std::size_t istart = Input1.size()*k/Nthreads, iend = Input1.size()*(k + 1)/Nthreads;
+            if (k + 1 < Nthreads){
+                threads.push_back(std::thread(HAPropsSImulti_block, std::cref(Outputs), std::cref(Input1Name), std::cref(Input1), std::cref(Input2Name), std::cref(Input2), std::cref(Input3Name), std::cref(Input3), istart, iend, std::ref(IO)));
+            }
+            else{
+                HAPropsSImulti_block(Outputs, Input1Name, Input1, Input2Name, Input2, Input3Name, Input3, istart, iend, IO);
+            }
+        }
+        for (std::size_t k = 0; k < threads.size(); ++k){ threads[k].join(); }
+        return IO;
+    }
+    catch (std::exception &e)
+    {
+        CoolProp::set_error_string(e.what());
+    }
+    catch (...)
+    {
+    }
+    return std::vector<std::vector<double> >();
+}
+
 double HAProps_Aux(const char* Name,double T, double p, double W, char *units)
 {
     // This function provides some things that are not usually needed, but could be interesting for debug purposes.
@@ -2127,6 +2724,7 @@ double IceProps(const char* Name, double T, double p)
 
 #ifdef ENABLE_CATCH
 #include <math.h>
+#include <thread>
 #include "catch.hpp"
 
 TEST_CASE("Check HA Virials from Table A.2.1","[RP1485]")
@@ -2337,6 +2935,105 @@ TEST_CASE("Assorted tests","[HAPropsSI]")
     CHECK(ValidNumber(HumidAir::HAPropsSI("T", "B", 252.84, "W", 5.097e-4, "P", 101325)));
     CHECK(ValidNumber(HumidAir::HAPropsSI("T", "B",290, "R", 1, "P", 101325)));
 }
+TEST_CASE("Concurrent humid air evaluations","[HAPropsSI][HumidAirState]")
+{
+    const std::size_t Nthreads = 4, N = 20;
+    std::vector<double> expected(N);
+    for (std::size_t i = 0; i < N; ++i){
+        expected[i] = HumidAir::HAPropsSI("H", "T", 250 + i, "P", 101325, "R", 0.5);
+    }
+    SECTION("HumidAirState matches HAPropsSI"){
+        HumidAir::HumidAirState state;
+        for (std::size_t i = 0; i < N; ++i){
+            CHECK(state.PropsSI("H", "T", 250 + i, "P", 101325, "R", 0.5) == expected[i]);
+        }
+        CHECK_THROWS(state.PropsSI("H", "T", 280, "W", 0.01, "R", 0.5));
+    }
+    SECTION("HAPropsSI from several threads"){
+        std::vector<std::vector<double> > results(Nthreads, std::vector<double>(N));
+        std::vector<std::thread> threads;
+        for (std::size_t j = 0; j < Nthreads; ++j){
+            threads.push_back(std::thread([&results, j, N](){
+                for (std::size_t i = 0; i < N; ++i){
+                    results[j][i] = HumidAir::HAPropsSI("H", "T", 250 + i, "P", 101325, "R", 0.5);
+                }
+            }));
+        }
+        for (std::size_t j = 0; j < Nthreads; ++j){ threads[j].join(); }
+        for (std::size_t j = 0; j < Nthreads; ++j){
+            for (std::size_t i = 0; i < N; ++i){
+                CAPTURE(j); CAPTURE(i);
+                CHECK(results[j][i] == expected[i]);
+            }
+        }
+    }
+    SECTION("HAPropsSI from short-lived threads, which hand their states on when they exit"){
+        for (std::size_t round = 0; round < 3; ++round){
+            std::vector<double> results(N);
+            for (std::size_t i = 0; i < N; ++i){
+                std::thread t([&results, i](){ results[i] = HumidAir::HAPropsSI("H", "T", 250 + i, "P", 101325, "R", 0.5); });
+                t.join();
+            }
+            for (std::size_t i = 0; i < N; ++i){
+                CAPTURE(round); CAPTURE(i);
+                CHECK(results[i] == expected[i]);
+            }
+        }
+    }
+}
+TEST_CASE("HAPropsSImulti matches HAPropsSI","[HAPropsSI][HAPropsSImulti]")
+{
+    const std::size_t N = 300;
+    std::vector<std::string> outputs = strsplit("T&W&B&R", '&');
+    std::vector<double> H(N), P(N, 101325), R(N);
+    for (std::size_t i = 0; i < N; ++i){
+        H[i] = 10000 + 200*i;
+        R[i] = 0.2 + 0.6*i/N;
+    }
+    // The last point has no solution
+    H[N-1] = -1e6;
+    SECTION("one thread and several threads"){
+        for (std::size_t Nthreads = 1; Nthreads <= 3; Nthreads += 2){
+            std::vector<std::vector<double> > IO = HumidAir::HAPropsSImulti(outputs, "H", H, "P", P, "R", R, Nthreads);
+            REQUIRE(IO.size() == N);
+            for (std::size_t i = 0; i < N - 1; ++i){
+                for (std::size_t j = 0; j < outputs.size(); ++j){
+                    double expected = HumidAir::HAPropsSI(outputs[j], "H", H[i], "P", P[i], "R", R[i]);
+                    CAPTURE(Nthreads); CAPTURE(i); CAPTURE(outputs[j]);
+                    CHECK(std::abs(IO[i][j]/expected - 1) < 1e-5);
+                }
+            }
+            CHECK(!ValidNumber(IO[N-1][0]));
+            CHECK(IO[N-1][3] == R[N-1]);
+        }
+    }
+    SECTION("invalid names"){
+        CHECK(HumidAir::HAPropsSImulti(outputs, "H", H, "T", P, "R", R).empty());
+        CHECK(HumidAir::HAPropsSImulti(outputs, "H", H, "P", P, "H", R).empty());
+    }
+}
+TEST_CASE("Precomputed fits reproduce the humid air properties","[HAPropsSI][HumidAirFits]")
+{
+    const std::size_t Noutputs = 6;
+    std::string outputs[Noutputs] = {"H", "S", "W", "B", "D", "V"};
+    HumidAir::HumidAirState state;
+    for (double T = 240; T < 330; T += 10){
+        for (std::size_t i = 0; i < Noutputs; ++i){
+            HumidAir::UsePrecomputedFits(0);
+            double expected = state.PropsSI(outputs[i], "T", T, "P", 101325, "R", 0.5);
+            HumidAir::UsePrecomputedFits(1);
+            double actual = state.PropsSI(outputs[i], "T", T, "P", 101325, "R", 0.5);
+            CAPTURE(outputs[i]); CAPTURE(T); CAPTURE(expected); CAPTURE(actual);
+            CHECK(std::abs(actual/expected - 1) < 1e-6);
+        }
+        // Inverse problems
+        double h = state.PropsSI("H", "T", T, "P", 101325, "R", 0.5);
+        double Twb = state.PropsSI("B", "T", T, "P", 101325, "R", 0.5);
+        CHECK(std::abs(state.PropsSI("T", "H", h, "P", 101325, "R", 0.5) - T) < 1e-4);
+        CHECK(std::abs(state.PropsSI("T", "B", Twb, "P", 101325, "R", 0.5) - T) < 1e-4);
+    }
+    HumidAir::UsePrecomputedFits(0);
+}
 // a predicate implemented as a function:
 bool is_not_a_pair (const std::set<std::size_t> &item) { return item.size() != 2; }
 
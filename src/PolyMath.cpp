@@ -458,6 +458,15 @@ double Polynomial2DFrac::evaluate(const Eigen::MatrixXd &coefficients, const dou
         throw ValueError(format("%s (%d): A fraction cannot be evaluated with zero as denominator, x_in-x_base=%f ",__FILE__,__LINE__,x_in-x_base));
     }
 
+    if (firstExponent==0) { // Plain polynomial, evaluated in place
+        const double *coeffs = coefficients.data(); // A vector is contiguous in either orientation
+        double result = 0;
+        for (int i=static_cast<int>(r*c)-1; i>=0; i--) {
+            result = result*(x_in-x_base) + coeffs[i];
+        }
+        return result;
+    }
+
     Eigen::MatrixXd tmpCoeffs(coefficients);
     if ( c==1 ) {
         tmpCoeffs.transposeInPlace();
@@ -503,6 +512,20 @@ double Polynomial2DFrac::evaluate(const Eigen::MatrixXd &coefficients, const dou
         throw ValueError(format("%s (%d): A fraction cannot be evaluated with zero as denominator, y_in-y_base=%f ",__FILE__,__LINE__,y_in-y_base));
     }
 
+    if ( (x_exp==0) && (y_exp==0) ) { // Plain polynomial, evaluated in place with a Horner scheme in both dimensions
+        const double dx = x_in-x_base, dy = y_in-y_base;
+        double result = 0;
+        for (int i=static_cast<int>(coefficients.rows())-1; i>=0; i--) {
+            double row = 0;
+            for (int j=static_cast<int>(coefficients.cols())-1; j>=0; j--) {
+                row = row*dy + coefficients(i,j);
+            }
+            result = result*dx + row;
+        }
+        if (this->do_debug()) std::cout << "Running      2D evaluate(" << mat_to_string(coefficients) << ", x_in:" << vec_to_string(x_in) << ", y_in:" << vec_to_string(y_in) << "): " << result << std::endl;
+        return result;
+    }
+
     Eigen::MatrixXd tmpCoeffs(coefficients);
     Eigen::MatrixXd newCoeffs;
     size_t r = tmpCoeffs.rows();
@@ -4,6 +4,9 @@
 #include "DataStructures.h"
 #include "../Backends/Helmholtz/HelmholtzEOSMixtureBackend.h"
 #include "../Backends/Helmholtz/HelmholtzEOSBackend.h"
+#include "../Backends/Helmholtz/PhaseEnvelopeRoutines.h"
+#include "../Backends/Helmholtz/VLERoutines.h"
+#include "../Backends/Helmholtz/HSFlashGuessMap.h"
 // ############################################
 //                      TESTS
 // ############################################
@@ -1974,6 +1977,455 @@ TEST_CASE("Check the changing of reducing function constants", "[reducing]")
     CHECK(Tdiff > 1e-3); // Make sure that it actually got the change to the interaction parameters
 }
 
+TEST_CASE("Check the indexed lookups in the phase envelope", "[phase_envelope_index]")
+{
+    shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", "Methane&Ethane"));
+    std::vector<double> z(2); z[0] = 0.2; z[1] = 1-z[0];
+    AS->set_mole_fractions(z);
+    AS->build_phase_envelope("");
+    const CoolProp::PhaseEnvelopeData &env = AS->get_phase_envelope_data();
+    REQUIRE(!env.p_index.empty());
+    // A copy without the indices falls back to the linear scan
+    CoolProp::PhaseEnvelopeData env_linear = env;
+    env_linear.clear_index();
+    
+    parameters keys[] = {iP, iT, iHmolar, iSmolar, iDmolar};
+    for (std::size_t k = 0; k < sizeof(keys)/sizeof(keys[0]); ++k){
+        std::vector<double> values;
+        switch (keys[k]){
+            case iP: values = env.p; break;
+            case iT: values = env.T; break;
+            case iHmolar: values = env.hmolar_vap; break;
+            case iSmolar: values = env.smolar_vap; break;
+            default: values = env.rhomolar_vap; break;
+        }
+        double minval = *std::min_element(values.begin(), values.end()), maxval = *std::max_element(values.begin(), values.end());
+        // Values at the points themselves and in between them
+        std::size_t N = values.size();
+        for (std::size_t i = 0; i + 1 < N; ++i){ values.push_back((values[i]+values[i+1])/2); }
+        values.push_back(minval - 1); values.push_back(maxval + 1);
+        for (std::size_t i = 0; i < values.size(); ++i){
+            CAPTURE(keys[k]);
+            CAPTURE(values[i]);
+            std::vector<std::pair<std::size_t, std::size_t> > indexed = CoolProp::PhaseEnvelopeRoutines::find_intersections(env, keys[k], values[i]);
+            std::vector<std::pair<std::size_t, std::size_t> > linear = CoolProp::PhaseEnvelopeRoutines::find_intersections(env_linear, keys[k], values[i]);
+            CHECK(indexed == linear);
+        }
+    }
+    SECTION("batched is_inside matches the single-point version"){
+        std::vector<double> p, T;
+        for (double pp = 1e5; pp < 5e6; pp *= 1.5){
+            for (double TT = 150; TT < 300; TT += 10){
+                p.push_back(pp); T.push_back(TT);
+            }
+        }
+        std::vector<bool> inside = CoolProp::PhaseEnvelopeRoutines::is_inside(env, iP, p, iT, T);
+        REQUIRE(inside.size() == p.size());
+        for (std::size_t i = 0; i < p.size(); ++i){
+            CAPTURE(p[i]);
+            CAPTURE(T[i]);
+            std::size_t iclosest; CoolProp::SimpleState closest_state;
+            if (CoolProp::PhaseEnvelopeRoutines::find_intersections(env, iP, p[i]).empty()){
+                CHECK(!inside[i]);
+            }
+            else{
+                CHECK(inside[i] == CoolProp::PhaseEnvelopeRoutines::is_inside(env, iP, p[i], iT, T[i], iclosest, closest_state));
+            }
+        }
+    }
+}
+
+TEST_CASE("Check that the concurrent phase envelopes are the same as serial ones", "[phase_envelope_many]")
+{
+    std::vector<std::string> names(2); names[0] = "Methane"; names[1] = "Ethane";
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(names);
+    std::vector<std::vector<CoolPropDbl> > compositions;
+    for (double z0 = 0.1; z0 < 0.95; z0 += 0.2){
+        std::vector<CoolPropDbl> z(2); z[0] = z0; z[1] = 1-z0;
+        compositions.push_back(z);
+    }
+    std::vector<CoolProp::PhaseEnvelopeData> envelopes = CoolProp::PhaseEnvelopeRoutines::build_many(HEOS, compositions, "", 3);
+    REQUIRE(envelopes.size() == compositions.size());
+    for (std::size_t i = 0; i < compositions.size(); ++i){
+        CAPTURE(compositions[i][0]);
+        HEOS.set_mole_fractions(compositions[i]);
+        HEOS.build_phase_envelope("");
+        const CoolProp::PhaseEnvelopeData &env = HEOS.get_phase_envelope_data();
+        CHECK(envelopes[i].built == env.built);
+        CHECK(envelopes[i].T == env.T);
+        CHECK(envelopes[i].p == env.p);
+        CHECK(envelopes[i].rhomolar_vap == env.rhomolar_vap);
+        CHECK(envelopes[i].x == env.x);
+        CHECK(envelopes[i].p_index.pieces.size() == env.p_index.pieces.size());
+    }
+}
+
+TEST_CASE("Check the composition sweep against single updates", "[composition_sweep]")
+{
+    std::vector<std::string> names(2); names[0] = "Methane"; names[1] = "Ethane";
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(names), HEOS_single(names);
+    std::vector<CoolProp::CompositionSweepPoint> points;
+    for (double z0 = 0.2; z0 < 0.81; z0 += 0.05){
+        CoolProp::CompositionSweepPoint point;
+        point.z.resize(2); point.z[0] = z0; point.z[1] = 1-z0;
+        point.input_pair = CoolProp::PQ_INPUTS; point.value1 = 1e6; point.value2 = 1;
+        points.push_back(point);
+    }
+    std::vector<parameters> outputs(2); outputs[0] = iT; outputs[1] = iDmolar;
+    std::vector<std::vector<double> > serial = HEOS.update_composition_sweep(points, outputs);
+    std::vector<std::vector<double> > parallel = HEOS.update_composition_sweep(points, outputs, 3);
+    REQUIRE(serial.size() == points.size());
+    REQUIRE(parallel.size() == points.size());
+    for (std::size_t i = 0; i < points.size(); ++i){
+        CAPTURE(points[i].z[0]);
+        HEOS_single.set_mole_fractions(points[i].z);
+        HEOS_single.update(points[i].input_pair, points[i].value1, points[i].value2);
+        for (std::size_t j = 0; j < outputs.size(); ++j){
+            double expected = HEOS_single.keyed_output(outputs[j]);
+            CAPTURE(expected);
+            CAPTURE(serial[i][j]);
+            CAPTURE(parallel[i][j]);
+            CHECK(std::abs(serial[i][j]/expected-1) < 1e-6);
+            CHECK(std::abs(parallel[i][j]/expected-1) < 1e-6);
+        }
+    }
+    // The state is left at the last point
+    CHECK(std::abs(HEOS.T()/serial.back()[0]-1) < 1e-12);
+}
+
+TEST_CASE("Check the cached and continued critical points of mixtures", "[critical_points_cache]")
+{
+    std::vector<std::string> names(2); names[0] = "Methane"; names[1] = "Ethane";
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(names);
+    std::vector<std::vector<CoolPropDbl> > compositions;
+    for (double z0 = 0.2; z0 < 0.81; z0 += 0.1){
+        std::vector<CoolPropDbl> z(2); z[0] = z0; z[1] = 1-z0;
+        compositions.push_back(z);
+    }
+    std::vector<std::vector<CoolProp::CriticalState> > locus = HEOS.calc_critical_locus(compositions);
+    REQUIRE(locus.size() == compositions.size());
+    for (std::size_t i = 0; i < compositions.size(); ++i){
+        CAPTURE(compositions[i][0]);
+        CoolProp::HelmholtzEOSMixtureBackend HEOS_cold(names);
+        HEOS_cold.set_mole_fractions(compositions[i]);
+        std::vector<CoolProp::CriticalState> pts = HEOS_cold.all_critical_points();
+        // Continuation follows the stable branch of the locus; the unstable
+        // points found by the full search depend on the composition
+        REQUIRE(!locus[i].empty());
+        for (std::size_t j = 0; j < pts.size(); ++j){
+            if (!pts[j].stable){ continue; }
+            bool found = false;
+            for (std::size_t k = 0; k < locus[i].size(); ++k){
+                if (std::abs(locus[i][k].T/pts[j].T-1) < 1e-8 && std::abs(locus[i][k].p/pts[j].p-1) < 1e-8){ found = true; }
+            }
+            CAPTURE(pts[j].T);
+            CHECK(found);
+        }
+    }
+    SECTION("cache is invalidated when the parameters change"){
+        HEOS.set_mole_fractions(compositions[0]);
+        std::vector<CoolProp::CriticalState> pts1 = HEOS.all_critical_points(), pts2 = HEOS.all_critical_points();
+        REQUIRE(pts1.size() == 1);
+        REQUIRE(pts2.size() == 1);
+        CHECK(pts1[0].T == pts2[0].T);
+        double betaT = HEOS.get_binary_interaction_double(0, 1, "betaT");
+        HEOS.set_binary_interaction_double(0, 1, "betaT", 1.01*betaT);
+        std::vector<CoolProp::CriticalState> pts3 = HEOS.all_critical_points();
+        REQUIRE(pts3.size() == 1);
+        CHECK(std::abs(pts3[0].T/pts1[0].T-1) > 1e-6);
+        HEOS.set_binary_interaction_double(0, 1, "betaT", betaT);
+    }
+}
+
+TEST_CASE("Check that the transport properties do not depend on the history of the state", "[transport_states]")
+{
+    // R12 uses the ECS models for both viscosity and conductivity; the mixture uses the approximate mixing rules
+    std::vector<std::string> fluids; fluids.push_back("R12"); fluids.push_back("R32&R1234yf");
+    for (std::size_t i = 0; i < fluids.size(); ++i){
+        CAPTURE(fluids[i]);
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", fluids[i]));
+        bool mixture = (fluids[i].find("&") != std::string::npos);
+        if (mixture){ AS->set_mole_fractions(std::vector<double>(2, 0.5)); }
+        for (double T = 280; T < 400; T += 15){
+            CAPTURE(T);
+            shared_ptr<CoolProp::AbstractState> AS_fresh(CoolProp::AbstractState::factory("HEOS", fluids[i]));
+            if (mixture){ AS_fresh->set_mole_fractions(std::vector<double>(2, 0.5)); }
+            AS->update(CoolProp::PT_INPUTS, 101325, T);
+            AS_fresh->update(CoolProp::PT_INPUTS, 101325, T);
+            CHECK(std::abs(AS->viscosity()/AS_fresh->viscosity()-1) < 1e-8);
+            CHECK(std::abs(AS->conductivity()/AS_fresh->conductivity()-1) < 1e-8);
+        }
+    }
+}
+
+TEST_CASE("Check that the cached saturated states give the same states as the saturation solvers", "[saturation_cache]")
+{
+    shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", "Water"));
+    double cache_size = CoolProp::get_config_double(SATURATION_CACHE_SIZE);
+    for (double h = 400e3; h < 3.0e6; h += 50e3){
+        CAPTURE(h);
+        std::vector<double> T(2), Q(2), hL(2);
+        for (int i = 0; i < 2; ++i){
+            // Without and with the cache; with it, only the first update at each pressure calls the saturation solver
+            CoolProp::set_config_double(SATURATION_CACHE_SIZE, i*cache_size);
+            AS->update(CoolProp::HmassP_INPUTS, h, 1e6);
+            T[i] = AS->T();
+            Q[i] = AS->Q();
+            hL[i] = (AS->phase() == CoolProp::iphase_twophase) ? AS->saturated_liquid_keyed_output(CoolProp::iHmass) : 0;
+            AS->update(CoolProp::PT_INPUTS, 1e5, 1000);
+            AS->update(CoolProp::DmassT_INPUTS, 10, 400);
+        }
+        CHECK(T[0] == T[1]);
+        CHECK(Q[0] == Q[1]);
+        CHECK(hL[0] == hL[1]);
+    }
+    CoolProp::set_config_double(SATURATION_CACHE_SIZE, cache_size);
+}
+
+TEST_CASE("Check the phase determination of states built without saturated states", "[saturation_cache]")
+{
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(std::vector<std::string>(1, "Water"), false), HEOS_ref(std::vector<std::string>(1, "Water"));
+    double cache_size = CoolProp::get_config_double(SATURATION_CACHE_SIZE);
+    for (int i = 0; i < 2; ++i){
+        CoolProp::set_config_double(SATURATION_CACHE_SIZE, i*cache_size);
+        for (double T = 300; T < 640; T += 20){
+            CAPTURE(T);
+            for (double rhomolar = 1; rhomolar < 60000; rhomolar *= 3){
+                CAPTURE(rhomolar);
+                CHECK_NOTHROW(HEOS.update(CoolProp::DmolarT_INPUTS, rhomolar, T));
+                HEOS_ref.update(CoolProp::DmolarT_INPUTS, rhomolar, T);
+                CHECK(HEOS.phase() == HEOS_ref.phase());
+                CHECK(std::abs(HEOS.p()/HEOS_ref.p()-1) < 1e-10);
+            }
+            for (double p = 1e3; p < 1e8; p *= 4){
+                CAPTURE(p);
+                CHECK_NOTHROW(HEOS.update(CoolProp::PT_INPUTS, p, T));
+                HEOS_ref.update(CoolProp::PT_INPUTS, p, T);
+                CHECK(HEOS.phase() == HEOS_ref.phase());
+                CHECK(std::abs(HEOS.rhomolar()/HEOS_ref.rhomolar()-1) < 1e-10);
+            }
+        }
+    }
+    CoolProp::set_config_double(SATURATION_CACHE_SIZE, cache_size);
+}
+
+TEST_CASE("Check the H,S flash with the guess map against the states it was generated from", "[HS_guess_map]")
+{
+    std::vector<std::string> fluids; fluids.push_back("Water"); fluids.push_back("R134a"); fluids.push_back("Nitrogen");
+    bool use_map = CoolProp::get_config_bool(HS_FLASH_GUESS_MAP);
+    CoolProp::set_config_bool(HS_FLASH_GUESS_MAP, true);
+    for (std::size_t i = 0; i < fluids.size(); ++i){
+        CAPTURE(fluids[i]);
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", fluids[i])), AS_HS(CoolProp::AbstractState::factory("HEOS", fluids[i]));
+        double Tc = AS->T_critical(), pc = AS->p_critical();
+        // Liquid, gas, supercritical and two-phase states
+        std::vector<std::pair<double, double> > pT;
+        pT.push_back(std::make_pair(2*pc, 0.7*Tc)); pT.push_back(std::make_pair(0.01*pc, 0.9*Tc));
+        pT.push_back(std::make_pair(3*pc, 1.5*Tc)); pT.push_back(std::make_pair(0.5*pc, 0.6*Tc));
+        for (std::size_t j = 0; j < pT.size() + 2; ++j){
+            if (j < pT.size()){
+                AS->update(CoolProp::PT_INPUTS, pT[j].first, pT[j].second);
+            }
+            else{
+                AS->update(CoolProp::QT_INPUTS, (j == pT.size()) ? 0.3 : 0.9, 0.8*Tc);
+            }
+            CAPTURE(AS->T());
+            CAPTURE(AS->p());
+            AS_HS->update(CoolProp::HmolarSmolar_INPUTS, AS->hmolar(), AS->smolar());
+            CHECK(AS_HS->phase() == AS->phase());
+            CHECK(std::abs(AS_HS->T()/AS->T()-1) < 1e-8);
+            CHECK(std::abs(AS_HS->rhomolar()/AS->rhomolar()-1) < 1e-6);
+        }
+    }
+    CoolProp::set_config_bool(HS_FLASH_GUESS_MAP, use_map);
+}
+
+TEST_CASE("Check that the grid of the H,S flash guess map finds the closest state", "[HS_guess_map]")
+{
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(std::vector<std::string>(1, "Water"));
+    shared_ptr<const CoolProp::HSFlashGuessMap> map = CoolProp::HSFlashGuessMap::get(HEOS);
+    // The map is built once per fluid
+    CHECK(CoolProp::HSFlashGuessMap::get(HEOS) == map);
+    const double hscale = map->hmolar_scale, sscale = map->smolar_scale;
+    // States inside and outside of the grid
+    for (double hmolar = -80*hscale; hmolar < 80*hscale; hmolar += 3.7*hscale){
+        for (double smolar = -40*sscale; smolar < 40*sscale; smolar += 1.9*sscale){
+            CAPTURE(hmolar); CAPTURE(smolar);
+            double dist_min = _HUGE;
+            for (std::size_t i = 0; i < map->nodes.size(); ++i){
+                dist_min = std::min(dist_min, POW2((map->nodes[i].hmolar - hmolar)/hscale) + POW2((map->nodes[i].smolar - smolar)/sscale));
+            }
+            const CoolProp::HSFlashGuessMap::Node &node = map->singlephase_guess(hmolar, smolar);
+            CHECK(POW2((node.hmolar - hmolar)/hscale) + POW2((node.smolar - smolar)/sscale) == dist_min);
+        }
+    }
+}
+
+TEST_CASE("Check that the continuation mode gives the same states as the normal flash", "[continuation]")
+{
+    std::vector<std::string> names(1, "Water");
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(names), HEOS_cold(names);
+    HEOS.set_continuation_mode(true);
+    std::vector<CoolProp::input_pairs> pairs;
+    pairs.push_back(CoolProp::HmolarP_INPUTS); pairs.push_back(CoolProp::PSmolar_INPUTS); pairs.push_back(CoolProp::DmolarUmolar_INPUTS);
+    for (std::size_t j = 0; j < pairs.size(); ++j){
+        CAPTURE(CoolProp::get_input_pair_short_desc(pairs[j]));
+        HEOS.set_continuation_mode(true);
+        // A path through the liquid, the two-phase region and the vapor at 5 MPa
+        for (double h = 500e3; h < 3.5e6; h += 100e3){
+            CAPTURE(h);
+            HEOS_cold.update(CoolProp::HmassP_INPUTS, h, 5e6);
+            double value1, value2;
+            switch (pairs[j]){
+                case CoolProp::HmolarP_INPUTS: value1 = HEOS_cold.hmolar(); value2 = HEOS_cold.p(); break;
+                case CoolProp::PSmolar_INPUTS: value1 = HEOS_cold.p(); value2 = HEOS_cold.smolar(); break;
+                default: value1 = HEOS_cold.rhomolar(); value2 = HEOS_cold.umolar(); break;
+            }
+            HEOS.update(pairs[j], value1, value2);
+            CHECK(HEOS.phase() == HEOS_cold.phase());
+            CHECK(std::abs(HEOS.T()/HEOS_cold.T()-1) < 1e-8);
+            CHECK(std::abs(HEOS.rhomolar()/HEOS_cold.rhomolar()-1) < 1e-8);
+        }
+        const CoolProp::ContinuationState &continuation = HEOS.get_continuation_state();
+        CHECK(continuation.Ncontinued > continuation.Nfallback);
+    }
+    SECTION("a mixture path through the liquid, the two-phase region and the vapor"){
+        std::vector<std::string> mixture_names; mixture_names.push_back("Methane"); mixture_names.push_back("Ethane");
+        CoolProp::HelmholtzEOSMixtureBackend mix(mixture_names), mix_cold(mixture_names);
+        std::vector<CoolPropDbl> z(2, 0.5);
+        mix.set_mole_fractions(z); mix_cold.set_mole_fractions(z);
+        mix.set_continuation_mode(true);
+        for (double T = 150; T < 320; T += 5){
+            CAPTURE(T);
+            mix.update(CoolProp::PT_INPUTS, 2e6, T);
+            mix_cold.update(CoolProp::PT_INPUTS, 2e6, T);
+            CHECK(mix.phase() == mix_cold.phase());
+            CHECK(std::abs(mix.rhomolar()/mix_cold.rhomolar()-1) < 1e-8);
+        }
+        const CoolProp::ContinuationState &continuation = mix.get_continuation_state();
+        CHECK(continuation.Ncontinued > continuation.Nfallback);
+    }
+    SECTION("the mode can be switched off"){
+        HEOS.set_continuation_mode(false);
+        HEOS.update(CoolProp::PT_INPUTS, 101325, 300);
+        HEOS.update(CoolProp::PT_INPUTS, 101325, 310);
+        CHECK(HEOS.get_continuation_state().Ncontinued == 0);
+    }
+}
+
+TEST_CASE("Check that the clones of a state give the same states, and keep their own parameters", "[clone]")
+{
+    std::vector<std::string> names; names.push_back("Methane"); names.push_back("Ethane");
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(names);
+    std::vector<CoolPropDbl> z(2, 0.5);
+    HEOS.set_mole_fractions(z);
+    double betaT = HEOS.get_binary_interaction_double(0, 1, "betaT");
+    shared_ptr<CoolProp::HelmholtzEOSMixtureBackend> clone(HEOS.clone());
+    // The composition is copied with the model
+    HEOS.update(CoolProp::PT_INPUTS, 5e6, 250);
+    clone->update(CoolProp::PT_INPUTS, 5e6, 250);
+    CHECK(std::abs(clone->rhomolar()/HEOS.rhomolar()-1) < 1e-14);
+    HEOS.update(CoolProp::PQ_INPUTS, 2e6, 0.3);
+    clone->update(CoolProp::PQ_INPUTS, 2e6, 0.3);
+    CHECK(std::abs(clone->T()/HEOS.T()-1) < 1e-12);
+    SECTION("changing the parameters of the clone does not change those of the original"){
+        clone->set_binary_interaction_double(0, 1, "betaT", 1.1*betaT);
+        CHECK(HEOS.get_binary_interaction_double(0, 1, "betaT") == betaT);
+        CHECK(clone->get_binary_interaction_double(0, 1, "betaT") == 1.1*betaT);
+        CHECK(clone->get_SatL().get_binary_interaction_double(0, 1, "betaT") == 1.1*betaT);
+        HEOS.update(CoolProp::PT_INPUTS, 5e6, 250);
+        clone->update(CoolProp::PT_INPUTS, 5e6, 250);
+        CHECK(std::abs(clone->rhomolar()/HEOS.rhomolar()-1) > 1e-6);
+    }
+    SECTION("changing the parameters of the original does not change those of the clone"){
+        HEOS.set_binary_interaction_double(0, 1, "betaT", 1.1*betaT);
+        CHECK(clone->get_binary_interaction_double(0, 1, "betaT") == betaT);
+    }
+}
+
+TEST_CASE("Check that the saturated states are created on first use with the parameters of their parent", "[lazy_children]")
+{
+    SECTION("single-phase updates do not create the saturated states"){
+        std::vector<std::string> names; names.push_back("Methane"); names.push_back("Ethane");
+        CoolProp::HelmholtzEOSMixtureBackend HEOS(names);
+        HEOS.set_mole_fractions(std::vector<CoolPropDbl>(2, 0.5));
+        HEOS.specify_phase(CoolProp::iphase_gas);
+        HEOS.update(CoolProp::PT_INPUTS, 101325, 300);
+        CHECK(HEOS.memory_footprint().child_states == 0);
+    }
+    SECTION("the binary interaction parameters set before first use are used"){
+        std::vector<std::string> names; names.push_back("Methane"); names.push_back("Ethane");
+        CoolProp::HelmholtzEOSMixtureBackend HEOS(names);
+        double betaT = HEOS.get_binary_interaction_double(0, 1, "betaT");
+        HEOS.set_binary_interaction_double(0, 1, "betaT", 1.1*betaT);
+        CHECK(HEOS.get_SatV().get_binary_interaction_double(0, 1, "betaT") == 1.1*betaT);
+    }
+    SECTION("the reference state is changed in the saturated states that have already been created"){
+        std::vector<std::string> names(1, "R134a");
+        CoolProp::HelmholtzEOSMixtureBackend HEOS(names);
+        HEOS.update(CoolProp::QT_INPUTS, 0, 273.15);
+        HEOS.set_reference_stateS("IIR");
+        HEOS.update(CoolProp::QT_INPUTS, 0, 273.15);
+        CHECK(std::abs(HEOS.hmass() - 200000) < 1e-3);
+        CHECK(std::abs(HEOS.get_SatL().hmass() - 200000) < 1e-3);
+        HEOS.set_reference_stateS("DEF");
+    }
+}
+
+TEST_CASE("Check the memory footprint of a state and of the libraries", "[memory_footprint]")
+{
+    std::vector<std::string> names; names.push_back("Methane"); names.push_back("Ethane");
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(names);
+    std::vector<CoolPropDbl> z(2, 0.5);
+    HEOS.set_mole_fractions(z);
+    CoolProp::MemoryFootprint footprint = HEOS.memory_footprint();
+    CHECK(footprint.owned_model > sizeof(CoolProp::HelmholtzEOSMixtureBackend)/2);
+    CHECK(footprint.shared_model > 0);
+    CHECK(footprint.cached_derivatives > 0);
+    SECTION("the reducing function shared with SatL and SatV is only counted once"){
+        CoolProp::MemoryFootprint SatL = HEOS.get_SatL().memory_footprint(), SatV = HEOS.get_SatV().memory_footprint();
+        CHECK(SatL.shared_model == footprint.shared_model);
+        CHECK(HEOS.memory_footprint().child_states == footprint.child_states + SatL.total() + SatV.total() - 2*footprint.shared_model);
+    }
+    SECTION("the phase envelope is counted once it is built"){
+        HEOS.build_phase_envelope("");
+        CHECK(HEOS.memory_footprint().phase_envelope > footprint.phase_envelope + 1000);
+    }
+    SECTION("the fluid library holds the fluids"){
+        CoolProp::LibraryMemoryFootprint library = CoolProp::get_library_memory_footprint();
+        CHECK(library.fluid_library > 1000000);
+        CHECK(library.total() >= library.fluid_library);
+    }
+}
+
+TEST_CASE("Check that the scratch memory of the VLE routines is reused without changing the states", "[VLE_workspace]")
+{
+    std::vector<std::string> names; names.push_back("Methane"); names.push_back("Ethane");
+    CoolProp::HelmholtzEOSMixtureBackend HEOS(names);
+    std::vector<CoolPropDbl> z(2, 0.5);
+    HEOS.set_mole_fractions(z);
+    shared_ptr<CoolProp::HelmholtzEOSMixtureBackend> fresh(HEOS.clone());
+    // Each state has its own workspace
+    CHECK(&HEOS.get_VLE_workspace() != &fresh->get_VLE_workspace());
+    HEOS.update(CoolProp::QT_INPUTS, 0, 200);
+    double p_bubble = HEOS.p();
+    CHECK(HEOS.get_VLE_workspace().saturation.J.rows() == 2);
+    // Other flashes use the same workspace in between, which does not grow once all of them have been used
+    std::size_t owned_model = 0;
+    for (int i = 0; i < 2; ++i){
+        HEOS.update(CoolProp::PQ_INPUTS, 2e6, 1);
+        HEOS.update(CoolProp::PT_INPUTS, 2e6, 220);
+        HEOS.update(CoolProp::QT_INPUTS, 0, 200);
+        CHECK(HEOS.p() == p_bubble);
+        if (i == 0){ owned_model = HEOS.memory_footprint().owned_model; }
+    }
+    CHECK(HEOS.memory_footprint().owned_model == owned_model);
+    fresh->update(CoolProp::PT_INPUTS, 2e6, 220);
+    HEOS.update(CoolProp::PT_INPUTS, 2e6, 220);
+    CHECK(std::abs(HEOS.Q()/fresh->Q()-1) < 1e-12);
+    CHECK(std::abs(HEOS.rhomolar()/fresh->rhomolar()-1) < 1e-12);
+}
+
 /*
 TEST_CASE("Test that HS solver works for a few fluids", "[HS_solver]")
 {